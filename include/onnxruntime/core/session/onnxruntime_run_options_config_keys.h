@@ -49,3 +49,9 @@ static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_con
 // If the value is set to -1, cuda graph capture/replay is disabled in that run.
 // User are not expected to set the value to 0 as it is reserved for internal use.
 static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id";
+
+// Set to '1' to only execute the nodes on a path to the outputs requested in this run.
+// It is the same as setting OrtRunOptions.only_execute_path_to_fetches, for users of the C API.
+// The nodes to execute are computed once per set of requested outputs and cached in the session.
+// Per default it will be set to '0'
+static const char* const kOrtRunOptionsConfigOnlyExecutePathToFetches = "run.only_execute_path_to_fetches";
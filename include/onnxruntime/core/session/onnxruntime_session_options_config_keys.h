@@ -270,3 +270,107 @@ static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
+
+// Minimum fraction of all-zero blocks for which a constant fp32 MatMul weight is pre-packed into a block sparse
+// format and multiplied with the MLAS block sparse GEMM instead of the dense SGEMM.
+// Option values:
+// - "0": Block sparse GEMM is not used. [DEFAULT]
+// - a value in (0, 1], e.g. "0.7": weights with at least this fraction of zero blocks use block sparse GEMM.
+static const char* const kOrtSessionOptionsMlasBlockSparseGemmMinSparsity = "mlas.block_sparse_gemm_min_sparsity";
+
+// Enable the TunableOp of the CPU EP. The CPU EP has no provider options, so it is configured via the session.
+// When enabled, kernels like the fp32 MatMul use the fastest of their candidate implementations recorded in the
+// TuningResults, see InferenceSession::GetTuningResults and InferenceSession::SetTuningResults.
+// Option values:
+// - "0": TunableOp is disabled. [DEFAULT]
+// - "1": TunableOp is enabled.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Enable tuning of the CPU EP TunableOp. Candidates are timed for every new (op, shape) seen and the winner is added
+// to the TuningResults. Only effective if kOrtSessionOptionsCpuTunableOpEnable is enabled.
+// Option values:
+// - "0": Tuning is disabled, only previously loaded TuningResults are used. [DEFAULT]
+// - "1": Tuning is enabled.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// Maximum time in milliseconds spent on tuning a single (op, shape) of the CPU EP. "0" means no limit. [DEFAULT]
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Enable the fp32 NHWC layout on the CPU EP. With level 3 optimizations, fp32 Conv, FusedConv and the pooling ops
+// are converted to their channels last kernels, and the transposes between them are pushed and cancelled so that
+// chains of convolutions run in NHWC. When enabled, this takes precedence over the NCHWc layout for these ops.
+// Option values:
+// - "0": fp32 NHWC layout is disabled. [DEFAULT]
+// - "1": fp32 NHWC layout is enabled.
+static const char* const kOrtSessionOptionsEnableFp32NhwcLayout = "optimization.enable_fp32_nhwc";
+
+// Quantize the 2D fp32 (and, on EPs with an fp16 kernel, fp16) constant weights of MatMul nodes to 4 bits at load
+// time, replacing the MatMul nodes with MatMulNBits. This trades accuracy for less weight memory and bandwidth without
+// an offline quantized copy of the model.
+// Option values:
+// - "0": MatMul weights are not quantized. [DEFAULT]
+// - "16", "32", "64", "128" or "256": the number of elements along K that share a quantization scale.
+static const char* const kOrtSessionOptionsMatMulNBitsQuantizationBlockSize =
+    "optimization.matmul_nbits_quantization_block_size";
+
+// Whether the load time MatMul weight quantization is symmetric. Only used if the block size above is set.
+// Option values:
+// - "0": Asymmetric quantization, with zero points. [DEFAULT]
+// - "1": Symmetric quantization, without zero points.
+static const char* const kOrtSessionOptionsMatMulNBitsQuantizationSymmetric =
+    "optimization.matmul_nbits_quantization_symmetric";
+
+// The accuracy_level attribute of the MatMulNBits nodes created by the load time MatMul weight quantization, the
+// minimum precision of the input A used for computation. See the MatMulNBits operator for the values.
+// Option values:
+// - "0": Unset, the kernel chooses. [DEFAULT]
+// - "1" to "4": fp32, fp16, bf16 or int8 input A.
+static const char* const kOrtSessionOptionsMatMulNBitsQuantizationAccuracyLevel =
+    "optimization.matmul_nbits_quantization_accuracy_level";
+
+// Path to a file with measured kernel and copy costs per execution provider, used during graph partitioning to leave
+// nodes on the CPU EP when another EP would not run them faster once the copies to and from it are included.
+// Each line of the file is either "<EP type> <op type> <microseconds per run>" or
+// "<EP type> copy <microseconds per tensor> <microseconds per MB>". Nodes without costs for both EPs are assigned as
+// usual.
+// Option values:
+// - "": the cost model is not used. [DEFAULT]
+// - path to the cost model file.
+static const char* const kOrtSessionOptionsPartitioningCostModelFile = "session.partitioning_cost_model_file";
+
+// Converts regions of fp32 nodes assigned to the CPU EP to fp16 when the CPU has native fp16 arithmetic and the CPU EP
+// has fp16 kernels for all nodes of the region, halving the size of the activations. Only Conv, Gemm (without
+// transposes, with alpha and beta of 1 and a bias), pooling and Relu/LeakyRelu nodes are converted; MatMul has no fp16
+// CPU kernel, and numerically sensitive ops such as Softmax, normalizations and reductions stay in fp32. Casts are only
+// inserted at the boundaries of the regions.
+// Option values:
+// - "0": mixed precision is disabled. [DEFAULT]
+// - "1": mixed precision is enabled.
+static const char* const kOrtSessionOptionsEnableCpuFp16MixedPrecision =
+    "optimization.enable_cpu_fp16_mixed_precision";
+
+// Semicolon separated list of op types that the CPU fp16 mixed precision conversion above must keep in fp32,
+// e.g. "Gemm;MaxPool". Only used if the conversion is enabled.
+// Option values:
+// - "": no op types are excluded. [DEFAULT]
+// - list of op types.
+static const char* const kOrtSessionOptionsCpuFp16MixedPrecisionExcludedOpTypes =
+    "optimization.cpu_fp16_mixed_precision_excluded_op_types";
+
+// Fuses the causal self attention of LLaMA style decoders exported from PyTorch into GroupQueryAttention on the CPU EP.
+// GroupQueryAttention assumes the sequences of a batch are right padded (or not padded) and that inputs with more
+// than one token are prompts without past, which the graph does not tell, so the fusion is only applied on request.
+// Option values:
+// - "0": the fusion is disabled. [DEFAULT]
+// - "1": the fusion is enabled.
+static const char* const kOrtSessionOptionsEnableGroupQueryAttentionFusion =
+    "optimization.enable_group_query_attention_fusion";
+
+// Fuses chains of fp32 elementwise ops (Add, Sub, Mul, Div, Max, Min and unary activations) on the CPU EP into
+// FusedElementwise nodes that run the chain tile by tile. The fused kernel evaluates Exp, Tanh, Erf and the other
+// activations with the MLAS approximations, so its results can differ in the last bits from the unfused kernels.
+// Option values:
+// - "0": the fusion is disabled. [DEFAULT]
+// - "1": the fusion is enabled.
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
@@ -51,6 +51,7 @@ class GQAAttentionBase {
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
                         GroupQueryAttentionParameters& parameters,  // attention parameters
+                        bool kv_cache_filled,                       // whether present KV already holds the new K and V
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
     const int batch_size = parameters.batch_size;
@@ -82,14 +83,14 @@ class GQAAttentionBase {
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
                              sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
-                             present_key_data, past_present_share_buffer, packed_qkv, tp);
+                             present_key_data, past_present_share_buffer, packed_qkv, kv_cache_filled, tp);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
     const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(attention_probs), v, seqlens_k->Data<int32_t>(),
                             batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
                             hidden_size, past_value_data, present_value_data, past_present_share_buffer, packed_qkv,
-                            tp);
+                            kv_cache_filled, tp);
 
     return Status::OK();
   }
@@ -112,6 +113,7 @@ class GQAAttentionBase {
                              T* present_key,                      // present key only
                              bool past_present_share_buffer,      // whether present key and value share the same buffer
                              bool packed_qkv,                     // whether Q, K, V are packed
+                             bool kv_cache_filled,                // whether present key already holds the new keys
                              ThreadPool* tp) const {              // thread pool
     const bool is_prompt = sequence_length != 1;
     const ptrdiff_t packed_batch_stride =
@@ -123,7 +125,7 @@ class GQAAttentionBase {
     const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && !kv_cache_filled) {
       memset(present_key, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
     }
 
@@ -142,7 +144,7 @@ class GQAAttentionBase {
     unit_cost.bytes_loaded += static_cast<double>(probs_matrix_bytes);
     unit_cost.bytes_stored += static_cast<double>(probs_matrix_bytes);
 
-    if (present_key) {
+    if (present_key && !kv_cache_filled) {
       double bytes_to_copy_key = static_cast<double>(sizeof(T) * present_buff_chunk_length);
       unit_cost.bytes_loaded += bytes_to_copy_key;
       unit_cost.bytes_stored += bytes_to_copy_key;
@@ -161,12 +163,14 @@ class GQAAttentionBase {
         T* output = attention_probs + output_offset;
 
         const T* k;
-        if (packed_qkv) {
+        if (kv_cache_filled) {
+          k = present_key + present_buff_chunk_length * (i / kv_num_heads_factor);
+        } else if (packed_qkv) {
           k = K + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
         } else {
           k = K + kv_input_chunk_length * (i / kv_num_heads_factor);
         }
-        if (nullptr != present_key) {
+        if (nullptr != present_key && !kv_cache_filled) {
           k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
                                   past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
                                   i / kv_num_heads_factor);
@@ -227,6 +231,7 @@ class GQAAttentionBase {
                                T* present_value,                    // present value only
                                bool past_present_share_buffer,      // whether present key and value share the same buffer
                                bool packed_qkv,                     // whether Q, K, V are packed
+                               bool kv_cache_filled,                // whether present value already holds the new values
                                ThreadPool* tp) const {
     const bool is_prompt = sequence_length != 1;
     const ptrdiff_t packed_batch_stride =
@@ -237,7 +242,7 @@ class GQAAttentionBase {
     const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && !kv_cache_filled) {
       memset(present_value, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
     }
 
@@ -249,7 +254,7 @@ class GQAAttentionBase {
                                                  present_buffer_sequence_length * sizeof(T));
     unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
 
-    if (present_value) {
+    if (present_value && !kv_cache_filled) {
       double bytes_to_copy_value = static_cast<double>(present_buff_chunk_length * sizeof(T));
       unit_cost.bytes_loaded += bytes_to_copy_value;
       unit_cost.bytes_stored += bytes_to_copy_value;
@@ -271,12 +276,14 @@ class GQAAttentionBase {
             const int total_seqlen = seqlens_k[batch_index] + 1;
 
             const T* v;
-            if (packed_qkv) {
+            if (kv_cache_filled) {
+              v = present_value + present_buff_chunk_length * (i / kv_num_heads_factor);
+            } else if (packed_qkv) {
               v = V + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
             } else {
               v = V + kv_input_chunk_length * (i / kv_num_heads_factor);
             }
-            if (nullptr != present_value) {
+            if (nullptr != present_value && !kv_cache_filled) {
               v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
                                       past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
                                       i / kv_num_heads_factor);
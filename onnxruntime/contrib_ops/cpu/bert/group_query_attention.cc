@@ -86,7 +86,10 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
-  auto element_type = DataTypeImpl::GetType<T>();
+  // With a present KV cache, the new key and value rows are rotated and appended to the cache in a single pass
+  // straight from the input, so K and V are not transposed to BNSH.
+  const bool fuse_kv_cache = present_k != nullptr && present_v != nullptr;
+
   OrtValue Q;
   OrtValue K;
   OrtValue V;
@@ -96,12 +99,17 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   } else {
     ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
         allocator, batch_size, num_heads_, sequence_length, head_size, query, Q));
-    ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
-        allocator, batch_size, kv_num_heads_, sequence_length, head_size, key, K));
-    ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
-        allocator, batch_size, kv_num_heads_, sequence_length, head_size, value, V));
+    if (!fuse_kv_cache) {
+      ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
+          allocator, batch_size, kv_num_heads_, sequence_length, head_size, key, K));
+      ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
+          allocator, batch_size, kv_num_heads_, sequence_length, head_size, value, V));
+    }
   }
 
+  auto* tp = context->GetOperatorThreadPool();
+  const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+
   if (do_rotary_) {
     rotary_embedding_helper::RotaryParameters rotary_params = {};
     rotary_params.batch_size = batch_size;
@@ -116,70 +124,73 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
     rotary_params.batch_stride = (packed_qkv ? (num_heads_ + 2 * kv_num_heads_) : num_heads_) * rotary_params.head_stride;
     rotary_params.position_ids_format = sequence_length == 1 ? 1 : 0;
     rotary_params.transposed = true;
-    auto* tp = context->GetOperatorThreadPool();
     std::vector<int64_t> pos_ids(sequence_length == 1 ? batch_size : 1);
     if (sequence_length == 1) {
       for (int b = 0; b < batch_size; b++) {
-        pos_ids[b] = static_cast<int64_t>(seqlens_k->Data<int32_t>()[b]);
+        pos_ids[b] = static_cast<int64_t>(seqlens_k_data[b]);
       }
     } else {
       pos_ids[0] = static_cast<int64_t>(0);
     }
-    const T* q_input;
-    const T* k_input;
-    T* q_rotary;
-    T* k_rotary;
-    if (packed_qkv) {
-      OrtValue RotaryQKV;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size}), allocator, RotaryQKV);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = q_input + num_heads_ * sequence_length * head_size;
-      q_rotary = RotaryQKV.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = q_rotary + num_heads_ * sequence_length * head_size;
-      Q = RotaryQKV;
-    } else {
-      OrtValue RotaryQ;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_, sequence_length, head_size}), allocator, RotaryQ);
-      OrtValue RotaryK;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, kv_num_heads_, sequence_length, head_size}), allocator, RotaryK);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = K.Get<Tensor>().Data<T>();
-      q_rotary = RotaryQ.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = RotaryK.GetMutable<Tensor>()->MutableData<T>();
-      Q = RotaryQ;
-      K = RotaryK;
-    }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, q_input,
+
+    // Q (and K when it is not fused into the KV cache append) is a transposed copy of the input, so the rotary
+    // embedding is applied in place.
+    T* q_rotary = Q.GetMutable<Tensor>()->MutableData<T>();
+    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, q_rotary,
                                               pos_ids.data(), cos_cache->Data<T>(),
                                               sin_cache->Data<T>(), q_rotary, rotary_interleaved_));
 
-    rotary_params.num_heads = kv_num_heads_;
-    rotary_params.hidden_size = parameters.kv_hidden_size;
-    if (!packed_qkv) {
-      rotary_params.batch_stride = kv_num_heads_ * rotary_params.head_stride;
+    if (!fuse_kv_cache) {
+      rotary_params.num_heads = kv_num_heads_;
+      rotary_params.hidden_size = parameters.kv_hidden_size;
+      T* k_rotary;
+      if (packed_qkv) {
+        k_rotary = q_rotary + num_heads_ * sequence_length * head_size;
+      } else {
+        rotary_params.batch_stride = kv_num_heads_ * rotary_params.head_stride;
+        k_rotary = K.GetMutable<Tensor>()->MutableData<T>();
+      }
+      ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, k_rotary,
+                                                pos_ids.data(), cos_cache->Data<T>(),
+                                                sin_cache->Data<T>(), k_rotary, rotary_interleaved_));
     }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, k_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), k_rotary, rotary_interleaved_));
+  }
+
+  if (fuse_kv_cache) {
+    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
+    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
+    T* present_key_data = present_k->MutableData<T>();
+    T* present_value_data = present_v->MutableData<T>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+    const int past_kv_seqlen = past_key != nullptr ? static_cast<int>(past_key->Shape().GetDims()[2]) : 0;
+
+    // K and V are read in their BSNH input layout, either from the packed QKV or the separate inputs.
+    const T* key_data;
+    const T* value_data;
+    ptrdiff_t seq_stride;
     if (packed_qkv) {
-      const T* v_input = k_input + kv_num_heads_ * sequence_length * head_size;
-      T* v_rotary = k_rotary + kv_num_heads_ * sequence_length * head_size;
-      ORT_RETURN_IF_ERROR(rotary_helper::PackVIntoRotaryQKV<T>(tp,
-                                                               parameters.batch_size,
-                                                               parameters.sequence_length,
-                                                               parameters.num_heads,
-                                                               parameters.kv_num_heads,
-                                                               parameters.head_size,
-                                                               v_input,
-                                                               v_rotary));
+      key_data = query->Data<T>() + num_heads_ * head_size;
+      value_data = key_data + kv_num_heads_ * head_size;
+      seq_stride = static_cast<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * head_size;
+    } else {
+      key_data = key->Data<T>();
+      value_data = value->Data<T>();
+      seq_stride = static_cast<ptrdiff_t>(kv_num_heads_) * head_size;
     }
+
+    ORT_RETURN_IF_ERROR(rotary_helper::RotaryAppendKVToPresent<T>(
+        tp, batch_size, sequence_length, kv_num_heads_, head_size, key_data, value_data,
+        seq_stride * sequence_length, seq_stride, head_size, past_key_data, past_value_data, present_key_data,
+        present_value_data, past_kv_seqlen, present_kv_seqlen, seqlens_k_data, past_present_share_buffer,
+        do_rotary_ ? cos_cache->Data<T>() : nullptr, do_rotary_ ? sin_cache->Data<T>() : nullptr,
+        parameters.rotary_dim, rotary_interleaved_));
   }
 
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
   // Compute the attention score and apply the score to V
-  return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
-                        packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+  const T* k_data = (packed_qkv || fuse_kv_cache) ? nullptr : K.Get<Tensor>().Data<T>();
+  const T* v_data = (packed_qkv || fuse_kv_cache) ? nullptr : V.Get<Tensor>().Data<T>();
+  return ApplyAttention(Q.Get<Tensor>().Data<T>(), k_data, v_data, past_key, past_value, output, present_k, present_v,
+                        seqlens_k, parameters, fuse_kv_cache, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -4,8 +4,10 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/safeint.h"
 #include "core/providers/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -42,6 +44,93 @@ Status PackVIntoRotaryQKV(concurrency::ThreadPool* tp,
   return Status::OK();
 }
 
+// Rotates the new key rows and appends them, together with the new value rows, to the present KV cache (BNSH)
+// in one pass. K and V are read with the given strides so that the BSNH input or packed QKV can be used without
+// a transpose. When cos_cache is nullptr, the keys are copied without rotary embedding.
+template <typename T>
+Status RotaryAppendKVToPresent(concurrency::ThreadPool* tp,
+                               int batch_size,
+                               int sequence_length,
+                               int kv_num_heads,
+                               int head_size,
+                               const T* key,
+                               const T* value,
+                               ptrdiff_t batch_stride,
+                               ptrdiff_t seq_stride,
+                               ptrdiff_t head_stride,
+                               const T* past_key,
+                               const T* past_value,
+                               T* present_key,
+                               T* present_value,
+                               int past_buffer_sequence_length,
+                               int present_buffer_sequence_length,
+                               const int32_t* seqlens_k,
+                               bool past_present_share_buffer,
+                               const T* cos_cache,
+                               const T* sin_cache,
+                               int rotary_dim,
+                               bool interleaved) {
+  const bool is_prompt = sequence_length != 1;
+  const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;
+  const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;
+  const size_t row_bytes = static_cast<size_t>(head_size) * sizeof(T);
+  const int half_rotary_dim = rotary_dim / 2;
+
+  TensorOpCost unit_cost;
+  unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(T));
+  unit_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_length * sizeof(T));
+  unit_cost.compute_cycles = static_cast<double>(SafeInt<ptrdiff_t>(3) * sequence_length * rotary_dim);
+
+  ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads, unit_cost,
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int b = static_cast<int>(i / kv_num_heads);
+      const int n = static_cast<int>(i % kv_num_heads);
+      const int past_seqlen = is_prompt ? 0 : static_cast<int>(seqlens_k[b]);
+      const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+
+      T* k_dst = present_key + i * present_buff_chunk_length;
+      T* v_dst = present_value + i * present_buff_chunk_length;
+
+      if (!past_present_share_buffer) {
+        if (past_chunk_length > 0) {
+          memcpy(k_dst, past_key + i * past_buff_chunk_length, past_chunk_length * sizeof(T));
+          memcpy(v_dst, past_value + i * past_buff_chunk_length, past_chunk_length * sizeof(T));
+        }
+        const size_t used_length = past_chunk_length + static_cast<size_t>(sequence_length) * head_size;
+        if (used_length < present_buff_chunk_length) {
+          memset(k_dst + used_length, 0, (present_buff_chunk_length - used_length) * sizeof(T));
+          memset(v_dst + used_length, 0, (present_buff_chunk_length - used_length) * sizeof(T));
+        }
+      }
+      k_dst += past_chunk_length;
+      v_dst += past_chunk_length;
+
+      const T* k_src = key + b * batch_stride + n * head_stride;
+      const T* v_src = value + b * batch_stride + n * head_stride;
+      for (int s = 0; s < sequence_length; s++) {
+        if (cos_cache != nullptr) {
+          const ptrdiff_t cache_offset = static_cast<ptrdiff_t>(past_seqlen + s) * half_rotary_dim;
+          MlasRotaryEmbedOneRow<T>(k_src, sin_cache + cache_offset, cos_cache + cache_offset, rotary_dim,
+                                   interleaved, k_dst);
+          if (rotary_dim < head_size) {
+            memcpy(k_dst + rotary_dim, k_src + rotary_dim, (head_size - rotary_dim) * sizeof(T));
+          }
+        } else {
+          memcpy(k_dst, k_src, row_bytes);
+        }
+        memcpy(v_dst, v_src, row_bytes);
+
+        k_src += seq_stride;
+        v_src += seq_stride;
+        k_dst += head_size;
+        v_dst += head_size;
+      }
+    }
+  });
+  return Status::OK();
+}
+
 }  // namespace rotary_helper
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,377 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+using OpCode = FusedElementwise::OpCode;
+
+// Number of elements evaluated per tile. The scratch values that are live within a tile fit in the L1 cache.
+constexpr size_t kTileSize = 1024;
+
+constexpr std::pair<const char*, OpCode> kOpCodes[] = {
+    {"Add", OpCode::Add},
+    {"Sub", OpCode::Sub},
+    {"Mul", OpCode::Mul},
+    {"Div", OpCode::Div},
+    {"Max", OpCode::Max},
+    {"Min", OpCode::Min},
+    {"Abs", OpCode::Abs},
+    {"Erf", OpCode::Erf},
+    {"Exp", OpCode::Exp},
+    {"Neg", OpCode::Neg},
+    {"Reciprocal", OpCode::Reciprocal},
+    {"Relu", OpCode::Relu},
+    {"Sigmoid", OpCode::Sigmoid},
+    {"Sqrt", OpCode::Sqrt},
+    {"Tanh", OpCode::Tanh},
+};
+
+bool IsUnary(OpCode op) {
+  return op >= OpCode::Abs;
+}
+
+float ApplyScalar(OpCode op, float a, float b) {
+  switch (op) {
+    case OpCode::Add:
+      return a + b;
+    case OpCode::Sub:
+      return a - b;
+    case OpCode::Mul:
+      return a * b;
+    case OpCode::Div:
+      return a / b;
+    case OpCode::Max:
+      return std::max(a, b);
+    case OpCode::Min:
+      return std::min(a, b);
+    case OpCode::Abs:
+      return std::abs(a);
+    case OpCode::Erf:
+      return std::erf(a);
+    case OpCode::Exp:
+      return std::exp(a);
+    case OpCode::Neg:
+      return -a;
+    case OpCode::Reciprocal:
+      return 1.0f / a;
+    case OpCode::Relu:
+      return std::max(a, 0.0f);
+    case OpCode::Sigmoid:
+      return 1.0f / (1.0f + std::exp(-a));
+    case OpCode::Sqrt:
+      return std::sqrt(a);
+    case OpCode::Tanh:
+      return std::tanh(a);
+  }
+  return 0.0f;
+}
+
+// Applies op to a tile of n elements. At most one operand of a binary operator is a broadcast scalar, and the
+// operand of a unary operator is never a scalar. y may alias an operand that is not a scalar.
+void ApplyTile(OpCode op, const float* a, bool a_scalar, const float* b, bool b_scalar, float* y, size_t n) {
+  const auto count = static_cast<Eigen::Index>(n);
+  switch (op) {
+    case OpCode::Add:
+      MlasEltwiseF32(MlasEltwiseAdd, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Sub:
+      MlasEltwiseF32(MlasEltwiseSub, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Mul:
+      MlasEltwiseF32(MlasEltwiseMul, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Div:
+      MlasEltwiseF32(MlasEltwiseDiv, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Max:
+      MlasEltwiseF32(MlasEltwiseMaximum, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Min:
+      MlasEltwiseF32(MlasEltwiseMinimum, a, a_scalar, b, b_scalar, y, n);
+      break;
+    case OpCode::Abs:
+      EigenVectorArrayMap<float>(y, count) = ConstEigenVectorArrayMap<float>(a, count).abs();
+      break;
+    case OpCode::Erf:
+      MlasComputeErf(a, y, n);
+      break;
+    case OpCode::Exp:
+      MlasComputeExp(a, y, n);
+      break;
+    case OpCode::Neg:
+      EigenVectorArrayMap<float>(y, count) = -ConstEigenVectorArrayMap<float>(a, count);
+      break;
+    case OpCode::Reciprocal:
+      EigenVectorArrayMap<float>(y, count) = ConstEigenVectorArrayMap<float>(a, count).inverse();
+      break;
+    case OpCode::Relu:
+      EigenVectorArrayMap<float>(y, count) = ConstEigenVectorArrayMap<float>(a, count).cwiseMax(0.0f);
+      break;
+    case OpCode::Sigmoid:
+      MlasComputeLogistic(a, y, n);
+      break;
+    case OpCode::Sqrt:
+      EigenVectorArrayMap<float>(y, count) = ConstEigenVectorArrayMap<float>(a, count).sqrt();
+      break;
+    case OpCode::Tanh:
+      MlasComputeTanh(a, y, n);
+      break;
+  }
+}
+
+enum class InputKind {
+  Full,    // same number of elements as the output
+  Scalar,  // a single element
+  Suffix,  // matches the trailing dimensions of the output and repeats over the leading ones
+};
+
+struct InputInfo {
+  const float* data;
+  InputKind kind;
+  size_t size;
+  int slot;  // scratch slot a Suffix input is gathered into
+};
+
+// A value of the program within the current tile.
+struct TileValue {
+  const float* data;
+  bool scalar;
+};
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  const auto results = info.GetAttrsOrDefault<int64_t>("results");
+
+  num_inputs_ = static_cast<int>(info.GetInputCount());
+  const int num_outputs = static_cast<int>(info.GetOutputCount());
+  const int num_values = num_inputs_ + static_cast<int>(ops.size());
+
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one instruction.");
+  ORT_ENFORCE(operands.size() == 2 * ops.size(), "FusedElementwise requires two operands per instruction.");
+  ORT_ENFORCE(results.size() == static_cast<size_t>(num_outputs), "FusedElementwise requires one result per output.");
+
+  program_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const auto* entry = std::find_if(std::begin(kOpCodes), std::end(kOpCodes),
+                                     [&](const auto& op_code) { return ops[i] == op_code.first; });
+    ORT_ENFORCE(entry != std::end(kOpCodes), "FusedElementwise does not support operator ", ops[i]);
+
+    Instruction instruction{entry->second, static_cast<int>(operands[2 * i]), static_cast<int>(operands[2 * i + 1]),
+                            -1};
+    const int result = num_inputs_ + static_cast<int>(i);
+    ORT_ENFORCE(instruction.operand0 >= 0 && instruction.operand0 < result,
+                "FusedElementwise instruction ", i, " has an invalid operand.");
+    if (IsUnary(instruction.op)) {
+      ORT_ENFORCE(instruction.operand1 == -1, "FusedElementwise unary instruction ", i, " has a second operand.");
+    } else {
+      ORT_ENFORCE(instruction.operand1 >= 0 && instruction.operand1 < result,
+                  "FusedElementwise instruction ", i, " has an invalid operand.");
+    }
+    program_.push_back(instruction);
+  }
+
+  output_of_instruction_.assign(ops.size(), -1);
+  for (int j = 0; j < num_outputs; ++j) {
+    const int instruction = static_cast<int>(results[j]) - num_inputs_;
+    ORT_ENFORCE(instruction >= 0 && instruction < static_cast<int>(ops.size()) &&
+                    output_of_instruction_[instruction] == -1,
+                "FusedElementwise output ", j, " has an invalid result.");
+    output_of_instruction_[instruction] = j;
+  }
+
+  // Assign scratch slots to the values that are not outputs, reusing a slot once its value is no longer read.
+  InlinedVector<int> last_use(num_values, -1);
+  for (int i = 0; i < static_cast<int>(program_.size()); ++i) {
+    last_use[program_[i].operand0] = i;
+    if (program_[i].operand1 >= 0) {
+      last_use[program_[i].operand1] = i;
+    }
+  }
+
+  InlinedVector<int> free_slots;
+  num_slots_ = 0;
+  auto release = [&](int value) {
+    if (value >= num_inputs_) {
+      const int slot = program_[value - num_inputs_].slot;
+      if (slot >= 0) {
+        free_slots.push_back(slot);
+      }
+    }
+  };
+  for (int i = 0; i < static_cast<int>(program_.size()); ++i) {
+    Instruction& instruction = program_[i];
+    if (last_use[instruction.operand0] == i) {
+      release(instruction.operand0);
+    }
+    if (instruction.operand1 >= 0 && instruction.operand1 != instruction.operand0 &&
+        last_use[instruction.operand1] == i) {
+      release(instruction.operand1);
+    }
+    if (output_of_instruction_[i] == -1) {
+      if (!free_slots.empty()) {
+        instruction.slot = free_slots.back();
+        free_slots.pop_back();
+      } else {
+        instruction.slot = num_slots_++;
+      }
+      if (last_use[num_inputs_ + i] == -1) {
+        free_slots.push_back(instruction.slot);
+      }
+    }
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  // Compute the multidirectional broadcast of the input shapes.
+  size_t rank = 0;
+  for (int i = 0; i < num_inputs_; ++i) {
+    rank = std::max(rank, context->Input<Tensor>(i)->Shape().NumDimensions());
+  }
+  TensorShapeVector output_dims(rank, 1);
+  for (int i = 0; i < num_inputs_; ++i) {
+    const auto dims = context->Input<Tensor>(i)->Shape().GetDims();
+    const size_t offset = rank - dims.size();
+    for (size_t k = 0; k < dims.size(); ++k) {
+      int64_t& output_dim = output_dims[offset + k];
+      if (output_dim == 1) {
+        output_dim = dims[k];
+      } else if (dims[k] != 1 && dims[k] != output_dim) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise input ", i, " with shape ",
+                               context->Input<Tensor>(i)->Shape(), " cannot be broadcast.");
+      }
+    }
+  }
+  const TensorShape output_shape(output_dims);
+  const size_t total = static_cast<size_t>(output_shape.Size());
+
+  InlinedVector<float*> outputs;
+  for (int j = 0; j < context->OutputCount(); ++j) {
+    outputs.push_back(context->Output(j, output_shape)->MutableData<float>());
+  }
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  int num_slots = num_slots_;
+  InlinedVector<InputInfo> inputs;
+  for (int i = 0; i < num_inputs_; ++i) {
+    const Tensor& input = *context->Input<Tensor>(i);
+    const size_t size = static_cast<size_t>(input.Shape().Size());
+    InputInfo info{input.Data<float>(), InputKind::Full, size, -1};
+    if (size == total) {
+      info.kind = InputKind::Full;
+    } else if (size == 1) {
+      info.kind = InputKind::Scalar;
+    } else {
+      // The input must be the trailing block of the output once its leading dimensions of 1 are dropped.
+      const auto dims = input.Shape().GetDims();
+      size_t first = 0;
+      while (first < dims.size() && dims[first] == 1) {
+        ++first;
+      }
+      if (!std::equal(dims.begin() + first, dims.end(), output_dims.end() - (dims.size() - first))) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise input ", i, " with shape ",
+                               input.Shape(), " must match the trailing dimensions of the output shape ",
+                               output_shape);
+      }
+      info.kind = InputKind::Suffix;
+      info.slot = num_slots++;
+    }
+    inputs.push_back(info);
+  }
+
+  const size_t num_tiles = (total + kTileSize - 1) / kTileSize;
+  const double tile_bytes = static_cast<double>(kTileSize * sizeof(float));
+  const TensorOpCost cost{static_cast<double>(num_inputs_) * tile_bytes,
+                          static_cast<double>(outputs.size()) * tile_bytes,
+                          static_cast<double>(program_.size() * kTileSize) * 2.0};
+
+  ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_tiles), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        auto scratch = std::make_unique<float[]>(static_cast<size_t>(num_slots) * kTileSize);
+        InlinedVector<float> scalars(program_.size());
+        InlinedVector<TileValue> values(num_inputs_ + program_.size());
+
+        for (std::ptrdiff_t tile = first; tile < last; ++tile) {
+          const size_t start = static_cast<size_t>(tile) * kTileSize;
+          const size_t n = std::min(kTileSize, total - start);
+
+          for (int i = 0; i < num_inputs_; ++i) {
+            const InputInfo& input = inputs[i];
+            switch (input.kind) {
+              case InputKind::Full:
+                values[i] = {input.data + start, false};
+                break;
+              case InputKind::Scalar:
+                values[i] = {input.data, true};
+                break;
+              case InputKind::Suffix: {
+                float* gathered = scratch.get() + input.slot * kTileSize;
+                size_t offset = start % input.size;
+                for (size_t copied = 0; copied < n;) {
+                  const size_t count = std::min(input.size - offset, n - copied);
+                  std::copy_n(input.data + offset, count, gathered + copied);
+                  copied += count;
+                  offset = 0;
+                }
+                values[i] = {gathered, false};
+                break;
+              }
+            }
+          }
+
+          for (size_t k = 0; k < program_.size(); ++k) {
+            const Instruction& instruction = program_[k];
+            const TileValue a = values[instruction.operand0];
+            const TileValue b = instruction.operand1 >= 0 ? values[instruction.operand1] : TileValue{nullptr, true};
+            const int output_index = output_of_instruction_[k];
+
+            if (a.scalar && b.scalar) {
+              scalars[k] = ApplyScalar(instruction.op, *a.data, b.data != nullptr ? *b.data : 0.0f);
+              values[num_inputs_ + k] = {&scalars[k], true};
+              if (output_index >= 0) {
+                std::fill_n(outputs[output_index] + start, n, scalars[k]);
+              }
+              continue;
+            }
+
+            float* y = output_index >= 0 ? outputs[output_index] + start
+                                         : scratch.get() + instruction.slot * kTileSize;
+            ApplyTile(instruction.op, a.data, a.scalar, b.data, b.scalar, y, n);
+            values[num_inputs_ + k] = {y, false};
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
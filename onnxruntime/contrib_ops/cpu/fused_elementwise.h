@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a chain of fp32 elementwise operators (see ElementwiseFusion) in a single pass. The output is processed
+// in cache sized tiles so that intermediate values live in small scratch buffers instead of full tensors.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class OpCode : uint8_t {
+    // binary operators
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Max,
+    Min,
+    // unary operators
+    Abs,
+    Erf,
+    Exp,
+    Neg,
+    Reciprocal,
+    Relu,
+    Sigmoid,
+    Sqrt,
+    Tanh,
+  };
+
+ private:
+  struct Instruction {
+    OpCode op;
+    int operand0;
+    int operand1;  // -1 for unary operators
+    int slot;      // scratch slot of the result, or -1 if the result is written to an output
+  };
+
+  int num_inputs_;
+  InlinedVector<Instruction> program_;
+  InlinedVector<int> output_of_instruction_;  // output index for each instruction, or -1
+  int num_slots_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_ml_preprocessing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedMLPreprocessing,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedMLPreprocessing);
+
+namespace {
+
+// Number of elements of a block of rows. A block goes through all the steps while it is in the L1 cache.
+constexpr int64_t kBlockSize = 4096;
+
+void Impute(float* data, int64_t num_rows, int64_t row_size, float replaced_value,
+            const std::vector<float>& imputed_values) {
+  const bool replace_nan = std::isnan(replaced_value);
+  const bool per_feature = static_cast<int64_t>(imputed_values.size()) == row_size;
+  for (int64_t row = 0; row < num_rows; ++row, data += row_size) {
+    for (int64_t i = 0; i < row_size; ++i) {
+      if ((replace_nan && std::isnan(data[i])) || data[i] == replaced_value) {
+        data[i] = imputed_values[per_feature ? i : 0];
+      }
+    }
+  }
+}
+
+void Scale(float* data, int64_t num_rows, int64_t row_size, const std::vector<float>& offsets,
+           const std::vector<float>& scales) {
+  if (static_cast<int64_t>(offsets.size()) == row_size) {
+    for (int64_t row = 0; row < num_rows; ++row, data += row_size) {
+      for (int64_t i = 0; i < row_size; ++i) {
+        data[i] = (data[i] - offsets[i]) * scales[i];
+      }
+    }
+  } else {
+    const float offset = offsets[0];
+    const float scale = scales[0];
+    for (int64_t i = 0; i < num_rows * row_size; ++i) {
+      data[i] = (data[i] - offset) * scale;
+    }
+  }
+}
+
+void Normalize(float* data, int64_t num_rows, int64_t row_size, ml::NORMALIZE norm) {
+  for (int64_t row = 0; row < num_rows; ++row, data += row_size) {
+    switch (norm) {
+      case ml::NORMALIZE::NMAX: {
+        float max = std::numeric_limits<float>::lowest();
+        for (int64_t i = 0; i < row_size; ++i) {
+          max = std::max(max, data[i]);
+        }
+        if (max != 0.f) {
+          for (int64_t i = 0; i < row_size; ++i) {
+            data[i] /= max;
+          }
+        }
+        break;
+      }
+      case ml::NORMALIZE::L1: {
+        float sum = 0.f;
+        for (int64_t i = 0; i < row_size; ++i) {
+          sum += std::abs(data[i]);
+        }
+        if (sum != 0.f) {
+          for (int64_t i = 0; i < row_size; ++i) {
+            data[i] /= sum;
+          }
+        }
+        break;
+      }
+      case ml::NORMALIZE::L2: {
+        float sum = 0.f;
+        for (int64_t i = 0; i < row_size; ++i) {
+          sum += data[i] * data[i];
+        }
+        if (sum != 0.f) {
+          for (int64_t i = 0; i < row_size; ++i) {
+            const float value = std::sqrt(data[i] * data[i] / sum);
+            data[i] = data[i] < 0 ? -value : value;
+          }
+        }
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+FusedMLPreprocessing::FusedMLPreprocessing(const OpKernelInfo& info) : OpKernel(info) {
+  const auto steps = info.GetAttrsOrDefault<std::string>("steps");
+  const auto parameters = info.GetAttrsOrDefault<float>("parameters");
+  const auto parameter_sizes = info.GetAttrsOrDefault<int64_t>("parameter_sizes");
+  const auto norms = info.GetAttrsOrDefault<std::string>("norms");
+
+  ORT_ENFORCE(!steps.empty(), "FusedMLPreprocessing requires at least one step.");
+  ORT_ENFORCE(parameter_sizes.size() == steps.size(), "FusedMLPreprocessing requires one parameter size per step.");
+
+  size_t parameter_offset = 0;
+  size_t norm_index = 0;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const auto size = static_cast<size_t>(parameter_sizes[i]);
+    ORT_ENFORCE(parameter_sizes[i] >= 0 && parameter_offset + size <= parameters.size(),
+                "FusedMLPreprocessing step ", i, " has invalid parameters.");
+    const float* step_parameters = parameters.data() + parameter_offset;
+    parameter_offset += size;
+
+    Step step{};
+    if (steps[i] == "Imputer") {
+      ORT_ENFORCE(size >= 2, "FusedMLPreprocessing Imputer step ", i, " requires imputed values.");
+      step.type = StepType::Imputer;
+      step.value = step_parameters[0];
+      step.values.assign(step_parameters + 1, step_parameters + size);
+    } else if (steps[i] == "Scaler") {
+      ORT_ENFORCE(size >= 2 && size % 2 == 0, "FusedMLPreprocessing Scaler step ", i,
+                  " requires as many offsets as scales.");
+      step.type = StepType::Scaler;
+      step.values.assign(step_parameters, step_parameters + size / 2);
+      step.scales.assign(step_parameters + size / 2, step_parameters + size);
+    } else if (steps[i] == "Normalizer") {
+      ORT_ENFORCE(norm_index < norms.size(), "FusedMLPreprocessing Normalizer step ", i, " has no norm.");
+      step.type = StepType::Normalizer;
+      step.norm = ml::MakeNormalize(norms[norm_index++]);
+    } else if (steps[i] == "Binarizer") {
+      ORT_ENFORCE(size == 1, "FusedMLPreprocessing Binarizer step ", i, " requires a threshold.");
+      step.type = StepType::Binarizer;
+      step.value = step_parameters[0];
+    } else {
+      ORT_THROW("FusedMLPreprocessing does not support operator ", steps[i]);
+    }
+    steps_.push_back(std::move(step));
+  }
+}
+
+Status FusedMLPreprocessing::ApplyBlock(float* data, int64_t num_rows, int64_t row_size) const {
+  for (const Step& step : steps_) {
+    switch (step.type) {
+      case StepType::Imputer:
+        Impute(data, num_rows, row_size, step.value, step.values);
+        break;
+      case StepType::Scaler:
+        Scale(data, num_rows, row_size, step.values, step.scales);
+        break;
+      case StepType::Normalizer:
+        Normalize(data, num_rows, row_size, step.norm);
+        break;
+      case StepType::Binarizer:
+        for (int64_t i = 0; i < num_rows * row_size; ++i) {
+          if (std::isnan(data[i])) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input data of the Binarizer step is NaN");
+          }
+          data[i] = data[i] > step.value ? 1.f : 0.f;
+        }
+        break;
+    }
+  }
+  return Status::OK();
+}
+
+Status FusedMLPreprocessing::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);
+  const TensorShape& x_shape = X.Shape();
+  const auto x_dims = x_shape.GetDims();
+  if (x_dims.empty() || x_dims.size() > 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedMLPreprocessing input must have rank 1 or 2. Got ",
+                           x_shape);
+  }
+
+  const int64_t num_rows = x_dims.size() == 1 ? 1 : x_dims[0];
+  const int64_t row_size = x_dims.back();
+  for (const Step& step : steps_) {
+    if (step.type == StepType::Scaler && step.values.size() != 1 &&
+        static_cast<int64_t>(step.values.size()) != row_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Either both scale and offset can be of feature size (",
+                             row_size, ") or 1");
+    }
+  }
+
+  Tensor& Y = *context->Output(0, x_shape);
+  if (x_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const float* x_data = X.Data<float>();
+  float* y_data = Y.MutableData<float>();
+
+  const int64_t rows_per_block = std::max<int64_t>(1, kBlockSize / row_size);
+  const int64_t num_blocks = (num_rows + rows_per_block - 1) / rows_per_block;
+  const double block_bytes = static_cast<double>(rows_per_block * row_size * sizeof(float));
+  const TensorOpCost cost{block_bytes, block_bytes,
+                          static_cast<double>(rows_per_block * row_size) * 4.0 * steps_.size()};
+
+  OrtMutex status_mutex;
+  Status status;
+  ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const int64_t first_row = block * rows_per_block;
+          const int64_t block_rows = std::min(rows_per_block, num_rows - first_row);
+          float* data = y_data + first_row * row_size;
+          std::copy_n(x_data + first_row * row_size, block_rows * row_size, data);
+
+          Status block_status = ApplyBlock(data, block_rows, row_size);
+          if (!block_status.IsOK()) {
+            std::lock_guard<OrtMutex> lock(status_mutex);
+            status = std::move(block_status);
+            return;
+          }
+        }
+      });
+
+  return status;
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/ml_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a chain of row-wise ai.onnx.ml preprocessing operators (see MLPreprocessingFusion) in a single pass.
+// The rows are processed in blocks that fit in the L1 cache, each block going through every step before the next
+// one is loaded, and the blocks are distributed over the intra-op thread pool.
+class FusedMLPreprocessing final : public OpKernel {
+ public:
+  explicit FusedMLPreprocessing(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class StepType : uint8_t {
+    Imputer,
+    Scaler,
+    Normalizer,
+    Binarizer,
+  };
+
+ private:
+  struct Step {
+    StepType type;
+    // Imputer: the replaced value. Binarizer: the threshold.
+    float value;
+    // Imputer: the imputed values. Scaler: the offsets.
+    std::vector<float> values;
+    // Scaler: the scales.
+    std::vector<float> scales;
+    // Normalizer: the norm.
+    ml::NORMALIZE norm;
+  };
+
+  Status ApplyBlock(float* data, int64_t num_rows, int64_t row_size) const;
+
+  InlinedVector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
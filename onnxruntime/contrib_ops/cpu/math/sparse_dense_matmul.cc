@@ -45,6 +45,7 @@ struct ComputeCtx {
   bool trans_A;
   bool trans_B;
   float alpha;
+  concurrency::ThreadPool* thread_pool;
 };
 
 template <typename T>
@@ -76,7 +77,17 @@ inline void SparseDenseMatMulImpl<float>(const ComputeCtx& ctx, const ConstSpars
   }
 }
 
-// Handle CSR sparse format using Eigen
+template <typename T>
+inline T Mul(T a_value, float, T b_value) {
+  return a_value * b_value;
+}
+
+template <>
+inline constexpr float Mul<float>(float a_value, float alpha, float b_value) {
+  return a_value * alpha * b_value;
+}
+
+// Handle CSR sparse format, falling back to Eigen for transposed inputs
 template <class T>
 struct SparseToDenseCsr {
   void operator()(const ComputeCtx& ctx, const SparseTensor& A, const Tensor& B, Tensor& output) const {
@@ -84,6 +95,38 @@ struct SparseToDenseCsr {
     const auto& b_dims = B.Shape().GetDims();
     const auto& out_dims = output.Shape().GetDims();
     auto csr_view = A.AsCsr();
+
+    // Each CSR row of A produces the same row of the output, so rows can be computed in parallel.
+    if (!ctx.trans_A && !ctx.trans_B) {
+      const int64_t* outer_data = csr_view.Outer().Data<int64_t>();
+      const int64_t* inner_data = csr_view.Inner().Data<int64_t>();
+      const T* a_values = A.Values().Data<T>();
+      const T* b_data = B.Data<T>();
+      T* output_data = output.MutableData<T>();
+      const auto num_rows = narrow<std::ptrdiff_t>(out_dims[0]);
+      const auto num_cols = narrow<size_t>(out_dims[1]);
+      const double nnz_per_row = static_cast<double>(A.NumValues()) / std::max<double>(1.0, static_cast<double>(num_rows));
+      const double row_cost = nnz_per_row * static_cast<double>(num_cols);
+
+      concurrency::ThreadPool::TryParallelFor(
+          ctx.thread_pool, num_rows,
+          TensorOpCost{row_cost * sizeof(T), static_cast<double>(num_cols * sizeof(T)), row_cost},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t m = first; m < last; ++m) {
+              T* output_row = output_data + m * num_cols;
+              std::fill_n(output_row, num_cols, T{});
+              for (int64_t i = outer_data[m]; i < outer_data[m + 1]; ++i) {
+                const T a_value = a_values[i];
+                const T* b_row = b_data + narrow<size_t>(inner_data[i]) * num_cols;
+                for (size_t n = 0; n < num_cols; ++n) {
+                  output_row[n] += Mul(a_value, ctx.alpha, b_row[n]);
+                }
+              }
+            }
+          });
+      return;
+    }
+
     const Eigen::Index* inner_index_pointer = nullptr;
     const Eigen::Index* outer_index_pointer = nullptr;
     // For auto-release the above two pointers when they are not NULL.
@@ -119,22 +162,10 @@ struct SparseToDenseCsr {
     ConstEigenMatrixMapRowMajor<T> map_B(B.Data<T>(), narrow<Eigen::Index>(b_dims[0]), narrow<Eigen::Index>(b_dims[1]));
     EigenMatrixMapRowMajor<T> output_map(output.MutableData<T>(), narrow<Eigen::Index>(out_dims[0]),
                                          narrow<Eigen::Index>(out_dims[1]));
-    // XXX: Consider re-writing it as a parallel loop as Eigen requires it to use OpenMP
-    // XXX: Consider vectorization
     SparseDenseMatMulImpl(ctx, map_A, map_B, output_map);
   }
 };
 
-template <typename T>
-inline T Mul(T a_value, float, T b_value) {
-  return a_value * b_value;
-}
-
-template <>
-inline constexpr float Mul<float>(float a_value, float alpha, float b_value) {
-  return a_value * alpha * b_value;
-}
-
 // Inspired by TensorFlow SparseTensorDenseMatmul
 template <typename T>
 struct SparseToDenseCoo {
@@ -209,7 +240,7 @@ Status SparseToDenseMatMul::Compute(OpKernelContext* ctx) const {
   utils::MLTypeCallDispatcher<float, double, int32_t, uint32_t, int64_t, uint64_t> t_disp(A->GetElementType());
   // I am not expecting to do the below in every kernel but this is a reference
   // implementation to show the expectations.
-  ComputeCtx compute_ctx{trans_a_attr_ != 0, trans_b_attr_ != 0, alpha_attr_};
+  ComputeCtx compute_ctx{trans_a_attr_ != 0, trans_b_attr_ != 0, alpha_attr_, ctx->GetOperatorThreadPool()};
   if (A->Format() == SparseFormat::kCoo) {
     auto coo_view = A->AsCoo();
     const auto num_dims = coo_view.Indices().Shape().NumDimensions();
@@ -0,0 +1,306 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/wordpiece_tokenizer.h"
+
+#include <algorithm>
+#include <string>
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    WordPieceTokenizer,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
+    WordPieceTokenizer);
+
+namespace wordpiece_details {
+
+VocabTrie::VocabTrie() : ids_(2, kNoToken), build_children_(2) {
+  std::fill_n(&root_children_[0][0], 2 * 256, kNoNode);
+}
+
+bool VocabTrie::Add(std::string_view piece, int32_t id, bool continuation) {
+  if (piece.empty()) {
+    return false;
+  }
+
+  uint32_t node = continuation ? 1 : 0;
+  for (const char c : piece) {
+    auto inserted = build_children_[node].emplace(static_cast<uint8_t>(c), static_cast<uint32_t>(ids_.size()));
+    if (inserted.second) {
+      ids_.push_back(kNoToken);
+      build_children_.emplace_back();
+    }
+    node = inserted.first->second;
+  }
+
+  if (ids_[node] != kNoToken) {
+    return false;
+  }
+  ids_[node] = id;
+  return true;
+}
+
+void VocabTrie::Finalize() {
+  for (uint32_t root = 0; root < 2; ++root) {
+    for (const auto& child : build_children_[root]) {
+      root_children_[root][child.first] = child.second;
+    }
+  }
+
+  first_child_.reserve(build_children_.size() + 1);
+  labels_.reserve(build_children_.size());
+  children_.reserve(build_children_.size());
+  for (const auto& node_children : build_children_) {
+    first_child_.push_back(static_cast<uint32_t>(children_.size()));
+    for (const auto& child : node_children) {
+      labels_.push_back(child.first);
+      children_.push_back(child.second);
+    }
+  }
+  first_child_.push_back(static_cast<uint32_t>(children_.size()));
+
+  std::vector<std::map<uint8_t, uint32_t>>().swap(build_children_);
+}
+
+std::pair<size_t, int32_t> VocabTrie::LongestPrefix(std::string_view text, bool continuation,
+                                                    bool lower_case) const {
+  auto byte = [lower_case](char c) {
+    const auto b = static_cast<uint8_t>(c);
+    return lower_case && b >= 'A' && b <= 'Z' ? static_cast<uint8_t>(b + ('a' - 'A')) : b;
+  };
+
+  std::pair<size_t, int32_t> longest{0, kNoToken};
+  if (text.empty()) {
+    return longest;
+  }
+
+  uint32_t node = root_children_[continuation ? 1 : 0][byte(text[0])];
+  for (size_t length = 1; node != kNoNode; ++length) {
+    if (ids_[node] != kNoToken) {
+      longest = {length, ids_[node]};
+    }
+    if (length == text.size()) {
+      break;
+    }
+
+    const uint8_t label = byte(text[length]);
+    const auto first = labels_.begin() + first_child_[node];
+    const auto last = labels_.begin() + first_child_[node + 1];
+    const auto it = std::lower_bound(first, last, label);
+    node = it != last && *it == label ? children_[it - labels_.begin()] : kNoNode;
+  }
+  return longest;
+}
+
+}  // namespace wordpiece_details
+
+using wordpiece_details::VocabTrie;
+
+namespace {
+
+// ASCII whitespace and control characters separate words.
+bool IsSeparator(uint8_t c) { return c <= 0x20 || c == 0x7f; }
+
+// Each ASCII punctuation character is a word of its own.
+bool IsPunctuation(uint8_t c) {
+  return (c >= 0x21 && c <= 0x2f) || (c >= 0x3a && c <= 0x40) || (c >= 0x5b && c <= 0x60) ||
+         (c >= 0x7b && c <= 0x7e);
+}
+
+}  // namespace
+
+WordPieceTokenizer::WordPieceTokenizer(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<std::string> vocab;
+  ORT_ENFORCE(info.GetAttrs("vocab", vocab).IsOK() && !vocab.empty(), "WordPieceTokenizer requires a non-empty vocab");
+  ORT_ENFORCE(vocab.size() <= static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+              "WordPieceTokenizer vocab is too large: ", vocab.size());
+
+  const auto suffix_indicator = info.GetAttrOrDefault<std::string>("suffix_indicator", "##");
+  const auto unk_token = info.GetAttrOrDefault<std::string>("unk_token", "[UNK]");
+  const auto cls_token = info.GetAttrOrDefault<std::string>("cls_token", "");
+  const auto sep_token = info.GetAttrOrDefault<std::string>("sep_token", "");
+  do_lower_case_ = info.GetAttrOrDefault<int64_t>("do_lower_case", 1) != 0;
+  pad_token_id_ = info.GetAttrOrDefault<int64_t>("pad_token_id", 0);
+  max_length_ = info.GetAttrOrDefault<int64_t>("max_length", 0);
+  const int64_t max_input_chars_per_word = info.GetAttrOrDefault<int64_t>("max_input_chars_per_word", 100);
+  ORT_ENFORCE(max_input_chars_per_word > 0, "max_input_chars_per_word must be positive");
+  max_input_chars_per_word_ = narrow<size_t>(max_input_chars_per_word);
+
+  auto find_token = [&vocab](const std::string& token) -> int64_t {
+    const auto it = std::find(vocab.begin(), vocab.end(), token);
+    return it == vocab.end() ? -1 : static_cast<int64_t>(it - vocab.begin());
+  };
+  unk_token_id_ = find_token(unk_token);
+  ORT_ENFORCE(unk_token_id_ >= 0, "unk_token ", unk_token, " is not in the vocab");
+  if (!cls_token.empty()) {
+    cls_token_id_ = find_token(cls_token);
+    ORT_ENFORCE(cls_token_id_ >= 0, "cls_token ", cls_token, " is not in the vocab");
+  }
+  if (!sep_token.empty()) {
+    sep_token_id_ = find_token(sep_token);
+    ORT_ENFORCE(sep_token_id_ >= 0, "sep_token ", sep_token, " is not in the vocab");
+  }
+
+  const int64_t num_special_tokens = (cls_token_id_ >= 0 ? 1 : 0) + (sep_token_id_ >= 0 ? 1 : 0);
+  ORT_ENFORCE(max_length_ == 0 || max_length_ > num_special_tokens,
+              "max_length must be 0 or leave room for tokens besides cls_token and sep_token. Got ", max_length_);
+
+  // A piece that occurs more than once keeps its first token id.
+  for (size_t i = 0; i < vocab.size(); ++i) {
+    std::string_view piece = vocab[i];
+    const bool continuation = !suffix_indicator.empty() && piece.size() > suffix_indicator.size() &&
+                              piece.compare(0, suffix_indicator.size(), suffix_indicator) == 0;
+    if (continuation) {
+      piece.remove_prefix(suffix_indicator.size());
+    }
+    trie_.Add(piece, static_cast<int32_t>(i), continuation);
+  }
+  trie_.Finalize();
+}
+
+void WordPieceTokenizer::TokenizeWord(std::string_view text, size_t begin, size_t end,
+                                      std::vector<Token>& tokens) const {
+  const std::string_view word = text.substr(begin, end - begin);
+  size_t num_chars = 0;
+  for (const char c : word) {
+    num_chars += (static_cast<uint8_t>(c) & 0xc0) != 0x80 ? 1 : 0;
+  }
+
+  // The word is a single unknown token if it is too long or cannot be fully split into pieces.
+  const Token unknown{unk_token_id_, static_cast<int64_t>(begin), static_cast<int64_t>(end)};
+  if (num_chars > max_input_chars_per_word_) {
+    tokens.push_back(unknown);
+    return;
+  }
+
+  const size_t num_tokens = tokens.size();
+  for (size_t start = 0; start < word.size();) {
+    const auto piece = trie_.LongestPrefix(word.substr(start), start > 0, do_lower_case_);
+    if (piece.second == VocabTrie::kNoToken) {
+      tokens.resize(num_tokens);
+      tokens.push_back(unknown);
+      return;
+    }
+    tokens.push_back({piece.second, static_cast<int64_t>(begin + start),
+                      static_cast<int64_t>(begin + start + piece.first)});
+    start += piece.first;
+  }
+}
+
+void WordPieceTokenizer::TokenizeText(std::string_view text, std::vector<Token>& tokens) const {
+  size_t word_begin = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const auto c = static_cast<uint8_t>(text[i]);
+    if (IsSeparator(c) || IsPunctuation(c)) {
+      if (word_begin < i) {
+        TokenizeWord(text, word_begin, i, tokens);
+      }
+      if (IsPunctuation(c)) {
+        TokenizeWord(text, i, i + 1, tokens);
+      }
+      word_begin = i + 1;
+    }
+  }
+  if (word_begin < text.size()) {
+    TokenizeWord(text, word_begin, text.size(), tokens);
+  }
+}
+
+Status WordPieceTokenizer::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);
+  const TensorShape& x_shape = X.Shape();
+  if (x_shape.NumDimensions() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "WordPieceTokenizer input must have shape [N]. Got ",
+                           x_shape);
+  }
+
+  const auto texts = X.DataAsSpan<std::string>();
+  const auto num_rows = static_cast<std::ptrdiff_t>(texts.size());
+  const int64_t num_special_tokens = (cls_token_id_ >= 0 ? 1 : 0) + (sep_token_id_ >= 0 ? 1 : 0);
+  const size_t max_tokens = max_length_ > 0 ? narrow<size_t>(max_length_ - num_special_tokens)
+                                            : std::numeric_limits<size_t>::max();
+
+  size_t total_bytes = 0;
+  for (const auto& text : texts) {
+    total_bytes += text.size();
+  }
+  const double bytes_per_row = num_rows > 0 ? static_cast<double>(total_bytes) / num_rows : 0.0;
+  const TensorOpCost cost{bytes_per_row, bytes_per_row * sizeof(int64_t), bytes_per_row * 16.0};
+  ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  std::vector<std::vector<Token>> rows(texts.size());
+  ThreadPool::TryParallelFor(thread_pool, num_rows, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      TokenizeText(texts[row], rows[row]);
+      if (rows[row].size() > max_tokens) {
+        rows[row].resize(max_tokens);
+      }
+    }
+  });
+
+  int64_t width = max_length_;
+  if (width == 0) {
+    size_t longest = 0;
+    for (const auto& tokens : rows) {
+      longest = std::max(longest, tokens.size());
+    }
+    width = static_cast<int64_t>(longest) + num_special_tokens;
+  }
+
+  const int64_t batch_size = x_shape[0];
+  int64_t* ids = context->Output(0, {batch_size, width})->MutableData<int64_t>();
+  Tensor* attention_mask = context->Output(1, {batch_size, width});
+  Tensor* offsets = context->Output(2, {batch_size, width, 2});
+  int64_t* mask_data = attention_mask != nullptr ? attention_mask->MutableData<int64_t>() : nullptr;
+  int64_t* offsets_data = offsets != nullptr ? offsets->MutableData<int64_t>() : nullptr;
+
+  ThreadPool::TryParallelFor(
+      thread_pool, num_rows, static_cast<double>(width * 4 * sizeof(int64_t)),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          int64_t* row_ids = ids + row * width;
+          int64_t* row_mask = mask_data != nullptr ? mask_data + row * width : nullptr;
+          int64_t* row_offsets = offsets_data != nullptr ? offsets_data + row * width * 2 : nullptr;
+          int64_t position = 0;
+          auto emit = [&](int64_t id, int64_t begin, int64_t end, int64_t mask) {
+            row_ids[position] = id;
+            if (row_mask != nullptr) {
+              row_mask[position] = mask;
+            }
+            if (row_offsets != nullptr) {
+              row_offsets[2 * position] = begin;
+              row_offsets[2 * position + 1] = end;
+            }
+            ++position;
+          };
+
+          if (cls_token_id_ >= 0) {
+            emit(cls_token_id_, 0, 0, 1);
+          }
+          for (const Token& token : rows[row]) {
+            emit(token.id, token.begin, token.end, 1);
+          }
+          if (sep_token_id_ >= 0) {
+            emit(sep_token_id_, 0, 0, 1);
+          }
+          while (position < width) {
+            emit(pad_token_id_, 0, 0, 0);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
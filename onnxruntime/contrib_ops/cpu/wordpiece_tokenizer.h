@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace wordpiece_details {
+
+// Byte trie over the pieces of a WordPiece vocabulary. Pieces that start a word and pieces that continue one
+// (the ones with the suffix indicator, which is stripped) hang from two different roots.
+// The children of the roots are indexed directly by byte. The children of the other nodes are kept in one array
+// sorted by byte per node, so a lookup walks the text once and touches a few contiguous arrays.
+class VocabTrie {
+ public:
+  static constexpr int32_t kNoToken = -1;
+
+  VocabTrie();
+
+  // Adds piece with the given token id. Returns false if piece is empty or already in the trie.
+  bool Add(std::string_view piece, int32_t id, bool continuation);
+
+  // Builds the layout used by LongestPrefix. Add must not be called afterwards.
+  void Finalize();
+
+  // Returns the length and token id of the longest piece that is a prefix of text, or (0, kNoToken) if there is
+  // none. If lower_case is true, the ASCII uppercase letters of text are matched as lowercase.
+  std::pair<size_t, int32_t> LongestPrefix(std::string_view text, bool continuation, bool lower_case) const;
+
+ private:
+  static constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+
+  std::vector<int32_t> ids_;  // token id of each node, kNoToken if no piece ends there
+  // Children of each node while the trie is built. Nodes 0 and 1 are the roots.
+  std::vector<std::map<uint8_t, uint32_t>> build_children_;
+  uint32_t root_children_[2][256];
+  // The children of node n are children_[first_child_[n]..first_child_[n + 1]), their bytes are in labels_.
+  std::vector<uint32_t> first_child_;
+  std::vector<uint8_t> labels_;
+  std::vector<uint32_t> children_;
+};
+
+}  // namespace wordpiece_details
+
+// Tokenizes a batch of texts into BERT style WordPiece token ids in one kernel. The texts are split into words
+// and each word into the longest matching pieces of the vocabulary, working on views of the input strings.
+// The rows of the batch are tokenized in parallel on the intra-op thread pool.
+class WordPieceTokenizer final : public OpKernel {
+ public:
+  explicit WordPieceTokenizer(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Token {
+    int64_t id;
+    int64_t begin;  // byte offsets in the input text
+    int64_t end;
+  };
+
+  void TokenizeText(std::string_view text, std::vector<Token>& tokens) const;
+  void TokenizeWord(std::string_view text, size_t begin, size_t end, std::vector<Token>& tokens) const;
+
+  wordpiece_details::VocabTrie trie_;
+  int64_t unk_token_id_{0};
+  int64_t cls_token_id_{-1};
+  int64_t sep_token_id_{-1};
+  int64_t pad_token_id_{0};
+  int64_t max_length_{0};
+  size_t max_input_chars_per_word_{0};
+  bool do_lower_case_{true};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -351,7 +351,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 #ifdef ORT_ENABLE_STREAM
                                const DeviceStreamCollection* device_streams,
 #endif
-                               const SessionState& session_state)
+                               const SessionState& session_state,
+                               const InlinedHashSet<NodeIndex>* node_to_execute)
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
 #ifdef ORT_ENABLE_STREAM
       device_streams_(device_streams),
@@ -406,7 +407,10 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      // the fetches only change the pattern if nodes are skipped.
+      mem_patterns_ = session_state.GetMemoryPatternGroup(
+          feeds, feed_mlvalue_idxs, node_to_execute != nullptr ? fetch_mlvalue_idxs : gsl::span<const int>{},
+          inferred_shapes_);
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
@@ -146,7 +146,9 @@ class ExecutionFrame final : public IExecutionFrame {
 #ifdef ORT_ENABLE_STREAM
                  const DeviceStreamCollection* device_streams,
 #endif
-                 const SessionState& session_state);
+                 const SessionState& session_state,
+                 // nodes to execute if the run skips the nodes that are not on a path to the fetches, else nullptr
+                 const InlinedHashSet<NodeIndex>* node_to_execute = nullptr);
   ~ExecutionFrame() override;
 
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
@@ -3,8 +3,11 @@
 
 #include "core/framework/graph_partitioner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
+#include <numeric>
+#include <optional>
 
 #include "core/framework/compute_capability.h"
 #include "core/framework/execution_providers.h"
@@ -12,6 +15,7 @@
 #include "core/framework/kernel_lookup.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/partitioning_cost_model.h"
 #include "core/graph/function.h"
 #include "core/graph/function_utils.h"
 #include "core/graph/graph_viewer.h"
@@ -350,6 +354,84 @@ static Node* PlaceNode(Graph& graph, const IndexedSubGraph& capability,
   return result;
 }
 
+// Removes the capabilities of `ep_type` that the cost model estimates to run faster on the CPU EP.
+// Capabilities that are connected to each other are evaluated together, as there are no copies between them when
+// they are all taken by the EP.
+static void RemoveCapabilitiesPreferringCpu(const Graph& graph, const PartitioningCostModel& cost_model,
+                                            const KernelRegistryManager& kernel_registry_mgr,
+                                            const std::string& ep_type,
+                                            std::vector<std::unique_ptr<ComputeCapability>>& capabilities) {
+  const auto cpu_kernel_registries = kernel_registry_mgr.GetKernelRegistriesByProviderType(kCpuExecutionProvider);
+  const KernelLookup cpu_kernel_lookup{kCpuExecutionProvider,
+                                       cpu_kernel_registries,
+                                       kernel_registry_mgr.GetKernelTypeStrResolver()};
+
+  // union-find of the capability indices, joining capabilities with an edge between their nodes.
+  std::vector<size_t> group(capabilities.size());
+  std::iota(group.begin(), group.end(), size_t{0});
+  auto find_group = [&group](size_t i) {
+    while (group[i] != i) {
+      group[i] = group[group[i]];
+      i = group[i];
+    }
+    return i;
+  };
+
+  InlinedHashMap<NodeIndex, size_t> node_to_capability;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    for (NodeIndex node_index : capabilities[i]->sub_graph->nodes) {
+      node_to_capability.emplace(node_index, i);
+    }
+  }
+
+  for (const auto& [node_index, capability_index] : node_to_capability) {
+    const Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+    for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+      auto consumer = node_to_capability.find(it->Index());
+      if (consumer != node_to_capability.end()) {
+        group[find_group(consumer->second)] = find_group(capability_index);
+      }
+    }
+  }
+
+  InlinedHashMap<size_t, std::vector<NodeIndex>> group_nodes;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    auto& nodes = group_nodes[find_group(i)];
+    const auto& capability_nodes = capabilities[i]->sub_graph->nodes;
+    nodes.insert(nodes.end(), capability_nodes.begin(), capability_nodes.end());
+  }
+
+  InlinedHashSet<size_t> groups_preferring_cpu;
+  for (const auto& [group_index, nodes] : group_nodes) {
+    // the nodes can only be left to the CPU EP if it has kernels for all of them.
+    const bool cpu_can_run_all = std::all_of(nodes.begin(), nodes.end(), [&](NodeIndex node_index) {
+      const Node* node = graph.GetNode(node_index);
+      return node != nullptr && cpu_kernel_lookup.LookUpKernel(*node) != nullptr;
+    });
+
+    if (cpu_can_run_all && cost_model.PreferCpu(graph, ep_type, nodes)) {
+      LOGS_DEFAULT(INFO) << "Leaving " << nodes.size() << " node(s) claimed by " << ep_type
+                         << " on the CPU EP as the partitioning cost model estimates it to be faster.";
+      groups_preferring_cpu.insert(group_index);
+    }
+  }
+
+  if (groups_preferring_cpu.empty()) {
+    return;
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>> remaining_capabilities;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    if (groups_preferring_cpu.count(find_group(i)) == 0) {
+      remaining_capabilities.push_back(std::move(capabilities[i]));
+    }
+  }
+  capabilities = std::move(remaining_capabilities);
+}
+
 // for the current EP, recursively iterate through the Graph and any nested subgraphs (recursion is bottom-up).
 // assign any nodes to the EP that are currently unassigned, and that the EP can handle.
 static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
@@ -359,7 +441,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
                                            GraphPartitioner::Mode mode,
                                            int& fused_node_unique_id,
                                            const layout_transformation::TransformLayoutFunction& transform_layout_fn,
-                                           const layout_transformation::DebugGraphFn& debug_graph_fn) {
+                                           const layout_transformation::DebugGraphFn& debug_graph_fn,
+                                           const PartitioningCostModel* cost_model) {
   // handle testing edge case where optimizers or constant lifting results in graph with no nodes.
   // doing it here saves all providers checking for this in GetCapability
   if (graph.NumberOfNodes() == 0) {
@@ -373,7 +456,7 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       // we pass through the FuncManager from the top level graph
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(*subgraph, func_mgr, kernel_registry_mgr,
                                                        fused_kernel_registry, current_ep, mode, fused_node_unique_id,
-                                                       transform_layout_fn, debug_graph_fn));
+                                                       transform_layout_fn, debug_graph_fn, cost_model));
     }
   }
 
@@ -399,6 +482,14 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       std::cref(debug_graph_fn)};
 
   ORT_RETURN_IF_ERROR(GetCapabilityForEP(get_capability_params));
+
+  // EPs with an NHWC layout have had the layout transformation applied to the nodes they claimed, so those nodes
+  // must stay with them.
+  if (cost_model != nullptr && current_ep.Type() != kCpuExecutionProvider &&
+      current_ep.GetPreferredLayout() != DataLayout::NHWC) {
+    RemoveCapabilitiesPreferringCpu(graph, *cost_model, kernel_registry_mgr, current_ep.Type(), capabilities);
+  }
+
   if (capabilities.empty()) {
     return Status::OK();
   }
@@ -727,7 +818,8 @@ static Status CreateEpContextModel(const ExecutionProviders& execution_providers
 
 static Status PartitionOnnxFormatModel(const PartitionParams& partition_params, GraphPartitioner::Mode mode,
                                        const ExecutionProviders& execution_providers,
-                                       KernelRegistryManager& kernel_registry_manager) {
+                                       KernelRegistryManager& kernel_registry_manager,
+                                       const PartitioningCostModel* cost_model) {
   bool modified_graph = false;
 
   auto& graph = partition_params.graph.get();
@@ -742,7 +834,8 @@ static Status PartitionOnnxFormatModel(const PartitionParams& partition_params,
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(graph, func_mgr, kernel_registry_manager,
                                                        fused_kernel_registry, *ep, mode, fused_node_unique_id,
                                                        transform_layout_function,
-                                                       partition_params.debug_graph_fn));
+                                                       partition_params.debug_graph_fn,
+                                                       cost_model));
     }
 
     // expand any nodes that have an ONNX function definition but no matching ORT kernel.
@@ -977,8 +1070,18 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
 
   if (mode == Mode::kNormal || mode == Mode::kAssignOnly) {
 #if !defined(ORT_MINIMAL_BUILD)
+    // the cost model is not used when only assigning nodes, as all nodes an EP can take are preserved then.
+    std::optional<PartitioningCostModel> cost_model;
+    const std::string cost_model_path =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsPartitioningCostModelFile, "");
+    if (mode == Mode::kNormal && !cost_model_path.empty()) {
+      cost_model.emplace();
+      ORT_RETURN_IF_ERROR(PartitioningCostModel::Load(cost_model_path, *cost_model));
+    }
+
     ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode,
-                                                 providers_, kernel_registry_mgr_));
+                                                 providers_, kernel_registry_mgr_,
+                                                 cost_model ? &*cost_model : nullptr));
 
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
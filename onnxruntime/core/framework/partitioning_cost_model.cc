@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/framework/partitioning_cost_model.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "core/common/parse_string.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor_shape.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace {
+
+std::string OpTypeOf(const Node& node) {
+  return node.Domain().empty() ? node.OpType() : node.Domain() + "." + node.OpType();
+}
+
+std::string CostKey(const std::string& ep_type, const std::string& op_type) {
+  return ep_type + " " + op_type;
+}
+
+}  // namespace
+
+Status PartitioningCostModel::Load(const std::string& file_path, PartitioningCostModel& cost_model) {
+  std::ifstream file{file_path};
+  ORT_RETURN_IF_NOT(file.good(), "Failed to open the partitioning cost model file: ", file_path);
+
+  std::string line;
+  for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+    std::istringstream line_stream{line};
+    std::vector<std::string> tokens;
+    for (std::string token; line_stream >> token;) {
+      tokens.push_back(std::move(token));
+    }
+
+    if (tokens.empty() || tokens[0][0] == '#') {
+      continue;
+    }
+
+    if (tokens.size() == 4 && tokens[1] == "copy") {
+      TransferCostEntry entry{};
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(tokens[2], entry.per_tensor) &&
+                            TryParseStringWithClassicLocale(tokens[3], entry.per_mb),
+                        "Invalid copy cost in ", file_path, " line ", line_number, ": ", line);
+      cost_model.transfer_costs_[tokens[0]] = entry;
+    } else if (tokens.size() == 3) {
+      double cost = 0.0;
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(tokens[2], cost),
+                        "Invalid kernel cost in ", file_path, " line ", line_number, ": ", line);
+      cost_model.kernel_costs_[CostKey(tokens[0], tokens[1])] = cost;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid entry in ", file_path,
+                             " line ", line_number, ": ", line);
+    }
+  }
+
+  return Status::OK();
+}
+
+std::optional<double> PartitioningCostModel::KernelCost(const std::string& ep_type, const Node& node) const {
+  auto it = kernel_costs_.find(CostKey(ep_type, OpTypeOf(node)));
+  if (it == kernel_costs_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+double PartitioningCostModel::TransferCost(const std::string& ep_type, const NodeArg& value) const {
+  auto it = transfer_costs_.find(ep_type);
+  if (it == transfer_costs_.end()) {
+    return 0.0;
+  }
+
+  double cost = it->second.per_tensor;
+
+  // the size dependent part is only added if the size is known.
+  const auto* type = value.TypeAsProto();
+  const auto* shape = value.Shape();
+  if (type != nullptr && shape != nullptr && utils::HasTensorType(*type) && utils::HasElemType(type->tensor_type()) &&
+      type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED) {
+    const int64_t element_count = utils::GetTensorShapeFromTensorShapeProto(*shape).Size();
+    if (element_count >= 0) {
+      const auto element_size = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())
+                                    ->GetElementType()
+                                    ->Size();
+      cost += it->second.per_mb * static_cast<double>(element_count) * element_size / (1024.0 * 1024.0);
+    }
+  }
+
+  return cost;
+}
+
+bool PartitioningCostModel::PreferCpu(const Graph& graph, const std::string& ep_type,
+                                      gsl::span<const NodeIndex> nodes) const {
+  InlinedHashSet<NodeIndex> node_set(nodes.begin(), nodes.end());
+
+  double ep_cost = 0.0;
+  double cpu_cost = 0.0;
+  InlinedHashSet<std::string_view> transferred_values;
+
+  for (NodeIndex node_index : nodes) {
+    const Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      return false;
+    }
+
+    const auto node_ep_cost = KernelCost(ep_type, *node);
+    const auto node_cpu_cost = KernelCost(kCpuExecutionProvider, *node);
+    if (!node_ep_cost || !node_cpu_cost) {
+      return false;
+    }
+    ep_cost += *node_ep_cost;
+    cpu_cost += *node_cpu_cost;
+
+    // values produced outside of `nodes` are copied to the EP. constant initializers are copied once when the
+    // session is initialized so they are free.
+    auto add_input_transfer = [&](const NodeArg* input) {
+      if (!input->Exists() || graph.GetConstantInitializer(input->Name(), true) != nullptr) {
+        return;
+      }
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if ((producer == nullptr || node_set.count(producer->Index()) == 0) &&
+          transferred_values.insert(input->Name()).second) {
+        ep_cost += TransferCost(ep_type, *input);
+      }
+    };
+    for (const NodeArg* input : node->InputDefs()) {
+      add_input_transfer(input);
+    }
+    for (const NodeArg* input : node->ImplicitInputDefs()) {
+      add_input_transfer(input);
+    }
+
+    // values consumed outside of `nodes` are copied back.
+    for (const NodeArg* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+
+      bool consumed_outside = graph.IsOutput(output);
+      for (const Node* consumer : graph.GetConsumerNodes(output->Name())) {
+        consumed_outside = consumed_outside || node_set.count(consumer->Index()) == 0;
+      }
+      if (consumed_outside && transferred_values.insert(output->Name()).second) {
+        ep_cost += TransferCost(ep_type, *output);
+      }
+    }
+  }
+
+  return cpu_cost < ep_cost;
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <optional>
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class Graph;
+class Node;
+class NodeArg;
+
+/**
+ * Kernel and data transfer costs of execution providers, measured offline. Graph partitioning uses them to leave
+ * nodes on the CPU EP when another EP would not run them faster once the copies to and from it are included.
+ *
+ * The costs are read from a text file with one entry per line:
+ *   <EP type> <op type> <microseconds per kernel run>
+ *   <EP type> copy <microseconds per tensor copied> <microseconds per MB copied>
+ * The op type of a node in a domain other than ONNX is prefixed with the domain, e.g. com.microsoft.Attention.
+ * Empty lines and lines starting with '#' are ignored.
+ */
+class PartitioningCostModel {
+ public:
+  static Status Load(const std::string& file_path, PartitioningCostModel& cost_model);
+
+  // Returns the cost of running the node on the EP, or nullopt if it is not in the profile.
+  std::optional<double> KernelCost(const std::string& ep_type, const Node& node) const;
+
+  // Returns the cost of copying the value between the EP and the CPU, or 0 if the EP has no copy entry.
+  double TransferCost(const std::string& ep_type, const NodeArg& value) const;
+
+  // Returns true if `nodes` are estimated to run faster on the CPU EP than on `ep_type`, including the copies of the
+  // values that cross the boundary of `nodes`. Returns false if the cost of a node is missing for either EP.
+  bool PreferCpu(const Graph& graph, const std::string& ep_type, gsl::span<const NodeIndex> nodes) const;
+
+ private:
+  struct TransferCostEntry {
+    double per_tensor;
+    double per_mb;
+  };
+
+  // keyed by "<EP type> <op type>"
+  InlinedHashMap<std::string, double> kernel_costs_;
+  InlinedHashMap<std::string, TransferCostEntry> transfer_costs_;
+};
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -540,6 +540,15 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       valid_streams++;
   }
 
+  // the nodes are only skipped if some of them do not reach the fetches.
+  const InlinedHashSet<NodeIndex>* node_to_execute = nullptr;
+  if (only_execute_path_to_fetches) {
+    const auto& to_be_executed_range = session_state.GetToBeExecutedRange(fetch_mlvalue_idxs);
+    if (to_be_executed_range.size() < static_cast<size_t>(session_state.GetGraphViewer().NumberOfNodes())) {
+      node_to_execute = &to_be_executed_range;
+    }
+  }
+
   // prepare the execution context, notifications got initialized.
 #ifdef ORT_ENABLE_STREAM
   StreamExecutionContext ctx(session_state,
@@ -553,7 +562,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
+                             single_thread_mode,
+                             node_to_execute);
 #else
   StreamExecutionContext ctx(session_state,
                              valid_streams,
@@ -563,15 +573,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
-#endif
-#ifdef ENABLE_TRAINING
-  if (only_execute_path_to_fetches) {
-    auto* node_to_execute = session_state.GetToBeExecutedRange(fetch_mlvalue_idxs);
-    ctx.SetNodeToExecute(node_to_execute);
-  }
-#else
-  ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
+                             single_thread_mode,
+                             node_to_execute);
 #endif
 
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
@@ -606,7 +609,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
     if (all_tensors) {
       MemoryPatternGroup mem_patterns;
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(
+          feeds, node_to_execute != nullptr ? fetch_mlvalue_idxs : gsl::span<const int>{}, std::move(mem_patterns)));
     }
   }
 
@@ -523,12 +523,20 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
+// The fetches are part of the key if the Run skips the nodes that are not on a path to them, as it traces a pattern
+// without the buffers of the skipped nodes. Otherwise they are empty, so Runs with different fetches share the
+// pattern. They are combined independent of their order.
+static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs,
+                                          gsl::span<const int> fetch_mlvalue_idxs) {
   int64_t key = 0;
   for (const auto& input : tensor_inputs) {
     for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
   }
-  return key;
+  uint64_t fetches_key = 0;
+  for (int idx : fetch_mlvalue_idxs) {
+    fetches_key += (static_cast<uint64_t>(idx) + 1) * 0x9E3779B97F4A7C15ULL;
+  }
+  return key ^ static_cast<int64_t>(fetches_key);
 }
 
 #ifdef ENABLE_TRAINING
@@ -770,9 +778,10 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
+    gsl::span<const int> fetch_mlvalue_idxs,
     const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, fetch_mlvalue_idxs);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
@@ -846,8 +855,9 @@ void SessionState::ResolveMemoryPatternFlag() {
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                                   gsl::span<const int> fetch_mlvalue_idxs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, fetch_mlvalue_idxs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   // Do not update if present, as the pointer to the existing one is cached
@@ -984,47 +994,42 @@ const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   return *node_index_info_;
 }
 
-#ifdef ENABLE_TRAINING
-void SessionState::UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) {
+const InlinedHashSet<NodeIndex>& SessionState::GetToBeExecutedRange(
+    gsl::span<int const> fetch_mlvalue_idxs) const {
   InlinedVector<int> sorted_idxs;
   sorted_idxs.reserve(fetch_mlvalue_idxs.size());
   sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
-    return;
 
-  // Get the nodes generating the fetches.
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_lock_);
+  auto it = to_be_executed_nodes_.find(sorted_idxs);
+  if (it != to_be_executed_nodes_.end()) {
+    return it->second;
+  }
+
+  // Get the nodes generating the fetches. A fetch of a graph input or an initializer has no producer.
   InlinedVector<const Node*> nodes;
   nodes.reserve(fetch_mlvalue_idxs.size());
   InlinedHashSet<NodeIndex> reachable_nodes;
   reachable_nodes.reserve(graph_.NumberOfNodes());
 
-  for (auto idx : fetch_mlvalue_idxs) {
+  for (auto idx : sorted_idxs) {
     std::string node_arg_name;
     const auto status = this->GetOrtValueNameIdxMap().GetName(idx, node_arg_name);
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-    auto ending_node = graph_.GetProducerNode(node_arg_name);
-    nodes.push_back(ending_node);
+    const auto* ending_node = graph_.GetProducerNode(node_arg_name);
+    if (ending_node != nullptr) {
+      nodes.push_back(ending_node);
+    }
   }
 
   // Reversely traverse to get reachable nodes.
   graph_.ReverseDFSFrom(
       nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes.insert(n->Index()); });
 
-  // global start, end doesn't matters
-  to_be_executed_nodes_.emplace(std::move(sorted_idxs), std::move(reachable_nodes));
-}
-
-const InlinedHashSet<NodeIndex>* SessionState::GetToBeExecutedRange(
-    gsl::span<int const> fetch_mlvalue_idxs) const {
-  InlinedVector<int> sorted_idxs;
-  sorted_idxs.reserve(fetch_mlvalue_idxs.size());
-  sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
-  std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  auto it = to_be_executed_nodes_.find(sorted_idxs);
-  return (it != to_be_executed_nodes_.end()) ? &it->second : nullptr;
+  // the cache is node based so the returned reference stays valid when other fetch sets are added
+  return to_be_executed_nodes_.emplace(std::move(sorted_idxs), std::move(reachable_nodes)).first->second;
 }
-#endif
 
 Status SessionState::CreateSubgraphSessionState() {
   for (auto& node : graph_.Nodes()) {
@@ -212,7 +212,8 @@ class SessionState {
 #endif
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes, and on the fetches if the run skips the nodes that are not on a
+  path to them. fetch_mlvalue_idxs is empty otherwise.
   Must be called only when all values contain tensors
   In training scenarios, the cache may be updated so
   the callers would receive a copy of inferred shapes
@@ -223,6 +224,7 @@ class SessionState {
   const MemoryPatternGroup* GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
+      gsl::span<const int> fetch_mlvalue_idxs,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
 
   /**
@@ -231,6 +233,7 @@ class SessionState {
   All inputs must represent Tensors
   */
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                       gsl::span<const int> fetch_mlvalue_idxs,
                                        MemoryPatternGroup mem_patterns) const;
 
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
@@ -298,10 +301,12 @@ class SessionState {
   InlinedVector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
 
   const NodeIndexInfo& GetNodeIndexInfo() const;
-#ifdef ENABLE_TRAINING
-  void UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs);
-  const InlinedHashSet<NodeIndex>* GetToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) const;
-#endif
+
+  /**
+  Get the nodes on a path to the values with the given indexes, the nodes a Run fetching only these values executes.
+  The nodes are computed on the first request for a set of fetches and cached. Safe to call from concurrent Runs.
+  */
+  const InlinedHashSet<NodeIndex>& GetToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) const;
 
   Status FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                               const KernelRegistryManager& kernel_registry_manager,
@@ -518,13 +523,14 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
-#ifdef ENABLE_TRAINING
-// Needed for ORTTrainer. Should be removed along with ORTTrainer code
+  // lock for the to_be_executed_nodes_
+  mutable OrtMutex to_be_executed_nodes_lock_;
+  // cache for the nodes to execute for a set of fetches. key is the sorted indexes of the fetches.
+  // must be a node based container as a pointer is cached.
 #ifndef DISABLE_ABSEIL
-  InlinedHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
+  mutable NodeHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
 #else
-  std::map<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
-#endif
+  mutable std::map<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
 #endif
 
   SessionState* parent_ = nullptr;
@@ -70,7 +70,8 @@ class StreamExecutionContext {
                          std::vector<OrtValue>& fetches,
                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                          const logging::Logger& sess_logger,
-                         bool single_thread_mode);
+                         bool single_thread_mode,
+                         const InlinedHashSet<NodeIndex>* node_to_execute = nullptr);
 
   const SessionState& GetSessionState() const;
 
@@ -137,16 +138,13 @@ class StreamExecutionContext {
     program_range_ = range;
   }
 
-  const InlinedHashSet<NodeIndex>* GetNodeToExecute() {
-    return node_to_execute_;
-  }
+#endif
 
-  void SetNodeToExecute(const InlinedHashSet<NodeIndex>* node_to_execute) {
-    node_to_execute_ = node_to_execute;
+  // nodes to execute when only the path to the fetches is executed. nullptr to execute all the nodes.
+  const InlinedHashSet<NodeIndex>* GetNodeToExecute() const {
+    return node_to_execute_;
   }
 
-#endif
-
  private:
   const SessionState* session_state_;
 
@@ -164,11 +162,9 @@ class StreamExecutionContext {
   const ProgramRegion* program_range_{nullptr};
 
   OrtValueCachePtr cache_{nullptr};
-
-  // TODO: this is mainly for ort trainer
-  // Should we deprecate it?
-  const InlinedHashSet<NodeIndex>* node_to_execute_{nullptr};
 #endif
+
+  const InlinedHashSet<NodeIndex>* const node_to_execute_;
   const bool single_thread_mode_;
 
 #ifdef ORT_ENABLE_STREAM
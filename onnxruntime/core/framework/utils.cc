@@ -771,6 +771,9 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             const logging::Logger& logger) {
+  const bool only_execute_path_to_fetches =
+      run_options.only_execute_path_to_fetches ||
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigOnlyExecutePathToFetches, "0") == "1";
   return ExecuteGraph(session_state,
                       feeds_fetches_manager,
                       feeds, fetches,
@@ -780,7 +783,7 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                       device_stream_collection_holder,
 #endif
-                      run_options.only_execute_path_to_fetches);
+                      only_execute_path_to_fetches);
 }
 
 #ifdef ENABLE_TRAINING
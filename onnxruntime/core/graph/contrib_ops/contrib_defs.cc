@@ -631,6 +631,73 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators as a single kernel. The chain is described by a small program:
+instruction i applies ops[i] to the values operands[2 * i] and operands[2 * i + 1], where values
+[0, number of inputs) are the inputs and value (number of inputs + i) is the result of instruction i.
+The second operand of a unary operator is -1. Output j is the value results[j].
+Inputs are broadcast to the shape of the outputs using multidirectional (Numpy-style) broadcasting.
+Supported operators are Add, Sub, Mul, Div, Max, Min, Abs, Erf, Exp, Neg, Reciprocal, Relu, Sigmoid, Sqrt and Tanh.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "Operator type of each instruction.", AttributeProto::STRINGS)
+        .Attr("operands", "Two operand value indices for each instruction.", AttributeProto::INTS)
+        .Attr("results", "Value index of each output.", AttributeProto::INTS)
+        .Input(0, "inputs", "Inputs of the elementwise chain.", "T", OpSchema::Variadic)
+        .Output(0, "outputs", "Outputs of the elementwise chain.", "T", OpSchema::Variadic)
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          std::vector<const TensorShapeProto*> shapes;
+          for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+            if (!hasInputShape(ctx, i)) {
+              shapes.clear();
+              break;
+            }
+            shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+          }
+          for (size_t i = 0; i < ctx.getNumOutputs(); ++i) {
+            propagateElemTypeFromInputToOutput(ctx, 0, i);
+            if (!shapes.empty()) {
+              multidirectionalBroadcastShapeInference(
+                  shapes, *ctx.getOutputType(i)->mutable_tensor_type()->mutable_shape());
+            }
+          }
+        }));
+
+constexpr const char* FusedMLPreprocessing_ver1_doc = R"DOC(
+Applies a chain of row-wise ai.onnx.ml preprocessing operators to a float tensor of shape [N, C] or [C] as a
+single kernel. steps[i] is the operator type of step i: Imputer, Scaler, Normalizer or Binarizer.
+The float parameters of step i are the next parameter_sizes[i] values of parameters:
+Imputer: replaced_value_float followed by imputed_value_floats.
+Scaler: offset followed by scale, both of the same length.
+Binarizer: threshold.
+Normalizer: none, its norm is the next value of norms.
+Each step has the semantics of the corresponding ai.onnx.ml operator.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedMLPreprocessing, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedMLPreprocessing_ver1_doc)
+        .Attr("steps", "Operator type of each step.", AttributeProto::STRINGS)
+        .Attr("parameters", "Float parameters of all the steps, in order.", AttributeProto::FLOATS,
+              std::vector<float>())
+        .Attr("parameter_sizes", "Number of float parameters of each step.", AttributeProto::INTS)
+        .Attr("norms", "Norm of each Normalizer step, in order: 'MAX', 'L1' or 'L2'.", AttributeProto::STRINGS,
+              std::vector<std::string>())
+        .Input(0, "X", "Data to be processed.", "T")
+        .Output(0, "Y", "Processed data.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -1933,6 +2000,75 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Tokenizer, 1,
                                   updateOutputShape(ctx, 0, output_shape);
                                 }));
 
+constexpr const char* WordPieceTokenizer_ver1_doc = R"DOC(
+WordPieceTokenizer converts each string of X, of shape [N], into the token ids of a BERT style WordPiece vocabulary.
+The text is first split into words on ASCII whitespace and control characters, and every ASCII punctuation character
+is a word of its own. If do_lower_case is set, ASCII uppercase letters are matched as lowercase.
+Each word is then split greedily into the longest pieces of the vocabulary, from left to right. The first piece of
+a word is matched against the entries of vocab without the suffix indicator, and the following pieces against the
+entries that start with it. A word that cannot be fully split, or that has more than max_input_chars_per_word
+characters, becomes a single unk_token.
+The token id of an entry is its index in vocab. If cls_token and sep_token are set, their ids are added at the start
+and the end of every row. The rows are padded with pad_token_id to the longest row, or truncated and padded to
+max_length tokens if it is positive.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    WordPieceTokenizer, 1,
+    OpSchema()
+        .SetDoc(WordPieceTokenizer_ver1_doc)
+        .Attr("vocab", "Vocabulary entries. The token id of an entry is its index.", AttributeProto::STRINGS)
+        .Attr("unk_token", "Entry of vocab used for unknown words.", AttributeProto::STRING, std::string("[UNK]"))
+        .Attr("suffix_indicator", "Prefix of the entries of vocab that continue a word.", AttributeProto::STRING,
+              std::string("##"))
+        .Attr("cls_token", "Optional entry of vocab added at the start of every row.", AttributeProto::STRING,
+              std::string())
+        .Attr("sep_token", "Optional entry of vocab added at the end of every row.", AttributeProto::STRING,
+              std::string())
+        .Attr("do_lower_case", "Whether ASCII uppercase letters are matched as lowercase.", AttributeProto::INT,
+              static_cast<int64_t>(1))
+        .Attr("max_input_chars_per_word", "Words with more characters become unk_token.", AttributeProto::INT,
+              static_cast<int64_t>(100))
+        .Attr("pad_token_id", "Token id of the padding.", AttributeProto::INT, static_cast<int64_t>(0))
+        .Attr("max_length", "If positive, the number of tokens of every row, including cls_token and sep_token.",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Input(0, "X", "Texts to tokenize, of shape [N].", "T")
+        .Output(0, "input_ids", "Token ids, of shape [N, L].", "tensor(int64)")
+        .Output(1, "attention_mask", "1 for the tokens and 0 for the padding, of shape [N, L].", "tensor(int64)",
+                OpSchema::Optional)
+        .Output(2, "offsets", "Begin and end byte offsets of each token in its text, of shape [N, L, 2]. "
+                "They are 0 for cls_token, sep_token and the padding.", "tensor(int64)", OpSchema::Optional)
+        .TypeConstraint("T", {"tensor(string)"}, "Input is a string tensor.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          for (size_t i = 0; i < ctx.getNumOutputs(); ++i) {
+            updateOutputElemType(ctx, i, ONNX_NAMESPACE::TensorProto::INT64);
+          }
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+
+          auto& input_shape = getInputShape(ctx, 0);
+          if (input_shape.dim_size() != 1) {
+            fail_shape_inference("Input X must have shape [N]");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto output_shape;
+          *output_shape.add_dim() = input_shape.dim(0);
+          const int64_t max_length = getAttribute(ctx, "max_length", int64_t(0));
+          if (max_length > 0) {
+            output_shape.add_dim()->set_dim_value(max_length);
+          } else {
+            output_shape.add_dim();
+          }
+          for (size_t i = 0; i < ctx.getNumOutputs() && i < 2; ++i) {
+            updateOutputShape(ctx, i, output_shape);
+          }
+          if (ctx.getNumOutputs() > 2) {
+            output_shape.add_dim()->set_dim_value(2);
+            updateOutputShape(ctx, 2, output_shape);
+          }
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(MatMulInteger16, 1,
                             OpSchema()
                                 .SetDoc(R"DOC(
@@ -746,6 +746,91 @@ MlasSymmQgemmPackB(
     void* PackedB
     );
 
+//
+// Block sparse matrix/matrix multiply routines.
+// C := alpha * A * B, where B is packed in a block sparse row format.
+//
+
+/**
+ * @brief For block sparse single precision GEMM, returns size of the
+ *        packing buffer needed for right hand side. Blocks span BlockK rows
+ *        and 16 columns of matrix B; all-zero blocks are not stored.
+ * @param TransB           Supplies the transpose operation for matrix B
+ * @param N                Number of columns
+ * @param K                Number of rows
+ * @param B                Address of matrix B
+ * @param ldb              Leading dimension of matrix B
+ * @param BlockK           Number of rows of matrix B in a block
+ * @param MinimumSparsity  Minimum fraction of all-zero blocks in matrix B
+ * @return  size of the packing buffer,
+ *          0 if matrix B is not sparse enough or the block shape is not supported
+ */
+size_t
+MLASCALL
+MlasBlockSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockK,
+    float MinimumSparsity
+    );
+
+/**
+ * @brief For block sparse single precision GEMM, pack matrix B into a
+ *        buffer of the size returned by MlasBlockSparseGemmPackBSize
+ * @param TransB   Supplies the transpose operation for matrix B
+ * @param N        Number of columns
+ * @param K        Number of rows
+ * @param B        Address of matrix B
+ * @param ldb      Leading dimension of matrix B
+ * @param BlockK   Number of rows of matrix B in a block
+ * @param PackedB  Address of the packed matrix
+ */
+void
+MLASCALL
+MlasBlockSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockK,
+    void* PackedB
+    );
+
+/**
+ * @brief Single precision matrix/matrix multiply with block sparse packed B
+ *
+ * @param M           Supplies the number of rows of matrix A and matrix C.
+ * @param N           Supplies the number of columns of matrix B and matrix C.
+ * @param K           Supplies the number of columns of matrix A and the number
+                      of rows of matrix B.
+ * @param alpha       Supplies the scalar alpha multiplier.
+ * @param A           Supplies the address of matrix A.
+ * @param lda         Supplies the first dimension of matrix A.
+ * @param PackedB     Supplies the address of matrix B packed by MlasBlockSparseGemmPackB.
+ * @param C           Supplies the address of matrix C.
+ * @param ldc         Supplies the first dimension of matrix C.
+ * @param ThreadPool  Supplies the thread pool object to use, else nullptr if the
+                      base library threading support should be used.
+ */
+void
+MLASCALL
+MlasBlockSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -834,6 +919,29 @@ MlasConvDepthwise(
     size_t KernelSize
     );
 
+/**
+ * @brief Indirect Depthwise convolution for fp32 NHWC
+ * @param Input         Supplies the indirection buffer for the NHWC input
+ * @param Filter        Supplies the filter tensor in [KernelSize, Channels] order
+ * @param Bias          Optionally supplies the bias vector of length Channels
+ * @param Output        Supplies the address for the result tensor
+ * @param Channels      # of input channels
+ * @param OutputCount   # of output pixels
+ * @param KernelSize    # kernel size
+ * @return
+*/
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* const* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
 //
 // Symmetric quantized integer convolution routines.
 //
@@ -977,6 +1085,45 @@ MlasMaximumPool(
     size_t KernelSize
     );
 
+/**
+ * @brief Max Pooling for fp32 NHWC
+ * @param Input         Indirect buffer to activations, nullptr entries are skipped
+ * @param Output        Address of the result tensor
+ * @param Channels      C in NHWC
+ * @param OutputCount   Number of output pixels
+ * @param KernelSize    Size of the kernel
+ * @return
+*/
+void
+MLASCALL
+MlasNhwcMaxPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+/**
+ * @brief Avg Pooling for fp32 NHWC
+ * @param Input         Indirect buffer to activations, nullptr entries are
+ *                      excluded from the average
+ * @param Output        Address of the output data
+ * @param Channels      C in NHWC
+ * @param OutputCount   Number of output pixels
+ * @param KernelSize    size of the kernel
+ * @return
+*/
+void
+MLASCALL
+MlasNhwcAvgPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -1024,6 +1171,91 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Reduction routines.
+//
+
+enum MLAS_REDUCE_KIND {
+    MlasReduceSum,
+    MlasReduceSumSquare,
+    MlasReduceMaximum,
+    MlasReduceMinimum,
+};
+
+float
+MLASCALL
+MlasReduceF32(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N
+    );
+
+/**
+ * @brief Reduce each column of a row major matrix, Output[c] = reduce(Input[r * ldInput + c]) over r.
+ *        This is the shape of a reduction over the outer axes of a tensor.
+ *
+ * @param ReduceKind    kind of reduction
+ * @param Input         input matrix
+ * @param Rows          number of rows to reduce, must not be zero
+ * @param Columns       number of columns
+ * @param ldInput       leading dimension of the input matrix
+ * @param Output        output vector of Columns elements
+ */
+void
+MLASCALL
+MlasReduceColumnsF32(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    float* Output
+    );
+
+float
+MLASCALL
+MlasReduceLogSumExpF32(
+    const float* Input,
+    size_t N
+    );
+
+//
+// Elementwise routines.
+//
+
+enum MLAS_ELTWISE_KIND {
+    MlasEltwiseAdd,
+    MlasEltwiseSub,
+    MlasEltwiseMul,
+    MlasEltwiseDiv,
+    MlasEltwiseMaximum,
+    MlasEltwiseMinimum,
+};
+
+/**
+ * @brief Compute Output[i] = op(InputA[i], InputB[i]) for a binary elementwise operation.
+ *
+ * @param EltwiseKind   kind of elementwise operation
+ * @param InputA        first input vector
+ * @param BroadcastA    true if InputA is a single value broadcast to all N elements
+ * @param InputB        second input vector
+ * @param BroadcastB    true if InputB is a single value broadcast to all N elements,
+ *                      at most one of the inputs may be broadcast
+ * @param Output        output vector, may alias an input that is not broadcast
+ * @param N             number of elements
+ */
+void
+MLASCALL
+MlasEltwiseF32(
+    MLAS_ELTWISE_KIND EltwiseKind,
+    const float* InputA,
+    bool BroadcastA,
+    const float* InputB,
+    bool BroadcastB,
+    float* Output,
+    size_t N
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -1086,6 +1318,64 @@ MlasTranspose(
     size_t N
     );
 
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t M,
+    size_t N
+    );
+
+//
+// Strided variants of the above: the input and output matrices may be
+// submatrices of larger buffers with leading dimensions ldInput and ldOutput.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t ldInput,
+    uint8_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    size_t ldInput,
+    uint16_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t ldInput,
+    uint32_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    size_t ldInput,
+    uint64_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1857,3 +2147,26 @@ MlasFlashAttention(
     MlasFlashAttentionThreadedArgs* args,
     MLAS_THREADPOOL* ThreadPool
 );
+
+/**
+ * @brief Applies rotary position embedding to one row (one head of one token).
+ *        Supported types are float and MLAS_FP16; fp16 is computed in fp32.
+ * @param Input         Address of the row, Dim elements
+ * @param SinData       Address of the sin cache row, Dim / 2 elements
+ * @param CosData       Address of the cos cache row, Dim / 2 elements
+ * @param Dim           Rotary embedding dimension, must be even
+ * @param Interleaved   True if rotated pairs are adjacent (x0, x1), (x2, x3), ...
+ *                      False if they are (x0, x[Dim/2]), (x1, x[Dim/2 + 1]), ...
+ * @param Output        Address of the output row, may alias Input
+ */
+template <typename T>
+void
+MLASCALL
+MlasRotaryEmbedOneRow(
+    const T* Input,
+    const T* SinData,
+    const T* CosData,
+    size_t Dim,
+    bool Interleaved,
+    T* Output
+    );
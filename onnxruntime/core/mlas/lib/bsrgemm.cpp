@@ -0,0 +1,519 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bsrgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation where matrix B is block sparse (pruned weights).
+
+    Matrix B is packed into a block sparse row (BSR) format. The columns of
+    matrix B are split into panels of MLAS_BSR_BLOCK_N columns. Each panel
+    stores only the BlockK x MLAS_BSR_BLOCK_N blocks that contain at least one
+    non-zero value, along with the index of the block along the K dimension.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of matrix B in a block. A block spans four
+// 128-bit vectors so that the kernel can keep a 4x4 tile of accumulators.
+//
+
+constexpr size_t MLAS_BSR_BLOCK_N = 16;
+
+//
+// Define the number of rows of matrix A processed by the inner kernel.
+//
+
+constexpr size_t MLAS_BSR_KERNEL_M = 4;
+
+//
+// Define the number of rows of matrix A assigned to a single work item.
+//
+
+constexpr size_t MLAS_BSR_STRIDE_M = 64;
+
+//
+// Define the alignment of the packed block values.
+//
+
+constexpr size_t MLAS_BSR_VALUES_ALIGNMENT = 64;
+
+//
+// Define the header stored at the start of the packed buffer. The header is
+// followed by the panel offset table, the block row index table and finally
+// the block values.
+//
+
+struct MLAS_BSR_PACKED_HEADER {
+    size_t N;
+    size_t K;
+    size_t BlockK;
+    size_t PanelCount;
+    size_t BlockCount;
+    size_t ValuesOffset;
+};
+
+static
+bool
+MlasBsrIsZeroBlock(
+    const float* B,
+    size_t ldb,
+    bool TransB,
+    size_t k,
+    size_t CountK,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine tests whether all the elements of a block of matrix B are
+    zero.
+
+Arguments:
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    TransB - Supplies true if matrix B is stored transposed (N x K).
+
+    k - Supplies the starting row of the block.
+
+    CountK - Supplies the number of rows of the block.
+
+    n - Supplies the starting column of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    Returns true if every element of the block is zero.
+
+--*/
+{
+    for (size_t kk = 0; kk < CountK; kk++) {
+        for (size_t nn = 0; nn < CountN; nn++) {
+            const float Value = TransB ? B[(n + nn) * ldb + (k + kk)] : B[(k + kk) * ldb + (n + nn)];
+            if (Value != 0.0f) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static
+size_t
+MlasBsrCountNonZeroBlocks(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    bool TransB,
+    size_t BlockK
+    )
+{
+    size_t BlockCount = 0;
+
+    for (size_t n = 0; n < N; n += MLAS_BSR_BLOCK_N) {
+        const size_t CountN = std::min(N - n, MLAS_BSR_BLOCK_N);
+        for (size_t k = 0; k < K; k += BlockK) {
+            const size_t CountK = std::min(K - k, BlockK);
+            if (!MlasBsrIsZeroBlock(B, ldb, TransB, k, CountK, n, CountN)) {
+                BlockCount++;
+            }
+        }
+    }
+
+    return BlockCount;
+}
+
+static
+size_t
+MlasBsrValuesOffset(
+    size_t PanelCount,
+    size_t BlockCount
+    )
+{
+    const size_t IndexBytes = sizeof(MLAS_BSR_PACKED_HEADER) + (PanelCount + 1) * sizeof(uint32_t) +
+                              BlockCount * sizeof(uint32_t);
+
+    return (IndexBytes + MLAS_BSR_VALUES_ALIGNMENT - 1) & ~(MLAS_BSR_VALUES_ALIGNMENT - 1);
+}
+
+size_t
+MLASCALL
+MlasBlockSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockK,
+    float MinimumSparsity
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the block sparse packed
+    representation of matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BlockK - Supplies the number of rows of matrix B in a block.
+
+    MinimumSparsity - Supplies the minimum fraction of all-zero blocks required
+        for the block sparse representation to be worthwhile.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer or zero if the matrix is
+    not sparse enough or the block shape is not supported.
+
+--*/
+{
+    if (N == 0 || K == 0 || BlockK == 0 || BlockK > K) {
+        return 0;
+    }
+
+    //
+    // The block indices are stored as 32-bit values.
+    //
+
+    if (K / BlockK >= std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_BSR_BLOCK_N);
+    const size_t TotalBlocks = PanelCount * MlasDivRoundup(K, BlockK);
+    const size_t BlockCount = MlasBsrCountNonZeroBlocks(N, K, B, ldb, TransB == CblasTrans, BlockK);
+
+    if (BlockCount >= std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const float Sparsity = float(TotalBlocks - BlockCount) / float(TotalBlocks);
+
+    if (Sparsity < MinimumSparsity) {
+        return 0;
+    }
+
+    return MlasBsrValuesOffset(PanelCount, BlockCount) + BlockCount * BlockK * MLAS_BSR_BLOCK_N * sizeof(float);
+}
+
+void
+MLASCALL
+MlasBlockSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockK,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B into the block sparse representation used by
+    MlasBlockSparseGemm. The buffer must be at least the size returned by
+    MlasBlockSparseGemmPackBSize.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BlockK - Supplies the number of rows of matrix B in a block.
+
+    PackedB - Supplies the address of the packed buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool IsTransB = (TransB == CblasTrans);
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_BSR_BLOCK_N);
+    const size_t BlockCount = MlasBsrCountNonZeroBlocks(N, K, B, ldb, IsTransB, BlockK);
+
+    MLAS_BSR_PACKED_HEADER* Header = reinterpret_cast<MLAS_BSR_PACKED_HEADER*>(PackedB);
+    Header->N = N;
+    Header->K = K;
+    Header->BlockK = BlockK;
+    Header->PanelCount = PanelCount;
+    Header->BlockCount = BlockCount;
+    Header->ValuesOffset = MlasBsrValuesOffset(PanelCount, BlockCount);
+
+    uint32_t* PanelStart = reinterpret_cast<uint32_t*>(Header + 1);
+    uint32_t* BlockRow = PanelStart + PanelCount + 1;
+    float* Values = reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(PackedB) + Header->ValuesOffset);
+
+    size_t BlockIndex = 0;
+
+    for (size_t panel = 0; panel < PanelCount; panel++) {
+        const size_t n = panel * MLAS_BSR_BLOCK_N;
+        const size_t CountN = std::min(N - n, MLAS_BSR_BLOCK_N);
+
+        PanelStart[panel] = uint32_t(BlockIndex);
+
+        for (size_t k = 0; k < K; k += BlockK) {
+            const size_t CountK = std::min(K - k, BlockK);
+
+            if (MlasBsrIsZeroBlock(B, ldb, IsTransB, k, CountK, n, CountN)) {
+                continue;
+            }
+
+            BlockRow[BlockIndex] = uint32_t(k / BlockK);
+
+            //
+            // Copy the block as BlockK rows of MLAS_BSR_BLOCK_N values, zero
+            // padding any partial rows or columns.
+            //
+
+            float* BlockValues = Values + BlockIndex * BlockK * MLAS_BSR_BLOCK_N;
+            std::fill_n(BlockValues, BlockK * MLAS_BSR_BLOCK_N, 0.0f);
+
+            for (size_t kk = 0; kk < CountK; kk++) {
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    BlockValues[kk * MLAS_BSR_BLOCK_N + nn] =
+                        IsTransB ? B[(n + nn) * ldb + (k + kk)] : B[(k + kk) * ldb + (n + nn)];
+                }
+            }
+
+            BlockIndex++;
+        }
+    }
+
+    PanelStart[PanelCount] = uint32_t(BlockIndex);
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasBsrGemmKernel(
+    const float* A,
+    size_t lda,
+    const MLAS_BSR_PACKED_HEADER* Header,
+    size_t Panel,
+    float* C,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of a single column panel of matrix C.
+
+Arguments:
+
+    A - Supplies the address of the first row of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    Header - Supplies the packed matrix B.
+
+    Panel - Supplies the index of the column panel to compute.
+
+    C - Supplies the address of the first row of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const uint32_t* PanelStart = reinterpret_cast<const uint32_t*>(Header + 1);
+    const uint32_t* BlockRow = PanelStart + Header->PanelCount + 1;
+    const float* Values = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(Header) + Header->ValuesOffset);
+
+    const size_t K = Header->K;
+    const size_t BlockK = Header->BlockK;
+    const size_t n = Panel * MLAS_BSR_BLOCK_N;
+    const size_t CountN = std::min(Header->N - n, MLAS_BSR_BLOCK_N);
+
+    MLAS_FLOAT32X4 Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < 4; v++) {
+            Accumulators[r][v] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (uint32_t block = PanelStart[Panel]; block < PanelStart[Panel + 1]; block++) {
+        const size_t k = size_t(BlockRow[block]) * BlockK;
+        const size_t CountK = std::min(K - k, BlockK);
+        const float* BlockValues = Values + size_t(block) * BlockK * MLAS_BSR_BLOCK_N;
+
+        for (size_t kk = 0; kk < CountK; kk++) {
+            const MLAS_FLOAT32X4 BElements0 = MlasLoadFloat32x4(BlockValues + 0);
+            const MLAS_FLOAT32X4 BElements1 = MlasLoadFloat32x4(BlockValues + 4);
+            const MLAS_FLOAT32X4 BElements2 = MlasLoadFloat32x4(BlockValues + 8);
+            const MLAS_FLOAT32X4 BElements3 = MlasLoadFloat32x4(BlockValues + 12);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const MLAS_FLOAT32X4 AElement = MlasBroadcastFloat32x4(A + r * lda + k + kk);
+                Accumulators[r][0] = MlasMultiplyAddFloat32x4(AElement, BElements0, Accumulators[r][0]);
+                Accumulators[r][1] = MlasMultiplyAddFloat32x4(AElement, BElements1, Accumulators[r][1]);
+                Accumulators[r][2] = MlasMultiplyAddFloat32x4(AElement, BElements2, Accumulators[r][2]);
+                Accumulators[r][3] = MlasMultiplyAddFloat32x4(AElement, BElements3, Accumulators[r][3]);
+            }
+
+            BlockValues += MLAS_BSR_BLOCK_N;
+        }
+    }
+
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+
+    for (size_t r = 0; r < RowCount; r++) {
+        float* c = C + r * ldc + n;
+
+        if (CountN == MLAS_BSR_BLOCK_N) {
+            for (size_t v = 0; v < 4; v++) {
+                MlasStoreFloat32x4(c + v * 4, MlasMultiplyFloat32x4(Accumulators[r][v], AlphaBroadcast));
+            }
+        } else {
+            MLAS_DECLSPEC_ALIGN(float Row[MLAS_BSR_BLOCK_N], 16);
+            for (size_t v = 0; v < 4; v++) {
+                MlasStoreAlignedFloat32x4(Row + v * 4, MlasMultiplyFloat32x4(Accumulators[r][v], AlphaBroadcast));
+            }
+            std::copy_n(Row, CountN, c);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasBlockSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C := alpha * A * B where matrix B has been packed by
+    MlasBlockSparseGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_BSR_PACKED_HEADER* Header = reinterpret_cast<const MLAS_BSR_PACKED_HEADER*>(PackedB);
+
+    //
+    // The dimensions of matrix B are recorded in the packed buffer.
+    //
+
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0) {
+        return;
+    }
+
+    //
+    // Partition the work into (row stride, column panel) items. Column panels
+    // are the minor dimension so that consecutive items share rows of A.
+    //
+
+    const size_t PanelCount = Header->PanelCount;
+    const size_t StrideCountM = MlasDivRoundup(M, MLAS_BSR_STRIDE_M);
+    const size_t WorkItems = StrideCountM * PanelCount;
+
+    const ptrdiff_t ThreadCount = std::min<ptrdiff_t>(MlasGetMaximumThreadCount(ThreadPool), ptrdiff_t(WorkItems));
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+        size_t WorkIndex;
+        size_t WorkRemaining;
+        MlasPartitionWork(tid, ThreadCount, WorkItems, &WorkIndex, &WorkRemaining);
+
+        for (; WorkRemaining > 0; WorkIndex++, WorkRemaining--) {
+            const size_t Panel = WorkIndex % PanelCount;
+            const size_t StartM = (WorkIndex / PanelCount) * MLAS_BSR_STRIDE_M;
+            const size_t EndM = std::min(M, StartM + MLAS_BSR_STRIDE_M);
+
+            size_t m = StartM;
+
+            for (; m + MLAS_BSR_KERNEL_M <= EndM; m += MLAS_BSR_KERNEL_M) {
+                MlasBsrGemmKernel<MLAS_BSR_KERNEL_M>(A + m * lda, lda, Header, Panel, C + m * ldc, ldc, alpha);
+            }
+
+            for (; m < EndM; m++) {
+                MlasBsrGemmKernel<1>(A + m * lda, lda, Header, Panel, C + m * ldc, ldc, alpha);
+            }
+        }
+    });
+}
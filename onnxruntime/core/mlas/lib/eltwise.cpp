@@ -0,0 +1,256 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    eltwise.cpp
+
+Abstract:
+
+    This module implements routines to compute binary elementwise operations
+    on single precision vectors, where either operand may be broadcast from a
+    single value.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the operators for the supported elementwise operations.
+//
+
+struct MLAS_ELTWISE_ADD_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return Value1 + Value2;
+    }
+};
+
+struct MLAS_ELTWISE_SUB_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasSubtractFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return Value1 - Value2;
+    }
+};
+
+struct MLAS_ELTWISE_MUL_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMultiplyFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return Value1 * Value2;
+    }
+};
+
+struct MLAS_ELTWISE_DIV_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasDivideFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return Value1 / Value2;
+    }
+};
+
+struct MLAS_ELTWISE_MAXIMUM_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return std::max(Value1, Value2);
+    }
+};
+
+struct MLAS_ELTWISE_MINIMUM_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Apply(float Value1, float Value2)
+    {
+        return std::min(Value1, Value2);
+    }
+};
+
+template<typename EltwiseOperator, bool BroadcastA, bool BroadcastB>
+void
+MlasEltwiseKernel(
+    const float* InputA,
+    const float* InputB,
+    float* Output,
+    size_t N
+    )
+{
+    const MLAS_FLOAT32X4 ScalarA = BroadcastA ? MlasBroadcastFloat32x4(InputA) : MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 ScalarB = BroadcastB ? MlasBroadcastFloat32x4(InputB) : MlasZeroFloat32x4();
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 VectorA0 = BroadcastA ? ScalarA : MlasLoadFloat32x4(InputA);
+        MLAS_FLOAT32X4 VectorA1 = BroadcastA ? ScalarA : MlasLoadFloat32x4(InputA + 4);
+        MLAS_FLOAT32X4 VectorB0 = BroadcastB ? ScalarB : MlasLoadFloat32x4(InputB);
+        MLAS_FLOAT32X4 VectorB1 = BroadcastB ? ScalarB : MlasLoadFloat32x4(InputB + 4);
+
+        MlasStoreFloat32x4(Output, EltwiseOperator::Apply(VectorA0, VectorB0));
+        MlasStoreFloat32x4(Output + 4, EltwiseOperator::Apply(VectorA1, VectorB1));
+
+        if (!BroadcastA) {
+            InputA += 8;
+        }
+        if (!BroadcastB) {
+            InputB += 8;
+        }
+        Output += 8;
+        N -= 8;
+    }
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 VectorA = BroadcastA ? ScalarA : MlasLoadFloat32x4(InputA);
+        MLAS_FLOAT32X4 VectorB = BroadcastB ? ScalarB : MlasLoadFloat32x4(InputB);
+
+        MlasStoreFloat32x4(Output, EltwiseOperator::Apply(VectorA, VectorB));
+
+        if (!BroadcastA) {
+            InputA += 4;
+        }
+        if (!BroadcastB) {
+            InputB += 4;
+        }
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = EltwiseOperator::Apply(*InputA, *InputB);
+
+        if (!BroadcastA) {
+            InputA += 1;
+        }
+        if (!BroadcastB) {
+            InputB += 1;
+        }
+        N -= 1;
+    }
+}
+
+template<typename EltwiseOperator>
+void
+MlasEltwiseKernel(
+    const float* InputA,
+    bool BroadcastA,
+    const float* InputB,
+    bool BroadcastB,
+    float* Output,
+    size_t N
+    )
+{
+    if (BroadcastA) {
+        MlasEltwiseKernel<EltwiseOperator, true, false>(InputA, InputB, Output, N);
+    } else if (BroadcastB) {
+        MlasEltwiseKernel<EltwiseOperator, false, true>(InputA, InputB, Output, N);
+    } else {
+        MlasEltwiseKernel<EltwiseOperator, false, false>(InputA, InputB, Output, N);
+    }
+}
+
+void
+MLASCALL
+MlasEltwiseF32(
+    MLAS_ELTWISE_KIND EltwiseKind,
+    const float* InputA,
+    bool BroadcastA,
+    const float* InputB,
+    bool BroadcastB,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output[i] = op(InputA[i], InputB[i]) for a binary
+    elementwise operation.
+
+Arguments:
+
+    EltwiseKind - Supplies the kind of elementwise operation.
+
+    InputA - Supplies the first input vector.
+
+    BroadcastA - Supplies true if the first input is a single value that is
+        broadcast to all N elements.
+
+    InputB - Supplies the second input vector.
+
+    BroadcastB - Supplies true if the second input is a single value that is
+        broadcast to all N elements. At most one of the inputs may be
+        broadcast.
+
+    Output - Supplies the output vector. This may alias either input vector
+        that is not broadcast.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (EltwiseKind) {
+
+        case MlasEltwiseAdd:
+            MlasEltwiseKernel<MLAS_ELTWISE_ADD_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+
+        case MlasEltwiseSub:
+            MlasEltwiseKernel<MLAS_ELTWISE_SUB_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+
+        case MlasEltwiseMul:
+            MlasEltwiseKernel<MLAS_ELTWISE_MUL_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+
+        case MlasEltwiseDiv:
+            MlasEltwiseKernel<MLAS_ELTWISE_DIV_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+
+        case MlasEltwiseMaximum:
+            MlasEltwiseKernel<MLAS_ELTWISE_MAXIMUM_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+
+        case MlasEltwiseMinimum:
+            MlasEltwiseKernel<MLAS_ELTWISE_MINIMUM_OPERATOR>(InputA, BroadcastA, InputB, BroadcastB, Output, N);
+            break;
+    }
+}
@@ -1701,3 +1701,195 @@ MlasMaximumPool<uint8_t>(
     size_t OutputCount,
     size_t KernelSize
     );
+
+template<MLAS_POOLING_KIND PoolingKind>
+void
+MlasNhwcPoolFloat(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision floating point pooling
+    operation for tensors in channels last format.
+
+    The input is supplied as an indirection buffer. Every pointer in the
+    indirection buffer points at a Channels length vector from the input
+    tensor, a vector of padding values that takes part in the pooling, or is
+    nullptr for padding that is excluded from the pooling. These are grouped in
+    batches of length KernelSize that are processed by the kernel to produce a
+    single output of length Channels. These batches are then repeated
+    OutputCount times.
+
+Arguments:
+
+    Input - Supplies an indirection buffer to the elements of the input tensor.
+
+    Output - Supplies the output tensor in channels last format.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of channel sized output elements to
+        produce.
+
+    KernelSize - Supplies the total number of channel sized kernel elements to
+        consume.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr bool IsMaximumPooling = (PoolingKind == MlasMaximumPooling);
+    const float InitialValue = IsMaximumPooling ? std::numeric_limits<float>::lowest() : 0.0f;
+
+    while (OutputCount > 0) {
+
+        //
+        // Count the kernel elements that take part in the pooling.
+        //
+
+        size_t ElementCount = 0;
+
+        for (size_t k = 0; k < KernelSize; k++) {
+            if (Input[k] != nullptr) {
+                ElementCount++;
+            }
+        }
+
+        const float Scale = (ElementCount > 0) ? 1.0f / float(ElementCount) : 0.0f;
+        const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+        const MLAS_FLOAT32X4 InitialVector = MlasBroadcastFloat32x4(InitialValue);
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+        while (c >= 8) {
+
+            MLAS_FLOAT32X4 Accumulator0 = InitialVector;
+            MLAS_FLOAT32X4 Accumulator1 = InitialVector;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                if (Input[k] == nullptr) {
+                    continue;
+                }
+
+                MLAS_FLOAT32X4 InputVector0 = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+                MLAS_FLOAT32X4 InputVector1 = MlasLoadFloat32x4(&Input[k][ChannelOffset + 4]);
+
+                if constexpr (IsMaximumPooling) {
+                    Accumulator0 = MlasMaximumFloat32x4(Accumulator0, InputVector0);
+                    Accumulator1 = MlasMaximumFloat32x4(Accumulator1, InputVector1);
+                } else {
+                    Accumulator0 = MlasAddFloat32x4(Accumulator0, InputVector0);
+                    Accumulator1 = MlasAddFloat32x4(Accumulator1, InputVector1);
+                }
+            }
+
+            if constexpr (!IsMaximumPooling) {
+                Accumulator0 = MlasMultiplyFloat32x4(Accumulator0, ScaleVector);
+                Accumulator1 = MlasMultiplyFloat32x4(Accumulator1, ScaleVector);
+            }
+
+            MlasStoreFloat32x4(&Output[0], Accumulator0);
+            MlasStoreFloat32x4(&Output[4], Accumulator1);
+            Output += 8;
+
+            ChannelOffset += 8;
+            c -= 8;
+        }
+
+        if (c >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = InitialVector;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                if (Input[k] == nullptr) {
+                    continue;
+                }
+
+                MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+
+                if constexpr (IsMaximumPooling) {
+                    Accumulator = MlasMaximumFloat32x4(Accumulator, InputVector);
+                } else {
+                    Accumulator = MlasAddFloat32x4(Accumulator, InputVector);
+                }
+            }
+
+            if constexpr (!IsMaximumPooling) {
+                Accumulator = MlasMultiplyFloat32x4(Accumulator, ScaleVector);
+            }
+
+            MlasStoreFloat32x4(&Output[0], Accumulator);
+            Output += 4;
+
+            ChannelOffset += 4;
+            c -= 4;
+        }
+
+        while (c > 0) {
+
+            float Accumulator = InitialValue;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                if (Input[k] == nullptr) {
+                    continue;
+                }
+
+                if constexpr (IsMaximumPooling) {
+                    Accumulator = std::max(Accumulator, Input[k][ChannelOffset]);
+                } else {
+                    Accumulator += Input[k][ChannelOffset];
+                }
+            }
+
+            if constexpr (!IsMaximumPooling) {
+                Accumulator *= Scale;
+            }
+
+            *Output++ = Accumulator;
+
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasNhwcMaxPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+{
+    MlasNhwcPoolFloat<MlasMaximumPooling>(Input, Output, Channels, OutputCount, KernelSize);
+}
+
+void
+MLASCALL
+MlasNhwcAvgPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+{
+    MlasNhwcPoolFloat<MlasAveragePoolingExcludePad>(Input, Output, Channels, OutputCount, KernelSize);
+}
@@ -0,0 +1,483 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements routines to reduce a vector or the columns of a
+    matrix to a single value per vector or column.
+
+    The column reduction keeps a block of columns in registers across all of
+    the rows so that the output is only written once, instead of being read
+    and written back for every reduced row.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the operators for the supported reductions. Accumulate folds a new
+// element into an accumulator, Combine merges two accumulators.
+//
+
+struct MLAS_REDUCE_SUM_OPERATOR {
+
+    static constexpr float Identity = 0.0f;
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasAddFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FORCEINLINE float Accumulate(float Accumulator, float Value)
+    {
+        return Accumulator + Value;
+    }
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Reduce(MLAS_FLOAT32X4 Vector)
+    {
+        return MlasReduceAddFloat32x4(Vector);
+    }
+};
+
+struct MLAS_REDUCE_SUM_SQUARE_OPERATOR : MLAS_REDUCE_SUM_OPERATOR {
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMultiplyAddFloat32x4(Vector, Vector, Accumulator);
+    }
+
+    static MLAS_FORCEINLINE float Accumulate(float Accumulator, float Value)
+    {
+        return Accumulator + Value * Value;
+    }
+};
+
+struct MLAS_REDUCE_MAXIMUM_OPERATOR {
+
+    static constexpr float Identity = -std::numeric_limits<float>::infinity();
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMaximumFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FORCEINLINE float Accumulate(float Accumulator, float Value)
+    {
+        return std::max(Accumulator, Value);
+    }
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Reduce(MLAS_FLOAT32X4 Vector)
+    {
+        return MlasReduceMaximumFloat32x4(Vector);
+    }
+};
+
+struct MLAS_REDUCE_MINIMUM_OPERATOR {
+
+    static constexpr float Identity = std::numeric_limits<float>::infinity();
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMinimumFloat32x4(Accumulator, Vector);
+    }
+
+    static MLAS_FORCEINLINE float Accumulate(float Accumulator, float Value)
+    {
+        return std::min(Accumulator, Value);
+    }
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Reduce(MLAS_FLOAT32X4 Vector)
+    {
+        return MlasReduceMinimumFloat32x4(Vector);
+    }
+};
+
+//
+// The maximum of the finite values, which turns into NaN as soon as one of the
+// values is infinite or NaN: for a finite value, Value - Value is an exact
+// zero, else it is NaN and the sum propagates it. The accumulators are added
+// to themselves as well, because the maximum instructions do not propagate a
+// NaN operand on every platform.
+//
+
+struct MLAS_REDUCE_FINITE_MAXIMUM_OPERATOR {
+
+    static constexpr float Identity = std::numeric_limits<float>::lowest();
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        MLAS_FLOAT32X4 NonFinite = MlasAddFloat32x4(MlasSubtractFloat32x4(Accumulator, Accumulator),
+                                                    MlasSubtractFloat32x4(Vector, Vector));
+        return MlasAddFloat32x4(MlasMaximumFloat32x4(Accumulator, Vector), NonFinite);
+    }
+
+    static MLAS_FORCEINLINE float Accumulate(float Accumulator, float Value)
+    {
+        return std::max(Accumulator, Value) + ((Accumulator - Accumulator) + (Value - Value));
+    }
+
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return Accumulate(Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float Reduce(MLAS_FLOAT32X4 Vector)
+    {
+        return MlasReduceMaximumFloat32x4(Vector) + MlasReduceAddFloat32x4(MlasSubtractFloat32x4(Vector, Vector));
+    }
+};
+
+template<typename ReduceOperator>
+float
+MlasReduceF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the supplied vector to a single value.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulator0 = MlasBroadcastFloat32x4(ReduceOperator::Identity);
+    MLAS_FLOAT32X4 Accumulator1 = Accumulator0;
+    MLAS_FLOAT32X4 Accumulator2 = Accumulator0;
+    MLAS_FLOAT32X4 Accumulator3 = Accumulator0;
+
+    while (N >= 16) {
+
+        Accumulator0 = ReduceOperator::Accumulate(Accumulator0, MlasLoadFloat32x4(Input));
+        Accumulator1 = ReduceOperator::Accumulate(Accumulator1, MlasLoadFloat32x4(Input + 4));
+        Accumulator2 = ReduceOperator::Accumulate(Accumulator2, MlasLoadFloat32x4(Input + 8));
+        Accumulator3 = ReduceOperator::Accumulate(Accumulator3, MlasLoadFloat32x4(Input + 12));
+
+        Input += 16;
+        N -= 16;
+    }
+
+    while (N >= 4) {
+
+        Accumulator0 = ReduceOperator::Accumulate(Accumulator0, MlasLoadFloat32x4(Input));
+
+        Input += 4;
+        N -= 4;
+    }
+
+    Accumulator0 = ReduceOperator::Combine(Accumulator0, Accumulator1);
+    Accumulator2 = ReduceOperator::Combine(Accumulator2, Accumulator3);
+    Accumulator0 = ReduceOperator::Combine(Accumulator0, Accumulator2);
+
+    float Value = ReduceOperator::Reduce(Accumulator0);
+
+    while (N > 0) {
+
+        Value = ReduceOperator::Accumulate(Value, *Input++);
+        N -= 1;
+    }
+
+    return Value;
+}
+
+template<typename ReduceOperator>
+void
+MlasReduceColumnsF32Kernel(
+    const float* Input,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces each column of the supplied matrix to a single value.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Rows - Supplies the number of rows to reduce.
+
+    Columns - Supplies the number of columns of the matrix.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output vector of Columns elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Columns >= 16) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasBroadcastFloat32x4(ReduceOperator::Identity);
+        MLAS_FLOAT32X4 Accumulator1 = Accumulator0;
+        MLAS_FLOAT32X4 Accumulator2 = Accumulator0;
+        MLAS_FLOAT32X4 Accumulator3 = Accumulator0;
+
+        const float* input = Input;
+
+        for (size_t r = 0; r < Rows; r++) {
+
+            Accumulator0 = ReduceOperator::Accumulate(Accumulator0, MlasLoadFloat32x4(input));
+            Accumulator1 = ReduceOperator::Accumulate(Accumulator1, MlasLoadFloat32x4(input + 4));
+            Accumulator2 = ReduceOperator::Accumulate(Accumulator2, MlasLoadFloat32x4(input + 8));
+            Accumulator3 = ReduceOperator::Accumulate(Accumulator3, MlasLoadFloat32x4(input + 12));
+
+            input += ldInput;
+        }
+
+        MlasStoreFloat32x4(Output, Accumulator0);
+        MlasStoreFloat32x4(Output + 4, Accumulator1);
+        MlasStoreFloat32x4(Output + 8, Accumulator2);
+        MlasStoreFloat32x4(Output + 12, Accumulator3);
+
+        Input += 16;
+        Output += 16;
+        Columns -= 16;
+    }
+
+    while (Columns >= 4) {
+
+        MLAS_FLOAT32X4 Accumulator = MlasBroadcastFloat32x4(ReduceOperator::Identity);
+
+        const float* input = Input;
+
+        for (size_t r = 0; r < Rows; r++) {
+            Accumulator = ReduceOperator::Accumulate(Accumulator, MlasLoadFloat32x4(input));
+            input += ldInput;
+        }
+
+        MlasStoreFloat32x4(Output, Accumulator);
+
+        Input += 4;
+        Output += 4;
+        Columns -= 4;
+    }
+
+    while (Columns > 0) {
+
+        float Value = ReduceOperator::Identity;
+
+        const float* input = Input;
+
+        for (size_t r = 0; r < Rows; r++) {
+            Value = ReduceOperator::Accumulate(Value, *input);
+            input += ldInput;
+        }
+
+        *Output++ = Value;
+
+        Input += 1;
+        Columns -= 1;
+    }
+}
+
+float
+MLASCALL
+MlasReduceF32(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the supplied vector to a single value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    switch (ReduceKind) {
+
+        case MlasReduceSum:
+            return MlasReduceF32Kernel<MLAS_REDUCE_SUM_OPERATOR>(Input, N);
+
+        case MlasReduceSumSquare:
+            return MlasReduceF32Kernel<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, N);
+
+        case MlasReduceMaximum:
+            return MlasReduceF32Kernel<MLAS_REDUCE_MAXIMUM_OPERATOR>(Input, N);
+
+        case MlasReduceMinimum:
+            return MlasReduceF32Kernel<MLAS_REDUCE_MINIMUM_OPERATOR>(Input, N);
+    }
+
+    MLAS_THROW_EX(std::invalid_argument, "Unsupported reduce kind");
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces each column of the supplied matrix to a single value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix.
+
+    Rows - Supplies the number of rows to reduce.
+
+    Columns - Supplies the number of columns of the matrix.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output vector of Columns elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (ReduceKind) {
+
+        case MlasReduceSum:
+            MlasReduceColumnsF32Kernel<MLAS_REDUCE_SUM_OPERATOR>(Input, Rows, Columns, ldInput, Output);
+            return;
+
+        case MlasReduceSumSquare:
+            MlasReduceColumnsF32Kernel<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, Rows, Columns, ldInput, Output);
+            return;
+
+        case MlasReduceMaximum:
+            MlasReduceColumnsF32Kernel<MLAS_REDUCE_MAXIMUM_OPERATOR>(Input, Rows, Columns, ldInput, Output);
+            return;
+
+        case MlasReduceMinimum:
+            MlasReduceColumnsF32Kernel<MLAS_REDUCE_MINIMUM_OPERATOR>(Input, Rows, Columns, ldInput, Output);
+            return;
+    }
+
+    MLAS_THROW_EX(std::invalid_argument, "Unsupported reduce kind");
+}
+
+float
+MLASCALL
+MlasReduceLogSumExpF32(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes log(sum(exp(Input))) of the supplied vector. The
+    maximum value is subtracted before the exponential function to avoid
+    overflow. Infinite and NaN values give the same result as the direct
+    formula: +inf if a value is +inf, -inf if all values are -inf, and NaN
+    if a value is NaN.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the log of the sum of the exponential functions.
+
+--*/
+{
+    float Maximum = MlasReduceF32Kernel<MLAS_REDUCE_FINITE_MAXIMUM_OPERATOR>(Input, N);
+
+    if (std::isnan(Maximum)) {
+
+        //
+        // Some values are infinite or NaN. The exponential kernels clamp their
+        // input, so these values are handled here: the maximum is taken over
+        // the finite values only, then +inf yields +inf, -inf contributes
+        // zero and NaN propagates.
+        //
+
+        Maximum = 0.0f;
+        bool HasFinite = false;
+
+        for (size_t i = 0; i < N; i++) {
+            if (std::isfinite(Input[i]) && (!HasFinite || Input[i] > Maximum)) {
+                Maximum = Input[i];
+                HasFinite = true;
+            }
+        }
+
+        float Accumulation = 0.0f;
+
+        for (size_t i = 0; i < N; i++) {
+            Accumulation += std::exp(Input[i] - Maximum);
+        }
+
+        return std::log(Accumulation) + Maximum;
+    }
+
+    float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+    float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#else
+    float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#endif
+
+    return std::log(Accumulation) + Maximum;
+}
@@ -0,0 +1,251 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    rotary_embedding.cpp
+
+Abstract:
+
+    This module implements rotary position embedding (RoPE) for one row of
+    a query or key tensor.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasSwapPairsFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vrev64q_f32(Vector);
+#else
+    return MlasShuffleFloat32x4<1, 0, 3, 2>(Vector);
+#endif
+}
+
+static
+void
+MlasRotaryEmbedOneRowF32(
+    const float* Input,
+    const float* SinData,
+    const float* CosData,
+    size_t Dim,
+    bool Interleaved,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine applies rotary position embedding to one row of Dim
+    elements. Each pair (x, y) of the row is rotated by the angle whose cosine
+    and sine are supplied by the cache:
+
+        x' = x * cos - y * sin
+        y' = y * cos + x * sin
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    SinData - Supplies the sin cache row of Dim / 2 elements.
+
+    CosData - Supplies the cos cache row of Dim / 2 elements.
+
+    Dim - Supplies the rotary embedding dimension.
+
+    Interleaved - Supplies true if the elements of a pair are adjacent, else
+        the pairs are formed from the first and second halves of the row.
+
+    Output - Supplies the output row. This may alias the input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t HalfDim = Dim / 2;
+    size_t i = 0;
+
+    if (Interleaved) {
+
+        //
+        // Rotate four pairs at a time. The cache vectors are duplicated to line
+        // up with the pairs and the sine takes a negative sign on the first
+        // element of each pair.
+        //
+
+        const MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(-0.0f);
+        const MLAS_FLOAT32X4 PairSignMask = MlasInterleaveLowFloat32x4(SignMask, MlasZeroFloat32x4());
+
+        for (; i + 4 <= HalfDim; i += 4) {
+
+            MLAS_FLOAT32X4 Cos = MlasLoadFloat32x4(CosData + i);
+            MLAS_FLOAT32X4 Sin = MlasLoadFloat32x4(SinData + i);
+
+            MLAS_FLOAT32X4 CosLow = MlasInterleaveLowFloat32x4(Cos, Cos);
+            MLAS_FLOAT32X4 CosHigh = MlasInterleaveHighFloat32x4(Cos, Cos);
+            MLAS_FLOAT32X4 SinLow = MlasXorFloat32x4(MlasInterleaveLowFloat32x4(Sin, Sin), PairSignMask);
+            MLAS_FLOAT32X4 SinHigh = MlasXorFloat32x4(MlasInterleaveHighFloat32x4(Sin, Sin), PairSignMask);
+
+            MLAS_FLOAT32X4 Low = MlasLoadFloat32x4(Input + 2 * i);
+            MLAS_FLOAT32X4 High = MlasLoadFloat32x4(Input + 2 * i + 4);
+
+            Low = MlasMultiplyAddFloat32x4(MlasSwapPairsFloat32x4(Low), SinLow, MlasMultiplyFloat32x4(Low, CosLow));
+            High = MlasMultiplyAddFloat32x4(MlasSwapPairsFloat32x4(High), SinHigh, MlasMultiplyFloat32x4(High, CosHigh));
+
+            MlasStoreFloat32x4(Output + 2 * i, Low);
+            MlasStoreFloat32x4(Output + 2 * i + 4, High);
+        }
+
+        for (; i < HalfDim; i++) {
+
+            float x = Input[2 * i];
+            float y = Input[2 * i + 1];
+
+            Output[2 * i] = x * CosData[i] - y * SinData[i];
+            Output[2 * i + 1] = y * CosData[i] + x * SinData[i];
+        }
+
+    } else {
+
+        const float* InputHigh = Input + HalfDim;
+        float* OutputHigh = Output + HalfDim;
+
+        for (; i + 4 <= HalfDim; i += 4) {
+
+            MLAS_FLOAT32X4 Cos = MlasLoadFloat32x4(CosData + i);
+            MLAS_FLOAT32X4 Sin = MlasLoadFloat32x4(SinData + i);
+            MLAS_FLOAT32X4 x = MlasLoadFloat32x4(Input + i);
+            MLAS_FLOAT32X4 y = MlasLoadFloat32x4(InputHigh + i);
+
+            MlasStoreFloat32x4(Output + i, MlasSubtractFloat32x4(MlasMultiplyFloat32x4(x, Cos),
+                                                                 MlasMultiplyFloat32x4(y, Sin)));
+            MlasStoreFloat32x4(OutputHigh + i, MlasMultiplyAddFloat32x4(x, Sin, MlasMultiplyFloat32x4(y, Cos)));
+        }
+
+        for (; i < HalfDim; i++) {
+
+            float x = Input[i];
+            float y = InputHigh[i];
+
+            Output[i] = x * CosData[i] - y * SinData[i];
+            OutputHigh[i] = y * CosData[i] + x * SinData[i];
+        }
+    }
+}
+
+static
+void
+MlasRotaryEmbedOneRowF16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* SinData,
+    const MLAS_FP16* CosData,
+    size_t Dim,
+    bool Interleaved,
+    MLAS_FP16* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine applies rotary position embedding to one row of half
+    precision elements. Blocks of pairs are widened to single precision,
+    rotated by the single precision kernel and narrowed again.
+
+Arguments:
+
+    See MlasRotaryEmbedOneRowF32.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockPairs = 32;
+
+    float InputBuffer[BlockPairs * 2];
+    float OutputBuffer[BlockPairs * 2];
+    float SinBuffer[BlockPairs];
+    float CosBuffer[BlockPairs];
+
+    const size_t HalfDim = Dim / 2;
+
+    for (size_t i = 0; i < HalfDim; i += BlockPairs) {
+
+        const size_t Pairs = std::min(BlockPairs, HalfDim - i);
+
+        for (size_t j = 0; j < Pairs; j++) {
+            SinBuffer[j] = SinData[i + j].ToFloat();
+            CosBuffer[j] = CosData[i + j].ToFloat();
+        }
+
+        //
+        // Both layouts are gathered so the block is a contiguous row of the
+        // same layout: interleaved pairs, or the two halves back to back.
+        //
+
+        if (Interleaved) {
+            for (size_t j = 0; j < Pairs * 2; j++) {
+                InputBuffer[j] = Input[2 * i + j].ToFloat();
+            }
+        } else {
+            for (size_t j = 0; j < Pairs; j++) {
+                InputBuffer[j] = Input[i + j].ToFloat();
+                InputBuffer[Pairs + j] = Input[HalfDim + i + j].ToFloat();
+            }
+        }
+
+        MlasRotaryEmbedOneRowF32(InputBuffer, SinBuffer, CosBuffer, Pairs * 2, Interleaved, OutputBuffer);
+
+        if (Interleaved) {
+            for (size_t j = 0; j < Pairs * 2; j++) {
+                Output[2 * i + j] = MLAS_FP16(OutputBuffer[j]);
+            }
+        } else {
+            for (size_t j = 0; j < Pairs; j++) {
+                Output[i + j] = MLAS_FP16(OutputBuffer[j]);
+                Output[HalfDim + i + j] = MLAS_FP16(OutputBuffer[Pairs + j]);
+            }
+        }
+    }
+}
+
+template <>
+void
+MLASCALL
+MlasRotaryEmbedOneRow<float>(
+    const float* Input,
+    const float* SinData,
+    const float* CosData,
+    size_t Dim,
+    bool Interleaved,
+    float* Output
+    )
+{
+    MlasRotaryEmbedOneRowF32(Input, SinData, CosData, Dim, Interleaved, Output);
+}
+
+template <>
+void
+MLASCALL
+MlasRotaryEmbedOneRow<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* SinData,
+    const MLAS_FP16* CosData,
+    size_t Dim,
+    bool Interleaved,
+    MLAS_FP16* Output
+    )
+{
+    MlasRotaryEmbedOneRowF16(Input, SinData, CosData, Dim, Interleaved, Output);
+}
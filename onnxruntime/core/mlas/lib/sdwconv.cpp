@@ -0,0 +1,153 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sdwconv.cpp
+
+Abstract:
+
+    This module implements the single precision floating point depthwise
+    convolution routines for tensors in channels last format.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* const* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the depthwise convolution operation for tensors in
+    channels last format.
+
+    The input is supplied as an indirection buffer. Every pointer in the
+    indirection buffer points at a Channels length vector (either from the
+    input tensor or a vector of zero padding values). These are grouped in
+    batches of length KernelSize that are processed by the kernel to produce a
+    single output of length Channels. These batches are then repeated
+    OutputCount times.
+
+Arguments:
+
+    Input - Supplies an indirection buffer to the elements of the input tensor.
+
+    Filter - Supplies the filter tensor in [KernelSize, Channels] order.
+
+    Bias - Optionally supplies the bias vector of length Channels.
+
+    Output - Supplies the output tensor in channels last format.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of channel sized output elements to
+        produce.
+
+    KernelSize - Supplies the total number of channel sized kernel elements to
+        consume.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (OutputCount > 0) {
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+        while (c >= 8) {
+
+            MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+            MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+            if (Bias != nullptr) {
+                Accumulator0 = MlasLoadFloat32x4(&Bias[ChannelOffset]);
+                Accumulator1 = MlasLoadFloat32x4(&Bias[ChannelOffset + 4]);
+            }
+
+            const float* filter = Filter + ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                MLAS_FLOAT32X4 InputVector0 = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+                MLAS_FLOAT32X4 InputVector1 = MlasLoadFloat32x4(&Input[k][ChannelOffset + 4]);
+
+                Accumulator0 = MlasMultiplyAddFloat32x4(InputVector0, MlasLoadFloat32x4(filter), Accumulator0);
+                Accumulator1 = MlasMultiplyAddFloat32x4(InputVector1, MlasLoadFloat32x4(filter + 4), Accumulator1);
+
+                filter += Channels;
+            }
+
+            MlasStoreFloat32x4(&Output[0], Accumulator0);
+            MlasStoreFloat32x4(&Output[4], Accumulator1);
+            Output += 8;
+
+            ChannelOffset += 8;
+            c -= 8;
+        }
+
+        if (c >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+            if (Bias != nullptr) {
+                Accumulator = MlasLoadFloat32x4(&Bias[ChannelOffset]);
+            }
+
+            const float* filter = Filter + ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+
+                Accumulator = MlasMultiplyAddFloat32x4(InputVector, MlasLoadFloat32x4(filter), Accumulator);
+
+                filter += Channels;
+            }
+
+            MlasStoreFloat32x4(&Output[0], Accumulator);
+            Output += 4;
+
+            ChannelOffset += 4;
+            c -= 4;
+        }
+
+        while (c > 0) {
+
+            float Accumulator = (Bias != nullptr) ? Bias[ChannelOffset] : 0.0f;
+
+            const float* filter = Filter + ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                Accumulator += Input[k][ChannelOffset] * filter[0];
+
+                filter += Channels;
+            }
+
+            *Output++ = Accumulator;
+
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
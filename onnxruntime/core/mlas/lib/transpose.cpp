@@ -545,7 +545,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint32_t* Input,
+    size_t ldInput,
     uint32_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -554,14 +556,20 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns). Either matrix may be a submatrix of a
+    larger buffer, which allows a caller to tile a large or N-dimensional
+    transpose into cache sized blocks.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the first dimension of the input buffer.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the first dimension of the output buffer.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -592,9 +600,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, ldInput, d, ldOutput);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -603,15 +611,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += ldOutput * 4;
         n -= 4;
     }
 
@@ -628,9 +636,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, ldInput, d, 1);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -639,17 +647,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -671,7 +691,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint16_t* Input,
+    size_t ldInput,
     uint16_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -680,14 +702,20 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns). Either matrix may be a submatrix of a
+    larger buffer, which allows a caller to tile a large or N-dimensional
+    transpose into cache sized blocks.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the first dimension of the input buffer.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the first dimension of the output buffer.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -717,9 +745,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, ldInput, d, ldOutput);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -728,15 +756,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += ldOutput * 4;
         n -= 4;
     }
 
@@ -753,9 +781,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, ldInput, d, 1);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -764,23 +792,37 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 
 void
 MLASCALL
 MlasTranspose(
     const uint8_t* Input,
+    size_t ldInput,
     uint8_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -789,14 +831,20 @@ MlasTranspose(
 Routine Description:
 
     This routine transposes the input matrix (M rows by N columns) to the
-    output matrix (N rows by M columns).
+    output matrix (N rows by M columns). Either matrix may be a submatrix of a
+    larger buffer, which allows a caller to tile a large or N-dimensional
+    transpose into cache sized blocks.
 
 Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the first dimension of the input buffer.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the first dimension of the output buffer.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -823,24 +871,24 @@ Return Value:
         size_t m = M;
         while (m >= 16) {
 
-            MlasTranspose16x16Block(s, N, d, M);
+            MlasTranspose16x16Block(s, ldInput, d, ldOutput);
 
-            s += N * 16;
+            s += ldInput * 16;
             d += 16;
             m -= 16;
         }
 
         while (m > 0) {
 
-            MlasTranspose16xNVector(s, 1, d, M);
+            MlasTranspose16xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 16;
-        Output += M * 16;
+        Output += ldOutput * 16;
         n -= 16;
     }
 #endif
@@ -854,9 +902,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8x8Block(s, N, d, M);
+            MlasTranspose8x8Block(s, ldInput, d, ldOutput);
 
-            s += N * 8;
+            s += ldInput * 8;
             d += 8;
             m -= 8;
         }
@@ -865,15 +913,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose8xNVector(s, 1, d, M);
+            MlasTranspose8xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 8;
-        Output += M * 8;
+        Output += ldOutput * 8;
         n -= 8;
     }
 
@@ -890,9 +938,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8xNVector(s, N, d, 1);
+            MlasTranspose8xNVector(s, ldInput, d, 1);
 
-            s += N * 8;
+            s += ldInput * 8;
             d += 8;
             m -= 8;
         }
@@ -901,17 +949,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -926,3 +986,171 @@ MlasTranspose(
         M,
         N);
 }
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+MLAS_FORCEINLINE
+void
+MlasTranspose2x2Block(
+    const uint64_t* Input,
+    size_t InputStride,
+    uint64_t* Output,
+    size_t OutputStride
+    )
+{
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 1]);
+
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 0], _mm_unpacklo_epi64(a0, a1));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 1], _mm_unpackhi_epi64(a0, a1));
+}
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+MLAS_FORCEINLINE
+void
+MlasTranspose2x2Block(
+    const uint64_t* Input,
+    size_t InputStride,
+    uint64_t* Output,
+    size_t OutputStride
+    )
+{
+    uint64x2_t a0 = vld1q_u64(&Input[InputStride * 0]);
+    uint64x2_t a1 = vld1q_u64(&Input[InputStride * 1]);
+
+    vst1q_u64(&Output[OutputStride * 0], vzip1q_u64(a0, a1));
+    vst1q_u64(&Output[OutputStride * 1], vzip2q_u64(a0, a1));
+}
+
+#endif
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    size_t ldInput,
+    uint64_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns). Either matrix may be a submatrix of a
+    larger buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    ldInput - Supplies the first dimension of the input buffer.
+
+    Output - Supplies the output buffer.
+
+    ldOutput - Supplies the first dimension of the output buffer.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t n = N;
+
+    //
+    // Transpose elements from the input matrix to the output matrix 4 columns
+    // at a time. The vector path handles each 4x4 block as four 2x2 blocks.
+    //
+
+    while (n >= 4) {
+
+        const uint64_t* s = Input;
+        uint64_t* d = Output;
+        size_t m = M;
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON64_INTRINSICS)
+
+        while (m >= 4) {
+
+            MlasTranspose2x2Block(s, ldInput, d, ldOutput);
+            MlasTranspose2x2Block(s + 2, ldInput, d + ldOutput * 2, ldOutput);
+            MlasTranspose2x2Block(s + ldInput * 2, ldInput, d + 2, ldOutput);
+            MlasTranspose2x2Block(s + ldInput * 2 + 2, ldInput, d + ldOutput * 2 + 2, ldOutput);
+
+            s += ldInput * 4;
+            d += 4;
+            m -= 4;
+        }
+
+#endif
+
+        while (m > 0) {
+
+            MlasTranspose4xNVector(s, 1, d, ldOutput);
+
+            s += ldInput;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += 4;
+        Output += ldOutput * 4;
+        n -= 4;
+    }
+
+    //
+    // Transpose elements from the input matrix to the output matrix for the
+    // remaining columns.
+    //
+
+    while (n > 0) {
+
+        const uint64_t* s = Input;
+        uint64_t* d = Output;
+        size_t m = M;
+
+        while (m >= 4) {
+
+            MlasTranspose4xNVector(s, ldInput, d, 1);
+
+            s += ldInput * 4;
+            d += 4;
+            m -= 4;
+        }
+
+        while (m > 0) {
+
+            d[0] = s[0];
+
+            s += ldInput;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += 1;
+        Output += ldOutput;
+        n -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
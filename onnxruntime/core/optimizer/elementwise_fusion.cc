@@ -0,0 +1,248 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <optional>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsFusableOp(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14})) {
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8, 12, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8, 12, 13})) {
+    return node.InputDefs().size() == 2;
+  }
+
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13});
+}
+
+bool IsSameDim(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  if (utils::HasDimValue(dim) && utils::HasDimValue(other)) {
+    return dim.dim_value() == other.dim_value();
+  }
+  return utils::HasDimParam(dim) && utils::HasDimParam(other) && dim.dim_param() == other.dim_param();
+}
+
+// Returns true if both shapes are known to be equal, comparing symbolic dimensions by name.
+bool IsSameShape(const TensorShapeProto& shape, const TensorShapeProto& other) {
+  if (shape.dim_size() != other.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    if (!IsSameDim(shape.dim(i), other.dim(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if shape is fully known and, once its leading dimensions of 1 are dropped, equals the trailing
+// dimensions of output_shape. This is the broadcast that FusedElementwise handles without an index computation.
+bool IsTrailingBlock(const TensorShapeProto& shape, const TensorShapeProto& output_shape) {
+  if (shape.dim_size() > output_shape.dim_size()) {
+    return false;
+  }
+  int first = 0;
+  while (first < shape.dim_size() && utils::HasDimValue(shape.dim(first)) && shape.dim(first).dim_value() == 1) {
+    ++first;
+  }
+  const int offset = output_shape.dim_size() - shape.dim_size();
+  for (int i = first; i < shape.dim_size(); ++i) {
+    if (!utils::HasDimValue(shape.dim(i)) || !IsSameDim(shape.dim(i), output_shape.dim(offset + i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsFusionCandidate(const Graph& graph, const Node& node,
+                       const InlinedHashSet<std::string_view>& compatible_providers) {
+  static const std::vector<std::string> supported_data_types{"tensor(float)"};
+  if (!IsFusableOp(node) || !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      !optimizer_utils::IsSupportedDataType(node, supported_data_types)) {
+    return false;
+  }
+
+  const TensorShapeProto* output_shape = node.OutputDefs()[0]->Shape();
+  if (output_shape == nullptr) {
+    return false;
+  }
+
+  for (const NodeArg* input : node.InputDefs()) {
+    // Leave Conv followed by Add and activations to the Conv fusions of the layout transformers.
+    const Node* producer = graph.GetProducerNode(input->Name());
+    if (producer != nullptr && (producer->OpType() == "Conv" || producer->OpType() == "FusedConv")) {
+      return false;
+    }
+
+    const TensorShapeProto* input_shape = input->Shape();
+    if (input_shape == nullptr ||
+        (!IsSameShape(*input_shape, *output_shape) && !IsTrailingBlock(*input_shape, *output_shape))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+struct ElementwiseGroup {
+  InlinedVector<Node*> nodes;  // in topological order
+  InlinedHashSet<NodeIndex> members;
+  size_t first_position;
+  const TensorShapeProto* shape;
+};
+
+// A node joins a group when its output has the shape of the group, and each input that is not produced within the
+// group is available before the first node of the group. The latter keeps the graph acyclic once the group is
+// replaced by one node.
+bool CanJoinGroup(const Graph& graph, const Node& node, const ElementwiseGroup& group,
+                  const InlinedHashMap<NodeIndex, size_t>& positions) {
+  if (!IsSameShape(*node.OutputDefs()[0]->Shape(), *group.shape)) {
+    return false;
+  }
+  for (const NodeArg* input : node.InputDefs()) {
+    const Node* producer = graph.GetProducerNode(input->Name());
+    if (producer == nullptr || group.members.count(producer->Index()) > 0) {
+      continue;
+    }
+    auto position = positions.find(producer->Index());
+    if (position == positions.end() || position->second >= group.first_position) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FuseGroup(Graph& graph, const ElementwiseGroup& group) {
+  InlinedVector<NodeArg*> inputs;
+  InlinedVector<NodeArg*> outputs;
+  InlinedHashMap<std::string, int64_t> values;
+
+  for (Node* node : group.nodes) {
+    for (NodeArg* input : node->MutableInputDefs()) {
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if ((producer == nullptr || group.members.count(producer->Index()) == 0) &&
+          values.find(input->Name()) == values.end()) {
+        values.emplace(input->Name(), static_cast<int64_t>(inputs.size()));
+        inputs.push_back(input);
+      }
+    }
+  }
+
+  const auto num_inputs = static_cast<int64_t>(inputs.size());
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  std::vector<int64_t> results;
+  for (size_t i = 0; i < group.nodes.size(); ++i) {
+    Node& node = *group.nodes[i];
+    ops.push_back(node.OpType());
+    operands.push_back(values.at(node.InputDefs()[0]->Name()));
+    operands.push_back(node.InputDefs().size() > 1 ? values.at(node.InputDefs()[1]->Name()) : -1);
+
+    const int64_t value = num_inputs + static_cast<int64_t>(i);
+    values.emplace(node.OutputDefs()[0]->Name(), value);
+
+    // The value is an output of the fused node if it is consumed outside of the group.
+    bool escapes = graph.NodeProducesGraphOutput(node);
+    for (auto it = node.OutputNodesBegin(); !escapes && it != node.OutputNodesEnd(); ++it) {
+      escapes = group.members.count(it->Index()) == 0;
+    }
+    if (escapes) {
+      results.push_back(value);
+      outputs.push_back(node.MutableOutputDefs()[0]);
+    }
+  }
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(group.nodes.back()->Name() + "/ElementwiseFusion/"),
+                                   "FusedElementwise", "fused elementwise operators", inputs, outputs, nullptr,
+                                   kMSDomain);
+  fused_node.AddAttribute("ops", gsl::span<const std::string>(ops));
+  fused_node.AddAttribute("operands", gsl::span<const int64_t>(operands));
+  fused_node.AddAttribute("results", gsl::span<const int64_t>(results));
+  fused_node.SetExecutionProviderType(group.nodes[0]->GetExecutionProviderType());
+
+  for (Node* node : group.nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> positions;
+  std::vector<ElementwiseGroup> groups;
+  InlinedHashMap<NodeIndex, size_t> group_of_node;
+
+  for (size_t position = 0; position < node_topology_list.size(); ++position) {
+    auto* p_node = graph.GetNode(node_topology_list[position]);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+    positions[node.Index()] = position;
+
+    if (!IsFusionCandidate(graph, node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    std::optional<size_t> group_index;
+    for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+      auto group_it = group_of_node.find(it->Index());
+      if (group_it != group_of_node.end() && CanJoinGroup(graph, node, groups[group_it->second], positions)) {
+        group_index = group_it->second;
+        break;
+      }
+    }
+
+    if (!group_index.has_value()) {
+      group_index = groups.size();
+      groups.push_back({{}, {}, position, node.OutputDefs()[0]->Shape()});
+    }
+
+    ElementwiseGroup& group = groups[*group_index];
+    group.nodes.push_back(&node);
+    group.members.insert(node.Index());
+    group_of_node[node.Index()] = *group_index;
+  }
+
+  for (const ElementwiseGroup& group : groups) {
+    if (group.nodes.size() < 2) {
+      continue;
+    }
+    FuseGroup(graph, group);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
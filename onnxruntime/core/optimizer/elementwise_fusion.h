@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuse chains of fp32 elementwise operators (Add, Sub, Mul, Div, Max, Min and unary activations) that produce the same
+output shape into a single com.microsoft.FusedElementwise node. The fused node evaluates the chain tile by tile, so
+the intermediate tensors of the chain are never written to memory.
+
+Inputs of the chain are either of the output shape, or constant-shaped tensors that broadcast as a trailing block
+(scalars, per-channel biases). The pattern specific fusions run first, so this only picks up what they leave behind.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <limits>
+#include <string>
+
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -26,15 +30,49 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  const bool profiling = profiler_ != nullptr && profiler_->IsEnabled();
+
+  // A transformer that did not modify the graph will not find anything to do until another transformer modifies it,
+  // so it is skipped until then. graph_version counts the modifications, and unmodified_version holds the version
+  // each transformer last left unmodified.
+  const auto& level_transformers = transformers->second;
+  size_t graph_version = 0;
+  InlinedVector<size_t> unmodified_version(level_transformers.size(), std::numeric_limits<size_t>::max());
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < level_transformers.size(); ++i) {
+      const auto& transformer = level_transformers[i];
       if (step > 0 && transformer->ShouldOnlyApplyOnce())
         continue;
 
+      if (unmodified_version[i] == graph_version) {
+        LOGS(logger, VERBOSE) << "GraphTransformer " << transformer->Name()
+                              << " skipped as the graph is unchanged since it last ran";
+        continue;
+      }
+
+      TimePoint start_time;
+      if (profiling) {
+        start_time = profiler_->Start();
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
-      graph_changed = graph_changed || modified;
+
+      if (profiling) {
+        profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name(), start_time,
+                                         {{"level", std::to_string(static_cast<int>(level))},
+                                          {"step", std::to_string(step)},
+                                          {"modified", modified ? "1" : "0"}});
+      }
+
+      if (modified) {
+        ++graph_version;
+        graph_changed = true;
+      } else {
+        unmodified_version[i] = graph_version;
+      }
     }
     if (!graph_changed) {
       break;
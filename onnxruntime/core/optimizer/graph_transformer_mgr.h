@@ -5,6 +5,7 @@
 
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
+#include "core/common/profiler.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/rewrite_rule.h"
@@ -24,6 +25,9 @@ class GraphTransformerManager {
   // Get the maximum number of graph transformation steps
   common::Status GetSteps(unsigned& steps) const;
 
+  // Set the profiler that records the time spent in each transformer. It must outlive this instance.
+  void SetProfiler(profiling::Profiler* profiler) { profiler_ = profiler; }
+
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);
 
@@ -36,6 +40,8 @@ class GraphTransformerManager {
   // maximum number of graph transformation steps
   unsigned steps_;
 
+  profiling::Profiler* profiler_{nullptr};
+
   InlinedHashMap<TransformerLevel, InlinedVector<std::unique_ptr<GraphTransformer>>> level_to_transformer_map_;
   InlinedHashMap<std::string, GraphTransformer*> transformers_info_;
 };
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <variant>
 
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
 #include "core/optimizer/nhwc_transformer.h"
@@ -33,6 +35,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -43,16 +46,21 @@
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identical_children_consolidation.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/label_encoder_fusion.h"
 #include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/loop_invariant_code_motion.h"
 #include "core/optimizer/matmul_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/optimizer/ml_preprocessing_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
@@ -70,9 +78,11 @@
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rocm_blas_alt_impl.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_folding.h"
 #include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #ifdef ENABLE_TRAINING
@@ -227,10 +237,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<CommonSubexpressionElimination>());
       transformers.emplace_back(std::make_unique<ConstantFolding>(cpu_execution_provider, !disable_quant_qdq,
                                                                   session_options.config_options));
+      transformers.emplace_back(std::make_unique<LoopInvariantCodeMotion>());
       transformers.emplace_back(std::make_unique<MatMulAddFusion>());
       transformers.emplace_back(std::make_unique<ReshapeFusion>());
       transformers.emplace_back(std::make_unique<FreeDimensionOverrideTransformer>(
           session_options.free_dimension_overrides));
+      transformers.emplace_back(std::make_unique<SymbolicShapeFolding>());
 
       if (!disable_quant_qdq) {
         transformers.emplace_back(std::make_unique<QDQPropagationTransformer>());
@@ -272,6 +284,8 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_eps = {onnxruntime::kCpuExecutionProvider,
+                                                             onnxruntime::kCudaExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_cuda_rocm_eps = {onnxruntime::kCpuExecutionProvider,
                                                                   onnxruntime::kCudaExecutionProvider,
                                                                   onnxruntime::kRocmExecutionProvider};
@@ -312,6 +326,13 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_eps));
+      // before GatherSliceToSplitFusion, which would turn the halves of rotate_half into a Split. ROCm has no
+      // RotaryEmbedding kernel.
+      transformers.emplace_back(std::make_unique<RotaryEmbeddingFusion>(cpu_cuda_eps));
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGroupQueryAttentionFusion,
+                                                            "0") == "1") {
+        transformers.emplace_back(std::make_unique<GroupQueryAttentionFusion>(cpu_ep));
+      }
       transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<EmbedLayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherSliceToSplitFusion>(cpu_cuda_rocm_eps));
@@ -357,10 +378,33 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       }
 #endif
 
+      // Weight-only quantization of MatMul is opt-in. 2D MatMul + Add has already been fused into Gemm at Level1,
+      // whose bias the quantization moves into MatMulNBits itself. The bias Add of a MatMul with a higher rank input
+      // is fused by MatMulNBitsFusion, which runs next.
+      const int64_t matmul_nbits_block_size = ParseStringWithClassicLocale<int64_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMatMulNBitsQuantizationBlockSize, "0"));
+      if (matmul_nbits_block_size > 0) {
+        const bool is_symmetric = session_options.config_options.GetConfigOrDefault(
+                                      kOrtSessionOptionsMatMulNBitsQuantizationSymmetric, "0") == "1";
+        const int64_t accuracy_level = ParseStringWithClassicLocale<int64_t>(
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMatMulNBitsQuantizationAccuracyLevel,
+                                                              "0"));
+        transformers.emplace_back(std::make_unique<MatMulNBitsQuantization>(matmul_nbits_block_size, is_symmetric,
+                                                                            accuracy_level, cpu_cuda_eps));
+      }
+
 #if !defined(ORT_NEURAL_SPEED)
       transformers.emplace_back(std::make_unique<MatMulNBitsFusion>(cpu_ep));
 #endif  // !defined(ORT_NEURAL_SPEED)
 
+      // ElementwiseFusion must run after the pattern specific fusions above, it fuses the elementwise chains they
+      // leave behind. It is opt-in because the fused kernel does not match the unfused activations bit for bit.
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseFusion, "0") == "1") {
+        transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_ep));
+      }
+
+      transformers.emplace_back(std::make_unique<MLPreprocessingFusion>(cpu_ep));
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
       // The QDQFinalCleanupTransformer must run AFTER other transformers that fuse Q/DQ nodes. Otherwise, their
       // fusions might be prevented if this one removes a Q/DQ node too early.
@@ -369,15 +413,38 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
     } break;
 
     case TransformerLevel::Level3: {
+      // The fp16 conversion runs first so the NhwcTransformer picks up the Conv and pooling nodes it converts.
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableCpuFp16MixedPrecision, "0") == "1" &&
+          MlasFp16AccelerationSupported()) {
+        InlinedHashSet<std::string> excluded_op_types;
+        const std::string excluded_op_types_config = session_options.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsCpuFp16MixedPrecisionExcludedOpTypes, "");
+        for (const auto op_type : utils::SplitString(excluded_op_types_config, ";")) {
+          excluded_op_types.emplace(op_type);
+        }
+        transformers.emplace_back(std::make_unique<MixedPrecisionTransformer>(
+            cpu_execution_provider.GetKernelRegistry(), std::move(excluded_op_types)));
+      }
+
 #ifndef DISABLE_CONTRIB_OPS
+      // When the fp32 NHWC layout is enabled, the NhwcTransformer runs first so it claims the fp32 Conv and pooling
+      // nodes, otherwise the NCHWc layout transformer takes them if supported by the platform.
+      const bool enable_fp32_nhwc =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableFp32NhwcLayout, "0") == "1";
+
+      auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
+      auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry),
+                                                                enable_fp32_nhwc);
+      if (enable_fp32_nhwc && nhwc_transformer->IsActive()) {
+        transformers.emplace_back(std::move(nhwc_transformer));
+      }
+
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
         transformers.emplace_back(std::make_unique<NchwcTransformer>());
       }
 
-      auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
-      auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry));
-      if (nhwc_transformer->IsActive()) {
+      if (nhwc_transformer && nhwc_transformer->IsActive()) {
         transformers.emplace_back(std::move(nhwc_transformer));
       }
 
@@ -455,7 +522,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
 #ifndef DISABLE_CONTRIB_OPS
         AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
         auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
-        auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry));
+        const bool enable_fp32_nhwc =
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableFp32NhwcLayout, "0") == "1";
+        auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry),
+                                                                  enable_fp32_nhwc);
         if (nhwc_transformer->IsActive()) {
           transformers.emplace_back(std::move(nhwc_transformer));
         }
@@ -0,0 +1,539 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_query_attention_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsSingleConsumerNode(const Graph& graph, const Node& node, bool may_produce_graph_output = false) {
+  return node.GetOutputEdgesCount() == 1 && (may_produce_graph_output || !graph.NodeProducesGraphOutput(node));
+}
+
+bool IsTranspose(const Node& node, const std::vector<int64_t>& perm) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1, 13}) &&
+         optimizer_utils::IsAttributeWithExpectedValues(node, "perm", perm);
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : default_value;
+}
+
+// Gets dimension `axis` of the shape a Reshape to `rank` dimensions produces, if it is a positive constant.
+bool GetReshapeDim(const Graph& graph, const Node& reshape, int rank, int axis, int64_t& value) {
+  const NodeArg& shape = *reshape.InputDefs()[1];
+  InlinedVector<int64_t> dims;
+  if (optimizer_utils::AppendTensorFromInitializer(graph, shape, dims)) {
+    value = dims.size() == static_cast<size_t>(rank) ? dims[axis] : 0;
+    return value > 0;
+  }
+
+  // the shape is usually concatenated from the computed batch and sequence dimensions and constant head dimensions.
+  const Node* concat = graph.GetProducerNode(shape.Name());
+  if (concat != nullptr && concat->OpType() == "Concat" && concat->InputDefs().size() == static_cast<size_t>(rank) &&
+      optimizer_utils::AppendTensorFromInitializer(graph, *concat->InputDefs()[axis], dims) && dims.size() == 1) {
+    value = dims[0];
+    return value > 0;
+  }
+
+  const auto* output_shape = reshape.OutputDefs()[0]->Shape();
+  if (output_shape != nullptr && output_shape->dim_size() == rank && output_shape->dim(axis).has_dim_value()) {
+    value = output_shape->dim(axis).dim_value();
+    return value > 0;
+  }
+
+  return false;
+}
+
+// Matches Transpose(Reshape(x, [B, S, num_heads, head_size]), perm [0, 2, 1, 3]) producing `arg` and returns the
+// 3D input x.
+const NodeArg* MatchSplitHeads(const Graph& graph, const NodeArg& arg, bool may_produce_graph_output,
+                               int64_t& num_heads, int64_t& head_size, InlinedVector<const Node*>& nodes) {
+  const Node* transpose = graph.GetProducerNode(arg.Name());
+  if (transpose == nullptr || !IsTranspose(*transpose, {0, 2, 1, 3}) ||
+      !IsSingleConsumerNode(graph, *transpose, may_produce_graph_output)) {
+    return nullptr;
+  }
+
+  const Node* reshape = graph.GetProducerNode(transpose->InputDefs()[0]->Name());
+  if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5, 13, 14}) ||
+      !IsSingleConsumerNode(graph, *reshape) ||
+      !GetReshapeDim(graph, *reshape, 4, 2, num_heads) || !GetReshapeDim(graph, *reshape, 4, 3, head_size)) {
+    return nullptr;
+  }
+
+  const NodeArg* input = reshape->InputDefs()[0];
+  if (input->Shape() == nullptr || input->Shape()->dim_size() != 3) {
+    return nullptr;
+  }
+
+  nodes.push_back(reshape);
+  nodes.push_back(transpose);
+  return input;
+}
+
+// Matches a RotaryEmbedding of 4D heads producing `arg` that GroupQueryAttention can apply itself.
+const Node* MatchRotary(const Graph& graph, const NodeArg& arg, bool may_produce_graph_output) {
+  const Node* rotary = graph.GetProducerNode(arg.Name());
+  if (rotary == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*rotary, "RotaryEmbedding", {1}, kMSDomain) ||
+      !IsSingleConsumerNode(graph, *rotary, may_produce_graph_output) || rotary->InputDefs().size() != 4 ||
+      GetIntAttribute(*rotary, "rotary_embedding_dim", 0) != 0 ||
+      GetIntAttribute(*rotary, "is_packed_batching", 0) != 0 ||
+      (graph_utils::GetNodeAttribute(*rotary, "scale") != nullptr &&
+       !optimizer_utils::IsAttributeWithExpectedValue(*rotary, "scale", 1.0f))) {
+    return nullptr;
+  }
+  return rotary;
+}
+
+// Matches repeat_kv(x) = Reshape(Expand(Unsqueeze(x, axes [2]))) producing `arg`. Returns x, or `arg` if it is not
+// repeated.
+const NodeArg* MatchRepeatKV(const Graph& graph, const NodeArg& arg, bool& repeated,
+                             InlinedVector<const Node*>& nodes) {
+  repeated = false;
+  const Node* reshape = graph.GetProducerNode(arg.Name());
+  if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5, 13, 14})) {
+    return &arg;
+  }
+
+  const Node* expand = graph.GetProducerNode(reshape->InputDefs()[0]->Name());
+  if (expand == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*expand, "Expand", {8, 13})) {
+    return nullptr;
+  }
+
+  const Node* unsqueeze = graph.GetProducerNode(expand->InputDefs()[0]->Name());
+  if (unsqueeze == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*unsqueeze, "Unsqueeze", {1, 11, 13})) {
+    return nullptr;
+  }
+  InlinedVector<int64_t> axes;
+  if (const auto* axes_attr = graph_utils::GetNodeAttribute(*unsqueeze, "axes"); axes_attr != nullptr) {
+    axes.assign(axes_attr->ints().begin(), axes_attr->ints().end());
+  } else if (unsqueeze->InputDefs().size() < 2 ||
+             !optimizer_utils::AppendTensorFromInitializer(graph, *unsqueeze->InputDefs()[1], axes)) {
+    return nullptr;
+  }
+
+  if (axes.size() != 1 || axes[0] != 2 || !IsSingleConsumerNode(graph, *reshape) ||
+      !IsSingleConsumerNode(graph, *expand) || !IsSingleConsumerNode(graph, *unsqueeze)) {
+    return nullptr;
+  }
+
+  repeated = true;
+  nodes.push_back(unsqueeze);
+  nodes.push_back(expand);
+  nodes.push_back(reshape);
+  return unsqueeze->InputDefs()[0];
+}
+
+// Matches Concat(past, x, axis 2) producing `arg`, where past is a graph input. Returns x and sets past, or returns
+// `arg` if it is not concatenated.
+const NodeArg* MatchPast(const Graph& graph, const NodeArg& arg, const NodeArg*& past,
+                         InlinedVector<const Node*>& nodes) {
+  past = nullptr;
+  const Node* concat = graph.GetProducerNode(arg.Name());
+  if (concat == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*concat, "Concat", {4, 11, 13})) {
+    return &arg;
+  }
+
+  const int64_t axis = GetIntAttribute(*concat, "axis", 0);
+  if (concat->InputDefs().size() != 2 || (axis != 2 && axis != -2) || concat->GetOutputEdgesCount() != 1 ||
+      !graph_utils::IsGraphInput(graph, concat->InputDefs()[0])) {
+    return nullptr;
+  }
+
+  past = concat->InputDefs()[0];
+  nodes.push_back(concat);
+  return concat->InputDefs()[1];
+}
+
+// Matches MatMul(q, k^T) optionally scaled by a constant with Mul or Div, producing `arg`.
+const Node* MatchScaledQK(const Graph& graph, const NodeArg& arg, float& scale, InlinedVector<const Node*>& nodes) {
+  const Node* node = graph.GetProducerNode(arg.Name());
+  scale = 1.0f;
+  if (node != nullptr && (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Div", {7, 13, 14}) ||
+                          graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Mul", {7, 13, 14}))) {
+    const bool is_div = node->OpType() == "Div";
+    float value = 0.0f;
+    const NodeArg* qk = nullptr;
+    for (int i = 0; i < (is_div ? 1 : 2) && qk == nullptr; ++i) {
+      if (optimizer_utils::GetScalarInitializerValue(graph, *node->InputDefs()[1 - i], value, true)) {
+        qk = node->InputDefs()[i];
+      }
+    }
+    if (qk == nullptr || value == 0.0f || !IsSingleConsumerNode(graph, *node)) {
+      return nullptr;
+    }
+    scale = is_div ? 1.0f / value : value;
+    nodes.push_back(node);
+    node = graph.GetProducerNode(qk->Name());
+  }
+
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMul", {1, 9, 13}) ||
+      !IsSingleConsumerNode(graph, *node)) {
+    return nullptr;
+  }
+  nodes.push_back(node);
+  return node;
+}
+
+// Returns the 2D attention mask graph input the additive mask is computed from, or nullptr if the mask has no causal
+// part or depends on other graph inputs than the attention mask and the shapes of inputs.
+const NodeArg* FindAttentionMask(const Graph& graph, const NodeArg& mask) {
+  const NodeArg* attention_mask = nullptr;
+  bool is_causal = false;
+  InlinedVector<const NodeArg*> to_visit{&mask};
+  InlinedHashSet<const NodeArg*> visited{&mask};
+  while (!to_visit.empty()) {
+    const NodeArg* arg = to_visit.back();
+    to_visit.pop_back();
+
+    if (graph_utils::IsInitializer(graph, arg->Name(), true)) {
+      continue;
+    }
+    if (graph_utils::IsGraphInput(graph, arg)) {
+      if (attention_mask != nullptr && attention_mask != arg) {
+        return nullptr;
+      }
+      attention_mask = arg;
+      continue;
+    }
+
+    const Node* producer = graph.GetProducerNode(arg->Name());
+    if (producer == nullptr || producer->OpType() == "Shape" || producer->OpType() == "Size") {
+      continue;  // a constant, or only the shape of the input is used.
+    }
+    if (producer->ContainsSubgraph()) {
+      return nullptr;
+    }
+
+    is_causal = is_causal || producer->OpType() == "Trilu" || producer->OpType() == "Range";
+    for (const NodeArg* input : producer->InputDefs()) {
+      if (input->Exists() && visited.insert(input).second) {
+        to_visit.push_back(input);
+      }
+    }
+  }
+
+  if (!is_causal || attention_mask == nullptr || attention_mask->Shape() == nullptr ||
+      attention_mask->Shape()->dim_size() != 2) {
+    return nullptr;
+  }
+  const auto elem_type = attention_mask->TypeAsProto()->tensor_type().elem_type();
+  return elem_type == TensorProto_DataType_INT64 || elem_type == TensorProto_DataType_INT32 ? attention_mask : nullptr;
+}
+
+NodeArg& AddScalarInitializer(Graph& graph, const std::string& name, TensorProto_DataType data_type, int64_t value,
+                              bool as_1d = false) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(name));
+  tensor.set_data_type(data_type);
+  if (as_1d) {
+    tensor.add_dims(1);
+  }
+  if (data_type == TensorProto_DataType_INT32) {
+    tensor.add_int32_data(static_cast<int32_t>(value));
+  } else {
+    tensor.add_int64_data(value);
+  }
+  return graph_utils::AddInitializer(graph, tensor);
+}
+
+struct SequenceLengths {
+  NodeArg* seqlens_k;
+  NodeArg* total_sequence_length;
+};
+
+// Adds the nodes computing the seqlens_k (number of valid tokens - 1) and total_sequence_length inputs of
+// GroupQueryAttention from a 2D attention mask.
+SequenceLengths AddSequenceLengths(Graph& graph, NodeArg& attention_mask, const std::string& provider) {
+  TypeProto int32_type;
+  int32_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  TypeProto int64_type;
+  int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  auto add_node = [&](const std::string& op_type, InlinedVector<NodeArg*> inputs,
+                      const TypeProto& output_type) -> Node& {
+    NodeArg& output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(attention_mask.Name() + "_" + op_type),
+                                               &output_type);
+    Node& node = graph.AddNode(graph.GenerateNodeName("GroupQueryAttentionFusion/" + op_type), op_type,
+                               "sequence lengths for GroupQueryAttention", inputs, {&output});
+    node.SetExecutionProviderType(provider);
+    return node;
+  };
+
+  Node& cast_mask = add_node("Cast", {&attention_mask}, int32_type);
+  cast_mask.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto opset = domain_to_version.find(kOnnxDomain);
+  const bool axes_as_input = opset != domain_to_version.end() && opset->second >= 13;
+  InlinedVector<NodeArg*> reduce_inputs{cast_mask.MutableOutputDefs()[0]};
+  if (axes_as_input) {
+    reduce_inputs.push_back(&AddScalarInitializer(graph, "seqlens_axes", TensorProto_DataType_INT64, 1, true));
+  }
+  Node& reduce_sum = add_node("ReduceSum", reduce_inputs, int32_type);
+  if (!axes_as_input) {
+    reduce_sum.AddAttribute("axes", std::vector<int64_t>{1});
+  }
+  reduce_sum.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  Node& seqlens_k = add_node("Sub",
+                             {reduce_sum.MutableOutputDefs()[0],
+                              &AddScalarInitializer(graph, "seqlens_one", TensorProto_DataType_INT32, 1)},
+                             int32_type);
+
+  Node& shape = add_node("Shape", {&attention_mask}, int64_type);
+  Node& gather = add_node("Gather",
+                          {shape.MutableOutputDefs()[0],
+                           &AddScalarInitializer(graph, "total_sequence_length_axis", TensorProto_DataType_INT64, 1)},
+                          int64_type);
+  Node& total_sequence_length = add_node("Cast", {gather.MutableOutputDefs()[0]}, int32_type);
+  total_sequence_length.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+
+  return {seqlens_k.MutableOutputDefs()[0], total_sequence_length.MutableOutputDefs()[0]};
+}
+
+}  // namespace
+
+Status GroupQueryAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the attention mask each additive mask is computed from, and the sequence lengths computed from each attention
+  // mask. the layers of a decoder share them.
+  InlinedHashMap<std::string, const NodeArg*> attention_masks;
+  InlinedHashMap<std::string, SequenceLengths> sequence_lengths;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& softmax = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders()) ||
+        !IsSingleConsumerNode(graph, softmax) ||
+        softmax.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+    const int64_t softmax_axis = GetIntAttribute(softmax, "axis", softmax.SinceVersion() >= 13 ? -1 : 1);
+    if (softmax_axis != -1 && softmax_axis != 3) {
+      continue;
+    }
+
+    // Softmax(MatMul(q, Transpose(k)) * scale + mask)
+    InlinedVector<const Node*> nodes{&softmax};
+    const Node* add_mask = graph.GetProducerNode(softmax.InputDefs()[0]->Name());
+    if (add_mask == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*add_mask, "Add", {7, 13, 14}) ||
+        !IsSingleConsumerNode(graph, *add_mask)) {
+      continue;
+    }
+    nodes.push_back(add_mask);
+
+    float scale = 1.0f;
+    const Node* qk = nullptr;
+    const NodeArg* mask = nullptr;
+    for (int i = 0; i < 2 && qk == nullptr; ++i) {
+      const size_t nodes_size = nodes.size();
+      qk = MatchScaledQK(graph, *add_mask->InputDefs()[i], scale, nodes);
+      if (qk == nullptr) {
+        nodes.resize(nodes_size);
+      } else {
+        mask = add_mask->InputDefs()[1 - i];
+      }
+    }
+    if (qk == nullptr) {
+      continue;
+    }
+
+    const Node* k_transpose = graph.GetProducerNode(qk->InputDefs()[1]->Name());
+    if (k_transpose == nullptr || !IsTranspose(*k_transpose, {0, 1, 3, 2}) ||
+        !IsSingleConsumerNode(graph, *k_transpose)) {
+      continue;
+    }
+    nodes.push_back(k_transpose);
+
+    // Reshape(Transpose(MatMul(probs, v), perm [0, 2, 1, 3]), [B, S, N * H])
+    const Node& pv = *softmax.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(pv, "MatMul", {1, 9, 13}) ||
+        pv.InputDefs()[0] != softmax.OutputDefs()[0] || !IsSingleConsumerNode(graph, pv)) {
+      continue;
+    }
+    const Node& output_transpose = *pv.OutputNodesBegin();
+    if (!IsTranspose(output_transpose, {0, 2, 1, 3}) || !IsSingleConsumerNode(graph, output_transpose)) {
+      continue;
+    }
+    const Node& output_reshape = *output_transpose.OutputNodesBegin();
+    int64_t hidden_size = 0;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(output_reshape, "Reshape", {5, 13, 14}) ||
+        !GetReshapeDim(graph, output_reshape, 3, 2, hidden_size)) {
+      continue;
+    }
+    nodes.push_back(&pv);
+    nodes.push_back(&output_transpose);
+    nodes.push_back(&output_reshape);
+
+    // q = RotaryEmbedding(Transpose(Reshape(q_3d)))
+    int64_t num_heads = 0, head_size = 0;
+    const Node* q_rotary = MatchRotary(graph, *qk->InputDefs()[0], false);
+    if (q_rotary == nullptr) {
+      continue;
+    }
+    nodes.push_back(q_rotary);
+    const NodeArg* query = MatchSplitHeads(graph, *q_rotary->InputDefs()[0], false, num_heads, head_size, nodes);
+    if (query == nullptr) {
+      continue;
+    }
+
+    // k = repeat_kv(Concat(past_key, RotaryEmbedding(Transpose(Reshape(k_3d)))))
+    bool k_repeated = false;
+    const NodeArg* past_key = nullptr;
+    const NodeArg* present_key = MatchRepeatKV(graph, *k_transpose->InputDefs()[0], k_repeated, nodes);
+    const NodeArg* k_rotary_output = present_key != nullptr ? MatchPast(graph, *present_key, past_key, nodes)
+                                                            : nullptr;
+    const Node* k_rotary = k_rotary_output != nullptr ? MatchRotary(graph, *k_rotary_output, past_key == nullptr)
+                                                      : nullptr;
+    if (k_rotary == nullptr) {
+      continue;
+    }
+    nodes.push_back(k_rotary);
+    int64_t kv_num_heads = 0, k_head_size = 0;
+    const NodeArg* key = MatchSplitHeads(graph, *k_rotary->InputDefs()[0], false, kv_num_heads, k_head_size, nodes);
+
+    // v = repeat_kv(Concat(past_value, Transpose(Reshape(v_3d))))
+    bool v_repeated = false;
+    const NodeArg* past_value = nullptr;
+    const NodeArg* present_value = MatchRepeatKV(graph, *pv.InputDefs()[1], v_repeated, nodes);
+    const NodeArg* v_heads = present_value != nullptr ? MatchPast(graph, *present_value, past_value, nodes)
+                                                      : nullptr;
+    int64_t v_num_heads = 0, v_head_size = 0;
+    const NodeArg* value = v_heads != nullptr ? MatchSplitHeads(graph, *v_heads, past_value == nullptr, v_num_heads,
+                                                                v_head_size, nodes)
+                                              : nullptr;
+
+    if (key == nullptr || value == nullptr ||
+        kv_num_heads != v_num_heads || head_size != k_head_size || head_size != v_head_size ||
+        num_heads % kv_num_heads != 0 || hidden_size != num_heads * head_size ||
+        k_repeated != (num_heads != kv_num_heads) || v_repeated != k_repeated ||
+        (past_key == nullptr) != (past_value == nullptr) ||
+        graph.IsOutput(present_key) != graph.IsOutput(present_value)) {
+      continue;
+    }
+
+    // GroupQueryAttention applies the rotary embedding with the shared caches of shape (max_sequence_length,
+    // head_size / 2), and requires a head size that is a multiple of 16.
+    const auto& rotary_inputs = q_rotary->InputDefs();
+    const auto* cos_cache = graph_utils::GetConstantInitializer(graph, rotary_inputs[2]->Name());
+    if (head_size % 16 != 0 || rotary_inputs[1] != k_rotary->InputDefs()[1] ||
+        rotary_inputs[2] != k_rotary->InputDefs()[2] || rotary_inputs[3] != k_rotary->InputDefs()[3] ||
+        GetIntAttribute(*q_rotary, "interleaved", 0) != GetIntAttribute(*k_rotary, "interleaved", 0) ||
+        cos_cache == nullptr || cos_cache->dims_size() != 2 || cos_cache->dims(1) != head_size / 2) {
+      continue;
+    }
+
+    auto attention_mask = attention_masks.find(mask->Name());
+    if (attention_mask == attention_masks.end()) {
+      attention_mask = attention_masks.emplace(mask->Name(), FindAttentionMask(graph, *mask)).first;
+    }
+    if (attention_mask->second == nullptr) {
+      continue;
+    }
+
+    // the nodes computing the inputs of the removed nodes, e.g. the mask, the shapes of the Reshape and Expand nodes
+    // and the position ids, are removed below once they have no consumers left.
+    InlinedHashSet<NodeIndex> removed;
+    for (const Node* node : nodes) {
+      removed.insert(node->Index());
+    }
+    InlinedVector<NodeIndex> input_producers;
+    for (const Node* node : nodes) {
+      for (auto edge = node->InputEdgesBegin(), end = node->InputEdgesEnd(); edge != end; ++edge) {
+        if (removed.count(edge->GetNode().Index()) == 0) {
+          input_producers.push_back(edge->GetNode().Index());
+        }
+      }
+    }
+
+    const int64_t rotary_interleaved = GetIntAttribute(*q_rotary, "interleaved", 0);
+    const std::string provider = softmax.GetExecutionProviderType();
+    const std::string name = graph.GenerateNodeName(softmax.Name() + "/GroupQueryAttentionFusion/");
+    NodeArg* output = graph.GetNodeArg(output_reshape.OutputDefs()[0]->Name());
+    NodeArg* present_outputs[2] = {graph.GetNodeArg(present_key->Name()), graph.GetNodeArg(present_value->Name())};
+    if (!graph.IsOutput(present_key)) {
+      // present_key and present_value are required outputs, give them new names if they are not used.
+      for (NodeArg*& present : present_outputs) {
+        present = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(present->Name()), present->TypeAsProto());
+      }
+    }
+
+    InlinedVector<NodeArg*> gqa_inputs{graph.GetNodeArg(query->Name()),
+                                       graph.GetNodeArg(key->Name()),
+                                       graph.GetNodeArg(value->Name()),
+                                       past_key != nullptr ? graph.GetNodeArg(past_key->Name())
+                                                           : &graph.GetOrCreateNodeArg("", nullptr),
+                                       past_value != nullptr ? graph.GetNodeArg(past_value->Name())
+                                                             : &graph.GetOrCreateNodeArg("", nullptr),
+                                       nullptr,
+                                       nullptr,
+                                       graph.GetNodeArg(rotary_inputs[2]->Name()),
+                                       graph.GetNodeArg(rotary_inputs[3]->Name())};
+
+    // the outputs of the last nodes are reused by the fused node, so the matched nodes are removed first.
+    for (const Node* node : nodes) {
+      Node& node_to_remove = *graph.GetNode(node->Index());
+      graph_utils::RemoveNodeOutputEdges(graph, node_to_remove);
+      graph.RemoveNode(node_to_remove.Index());
+    }
+
+    auto lengths = sequence_lengths.find(attention_mask->second->Name());
+    if (lengths == sequence_lengths.end()) {
+      NodeArg& mask_input = *graph.GetNodeArg(attention_mask->second->Name());
+      lengths = sequence_lengths.emplace(mask_input.Name(), AddSequenceLengths(graph, mask_input, provider)).first;
+    }
+    gqa_inputs[5] = lengths->second.seqlens_k;
+    gqa_inputs[6] = lengths->second.total_sequence_length;
+
+    Node& gqa_node = graph.AddNode(name, "GroupQueryAttention", "fused causal self attention", gqa_inputs,
+                                   {output, present_outputs[0], present_outputs[1]}, {}, kMSDomain);
+    gqa_node.AddAttribute("num_heads", num_heads);
+    gqa_node.AddAttribute("kv_num_heads", kv_num_heads);
+    gqa_node.AddAttribute("scale", scale);
+    gqa_node.AddAttribute("do_rotary", static_cast<int64_t>(1));
+    gqa_node.AddAttribute("rotary_interleaved", rotary_interleaved);
+    gqa_node.SetExecutionProviderType(provider);
+
+    // connect the inputs now, so their producers are kept when the unused producers are removed below.
+    for (int i = 0; i < static_cast<int>(gqa_inputs.size()); ++i) {
+      const Node* producer = gqa_inputs[i]->Exists() ? graph.GetProducerNode(gqa_inputs[i]->Name()) : nullptr;
+      if (producer != nullptr) {
+        graph.AddEdge(producer->Index(), gqa_node.Index(),
+                      optimizer_utils::IndexOfNodeOutput(*producer, *gqa_inputs[i]), i);
+      }
+    }
+
+    for (NodeIndex index : input_producers) {
+      const Node* producer = graph.GetNode(index);
+      if (producer != nullptr && producer->GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(*producer)) {
+        graph_utils::RemoveNodesWithOneOutputBottomUp(graph, *producer);
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupQueryAttentionFusion
+
+Fuses the causal self attention of LLaMA style decoders exported from PyTorch into a GroupQueryAttention node.
+
+  q = RotaryEmbedding(Transpose(Reshape(q_proj, [B, S, N, H])))
+  k = Concat(past_key, RotaryEmbedding(Transpose(Reshape(k_proj, [B, S, kv_N, H]))))   -> present_key
+  v = Concat(past_value, Transpose(Reshape(v_proj, [B, S, kv_N, H])))                  -> present_value
+  k, v = repeat_kv(k), repeat_kv(v)    with Unsqueeze -> Expand -> Reshape, when N > kv_N
+  Reshape(Transpose(MatMul(Softmax(MatMul(q, Transpose(k)) * scale + mask), v)), [B, S, N * H])
+
+The RotaryEmbedding nodes are created by the RotaryEmbeddingFusion. They are moved before the heads are split,
+and the past/present Concat nodes are optional. The additive mask must be computed from a single 2D attention mask
+graph input and contain a causal part (Trilu or Range). seqlens_k and total_sequence_length of the
+GroupQueryAttention are computed from that input.
+
+GroupQueryAttention only supports causal attention of right padded sequences, and treats every input with more than
+one token as a prompt without past. The fusion cannot verify this from the graph, so it is opt-in.
+*/
+class GroupQueryAttentionFusion : public GraphTransformer {
+ public:
+  GroupQueryAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupQueryAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
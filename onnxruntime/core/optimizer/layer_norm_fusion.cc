@@ -584,12 +584,29 @@ Status SimplifiedLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int gr
     }
     nodes_to_remove.push_back(sqrt_node);
 
+    // x / sqrt(.) is either a Div, or a Mul with the Reciprocal of the Sqrt when exported from x * rsqrt(.).
     const Node* p_div = graph_utils::FirstChildByType(sqrt_node, "Div");
+    const Node* p_reciprocal = nullptr;
     if (p_div == nullptr) {
-      continue;
+      p_reciprocal = graph_utils::FirstChildByType(sqrt_node, "Reciprocal");
+      if (p_reciprocal == nullptr) {
+        continue;
+      }
+      Node& reciprocal_node = *graph.GetNode(p_reciprocal->Index());
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(reciprocal_node, "Reciprocal", {6, 13}) ||
+          reciprocal_node.GetExecutionProviderType() != pow_node.GetExecutionProviderType() ||
+          !optimizer_utils::CheckOutputEdges(graph, reciprocal_node, 1) || !IsSupportedDataType(reciprocal_node)) {
+        continue;
+      }
+      nodes_to_remove.push_back(reciprocal_node);
+
+      p_div = graph_utils::FirstChildByType(reciprocal_node, "Mul");
+      if (p_div == nullptr) {
+        continue;
+      }
     }
     Node& div_node = *graph.GetNode(p_div->Index());
-    if (!graph_utils::IsSupportedOptypeVersionAndDomain(div_node, "Div", {7, 13, 14}) ||
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(div_node, p_reciprocal ? "Mul" : "Div", {7, 13, 14}) ||
         div_node.GetExecutionProviderType() != pow_node.GetExecutionProviderType() ||
         !optimizer_utils::CheckOutputEdges(graph, div_node, 1) || !IsSupportedDataType(div_node)) {
       continue;
@@ -597,7 +614,10 @@ Status SimplifiedLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int gr
     nodes_to_remove.push_back(div_node);
 
     // Check Div and Pow has same input, and if this input is a Cast, we can also remove it.
-    const NodeArg* p_div_input = div_node.MutableInputDefs()[0];
+    // x can be either input of the Mul.
+    const bool x_is_second_input = p_reciprocal != nullptr &&
+                                   div_node.InputDefs()[0] == p_reciprocal->OutputDefs()[0];
+    const NodeArg* p_div_input = div_node.MutableInputDefs()[x_is_second_input ? 1 : 0];
     const NodeArg* p_pow_input = pow_node.MutableInputDefs()[0];
     if (!p_pow_input || !p_div_input || p_div_input != p_pow_input) {
       continue;
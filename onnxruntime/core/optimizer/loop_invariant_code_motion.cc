@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/loop_invariant_code_motion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+#include "core/providers/common.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsNodeSupported(const Node& node) {
+  // skip control flow nodes, nodes that produce non-deterministic output, and DequantizeLinear (DQ) nodes.
+  // a DQ node moved out of the body would no longer be part of the QDQ node group of its consumer.
+  return !node.ContainsSubgraph() &&
+         !node.OutputDefs().empty() &&
+         optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType()) &&
+         !(node.Domain() == kOnnxDomain && node.OpType() == "DequantizeLinear") &&
+         !(node.Domain() == kMSDomain && node.OpType() == "DequantizeLinear");
+}
+
+// Returns true if all inputs of `node` have static shapes that broadcast to each other.
+bool HasBroadcastableStaticInputShapes(const Node& node) {
+  InlinedVector<int64_t> output_dims;
+  for (const NodeArg* input : node.InputDefs()) {
+    const auto* shape = input->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+
+    const int rank = shape->dim_size();
+    if (static_cast<size_t>(rank) > output_dims.size()) {
+      output_dims.insert(output_dims.begin(), rank - output_dims.size(), 1);
+    }
+    const size_t offset = output_dims.size() - rank;
+    for (int i = 0; i < rank; ++i) {
+      if (!shape->dim(i).has_dim_value()) {
+        return false;
+      }
+      const int64_t dim = shape->dim(i).dim_value();
+      int64_t& output_dim = output_dims[offset + i];
+      if (output_dim == 1) {
+        output_dim = dim;
+      } else if (dim != 1 && dim != output_dim) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Returns true if `node` cannot fail at run time, whatever the values of its inputs. Only these nodes are moved out
+// of a body that might not run at all, as moving a node that fails, e.g. a Gather with an out of range index, would
+// turn a loop that runs zero times into an error.
+bool CannotFail(const Node& node) {
+  static const InlinedHashSet<std::string_view> unary_ops = {
+      "Abs", "Ceil", "Cos", "Erf", "Exp", "Floor", "Identity", "IsInf", "IsNaN", "Log", "Neg", "Not",
+      "Reciprocal", "Relu", "Round", "Shape", "Sigmoid", "Sign", "Sin", "Size", "Softplus", "Softsign", "Sqrt",
+      "Tanh"};
+  // integer Div is left out, it fails on division by zero.
+  static const InlinedHashSet<std::string_view> broadcasting_ops = {
+      "Add", "And", "Equal", "Greater", "Less", "Max", "Min", "Mul", "Or", "Sub"};
+
+  if (node.Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  if (unary_ops.count(node.OpType()) > 0) {
+    return true;
+  }
+
+  if (node.OpType() == "Div") {
+    const auto* type = node.InputDefs()[0]->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type()) {
+      return false;
+    }
+    const auto elem_type = type->tensor_type().elem_type();
+    if (elem_type != TensorProto_DataType_FLOAT && elem_type != TensorProto_DataType_DOUBLE &&
+        elem_type != TensorProto_DataType_FLOAT16 && elem_type != TensorProto_DataType_BFLOAT16) {
+      return false;
+    }
+    return HasBroadcastableStaticInputShapes(node);
+  }
+
+  return broadcasting_ops.count(node.OpType()) > 0 && HasBroadcastableStaticInputShapes(node);
+}
+
+// Returns true if the body of the Loop or Scan node runs at least once.
+bool RunsAtLeastOnce(const Graph& graph, const Node& node) {
+  if (node.OpType() == "Loop") {
+    // the trip count M and the initial condition must both be absent or constants allowing an iteration.
+    const auto& inputs = node.InputDefs();
+    if (inputs[0]->Exists()) {
+      const auto* trip_count = graph_utils::GetConstantInitializer(graph, inputs[0]->Name());
+      if (trip_count == nullptr || trip_count->data_type() != TensorProto_DataType_INT64) {
+        return false;
+      }
+      Initializer value{*trip_count, graph.ModelPath()};
+      if (value.size() != 1 || value.data<int64_t>()[0] < 1) {
+        return false;
+      }
+    }
+    if (inputs.size() > 1 && inputs[1]->Exists()) {
+      const auto* cond = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+      if (cond == nullptr || cond->data_type() != TensorProto_DataType_BOOL) {
+        return false;
+      }
+      Initializer value{*cond, graph.ModelPath()};
+      if (value.size() != 1 || !value.data<bool>()[0]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Scan runs once per slice of its scan inputs along the scan axis. Scan-8 has a batch axis and is not handled.
+  if (node.SinceVersion() < 9) {
+    return false;
+  }
+  const auto& attrs = node.GetAttributes();
+  auto num_scan_inputs = attrs.find("num_scan_inputs");
+  if (num_scan_inputs == attrs.end() || num_scan_inputs->second.i() < 1 ||
+      static_cast<size_t>(num_scan_inputs->second.i()) > node.InputDefs().size()) {
+    return false;
+  }
+  const NodeArg& scan_input = *node.InputDefs()[node.InputDefs().size() - num_scan_inputs->second.i()];
+  const auto* shape = scan_input.Shape();
+  if (shape == nullptr || shape->dim_size() == 0) {
+    return false;
+  }
+  int64_t axis = 0;
+  auto scan_input_axes = attrs.find("scan_input_axes");
+  if (scan_input_axes != attrs.end() && scan_input_axes->second.ints_size() > 0) {
+    axis = HandleNegativeAxis(scan_input_axes->second.ints(0), shape->dim_size());
+  }
+  const auto& dim = shape->dim(static_cast<int>(axis));
+  return dim.has_dim_value() && dim.dim_value() >= 1;
+}
+
+// Moves the invariant nodes of `body` into `graph`, which contains the Loop or Scan node owning `body`.
+// If the body might not run at all, only nodes that cannot fail are moved.
+bool HoistInvariantNodes(Graph& graph, Graph& body, bool runs_at_least_once,
+                         const InlinedHashSet<std::string_view>& compatible_providers) {
+  bool modified = false;
+
+  // outputs of nodes that were moved to `graph`, which are outer scope values for the body from now on, and the
+  // initializers that were moved to `graph`.
+  InlinedHashSet<std::string> hoisted_values;
+
+  GraphViewer body_viewer(body);
+  for (auto node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    Node* p_node = body.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    if (!IsNodeSupported(node) || !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+        (!runs_at_least_once && !CannotFail(node))) {
+      continue;
+    }
+
+    bool is_invariant = true;
+    InlinedVector<const ONNX_NAMESPACE::TensorProto*> local_initializers;
+    for (const NodeArg* input : node.InputDefs()) {
+      if (!input->Exists() || hoisted_values.count(input->Name()) > 0 || body.IsOuterScopeValue(input->Name())) {
+        continue;
+      }
+
+      const auto* initializer = graph_utils::GetConstantInitializer(body, input->Name(), false);
+      if (initializer == nullptr || graph.GetNodeArgIncludingParentGraphs(input->Name()) != nullptr) {
+        is_invariant = false;
+        break;
+      }
+      if (std::find(local_initializers.begin(), local_initializers.end(), initializer) == local_initializers.end()) {
+        local_initializers.push_back(initializer);
+      }
+    }
+
+    // the outputs must stay local to the body if they are its outputs, and must not clash with names in `graph`.
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (!is_invariant) {
+        break;
+      }
+      is_invariant = !body.IsOutput(output) &&
+                     (!output->Exists() || graph.GetNodeArgIncludingParentGraphs(output->Name()) == nullptr);
+    }
+
+    if (!is_invariant) {
+      continue;
+    }
+
+    // the initializers are moved rather than copied. nodes left in the body that also use them read them from
+    // outer scope, like the outputs of the moved nodes.
+    for (const auto* initializer : local_initializers) {
+      std::string name = initializer->name();
+      graph_utils::AddInitializer(graph, *initializer);
+      body.RemoveInitializedTensor(name);
+      hoisted_values.insert(std::move(name));
+    }
+
+    InlinedVector<NodeArg*> inputs;
+    inputs.reserve(node.InputDefs().size());
+    for (const NodeArg* input : node.InputDefs()) {
+      inputs.push_back(&graph.GetOrCreateNodeArg(input->Name(), input->TypeAsProto()));
+    }
+
+    InlinedVector<NodeArg*> outputs;
+    outputs.reserve(node.OutputDefs().size());
+    for (const NodeArg* output : node.OutputDefs()) {
+      outputs.push_back(&graph.GetOrCreateNodeArg(output->Name(), output->TypeAsProto()));
+      if (output->Exists()) {
+        hoisted_values.insert(output->Name());
+      }
+    }
+
+    Node& hoisted_node = graph.AddNode(graph.GenerateNodeName(node.Name()), node.OpType(), node.Description(),
+                                       inputs, outputs, &node.GetAttributes(), node.Domain());
+    hoisted_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // the consumers in the body now read the outputs from outer scope. the edges to them are recreated as
+    // implicit inputs of the Loop or Scan node when the graph is resolved.
+    graph_utils::RemoveNodeOutputEdges(body, node);
+    body.RemoveNode(node.Index());
+    modified = true;
+  }
+
+  return modified;
+}
+
+}  // namespace
+
+Status LoopInvariantCodeMotion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+
+    // hoist out of nested loops first so their invariant nodes can move further out from this level.
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (node.Domain() != kOnnxDomain || (node.OpType() != "Loop" && node.OpType() != "Scan")) {
+      continue;
+    }
+
+    const auto& subgraphs = node.GetAttributeNameToMutableSubgraphMap();
+    auto body = subgraphs.find("body");
+    if (body != subgraphs.end() &&
+        HoistInvariantNodes(graph, *body->second, RunsAtLeastOnce(graph, node), GetCompatibleExecutionProviders())) {
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LoopInvariantCodeMotion
+
+Moves nodes of Loop and Scan bodies whose inputs do not change between iterations into the graph containing the
+Loop or Scan node, so they are computed once instead of in every iteration. A node is invariant if each of its
+inputs is an initializer of the body, a value from outer scope, or the output of another invariant node.
+Their outputs, and the body initializers they use, are consumed by the body as outer scope values.
+
+Moved nodes run even if the body does not. Unless the trip count of the Loop is a constant of at least one, or the
+scan axis of the Scan has a static size of at least one, only nodes that cannot fail at run time are moved, such as
+unary elementwise ops and broadcasting binary ops with static input shapes.
+
+If bodies are left alone, as moving their nodes would compute values for the branch that is not taken.
+*/
+class LoopInvariantCodeMotion : public GraphTransformer {
+ public:
+  LoopInvariantCodeMotion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LoopInvariantCodeMotion", compatible_execution_providers) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
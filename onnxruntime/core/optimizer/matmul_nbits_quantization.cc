@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_quantization.h"
+
+#include <limits>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas_q4.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr int kQBits = 4;
+
+// The quantized weight, scales and zero points that replace one MatMul weight initializer.
+struct QuantizedWeight {
+  NodeArg* data;
+  NodeArg* scales;
+  NodeArg* zero_points;
+};
+
+// The weight is [K, N], or [N, K] if trans_b is set.
+template <typename T>
+QuantizedWeight QuantizeWeight(Graph& graph, const std::string& name, const Initializer& weight, bool trans_b,
+                               int block_size, bool is_symmetric, int K, int N) {
+  const T* weight_data = weight.data<T>();
+  std::vector<T> transposed;
+  if (trans_b) {
+    transposed.resize(static_cast<size_t>(K) * N);
+    for (int n = 0; n < N; ++n) {
+      for (int k = 0; k < K; ++k) {
+        transposed[static_cast<size_t>(k) * N + n] = weight_data[static_cast<size_t>(n) * K + k];
+      }
+    }
+    weight_data = transposed.data();
+  }
+
+  size_t data_size = 0;
+  size_t scale_count = 0;
+  size_t zero_point_size = 0;
+  MlasBlockwiseQuantizedBufferSizes(kQBits, block_size, /* columnwise */ true, K, N,
+                                    data_size, scale_count, is_symmetric ? nullptr : &zero_point_size);
+
+  std::vector<uint8_t> data(data_size);
+  std::vector<T> scales(scale_count);
+  std::vector<uint8_t> zero_points(zero_point_size);
+
+  // There is no intra-op thread pool while the graph is being optimized.
+  MlasQuantizeBlockwise<T, kQBits>(data.data(), scales.data(), is_symmetric ? nullptr : zero_points.data(),
+                                   weight_data, block_size, /* columnwise */ true, K, N, N, nullptr);
+
+  // The layout of the MatMulNBits inputs: B is [N, k_blocks, blob_size], scales and zero points are flattened.
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = static_cast<int64_t>(block_size) * kQBits / 8;
+
+  TensorProto data_proto;
+  data_proto.set_name(graph.GenerateNodeArgName(name + "_Q4"));
+  data_proto.set_data_type(TensorProto_DataType_UINT8);
+  data_proto.add_dims(N);
+  data_proto.add_dims(k_blocks);
+  data_proto.add_dims(blob_size);
+  utils::SetRawDataInTensorProto(data_proto, data.data(), data.size());
+
+  TensorProto scales_proto;
+  scales_proto.set_name(graph.GenerateNodeArgName(name + "_scales"));
+  scales_proto.set_data_type(weight.data_type());
+  scales_proto.add_dims(static_cast<int64_t>(scales.size()));
+  utils::SetRawDataInTensorProto(scales_proto, scales.data(), scales.size() * sizeof(T));
+
+  QuantizedWeight quantized{&graph_utils::AddInitializer(graph, data_proto),
+                            &graph_utils::AddInitializer(graph, scales_proto),
+                            nullptr};
+
+  if (!is_symmetric) {
+    TensorProto zero_points_proto;
+    zero_points_proto.set_name(graph.GenerateNodeArgName(name + "_zero_points"));
+    zero_points_proto.set_data_type(TensorProto_DataType_UINT8);
+    zero_points_proto.add_dims(static_cast<int64_t>(zero_points.size()));
+    utils::SetRawDataInTensorProto(zero_points_proto, zero_points.data(), zero_points.size());
+    quantized.zero_points = &graph_utils::AddInitializer(graph, zero_points_proto);
+  }
+
+  return quantized;
+}
+
+// Returns the input C of a Gemm node as the [N] bias of MatMulNBits, or nullptr if it cannot be one.
+// A constant [1, N] bias is copied to a [N] initializer.
+NodeArg* GetGemmBiasForMatMulNBits(Graph& graph, Node& gemm, int64_t N) {
+  NodeArg* bias = gemm.MutableInputDefs()[2];
+  const auto* shape = bias->Shape();
+  if (shape == nullptr) {
+    return nullptr;
+  }
+
+  auto dim_has_value = [](const TensorShapeProto_Dimension& dim, int64_t value) {
+    return dim.has_dim_value() && dim.dim_value() == value;
+  };
+
+  if (shape->dim_size() == 1 && dim_has_value(shape->dim(0), N)) {
+    return bias;
+  }
+
+  if (shape->dim_size() == 2 && dim_has_value(shape->dim(0), 1) && dim_has_value(shape->dim(1), N)) {
+    const TensorProto* bias_proto = graph_utils::GetConstantInitializer(graph, bias->Name());
+    if (bias_proto == nullptr) {
+      return nullptr;
+    }
+
+    TensorProto bias_1d_proto(*bias_proto);
+    bias_1d_proto.set_name(graph.GenerateNodeArgName(bias->Name() + "_1d"));
+    bias_1d_proto.clear_dims();
+    bias_1d_proto.add_dims(N);
+    return &graph_utils::AddInitializer(graph, bias_1d_proto);
+  }
+
+  return nullptr;
+}
+
+}  // namespace
+
+MatMulNBitsQuantization::MatMulNBitsQuantization(int64_t block_size, bool is_symmetric, int64_t accuracy_level,
+                                                 const InlinedHashSet<std::string_view>& compatible_execution_providers)
+    : GraphTransformer("MatMulNBitsQuantization", compatible_execution_providers),
+      block_size_(block_size),
+      is_symmetric_(is_symmetric),
+      accuracy_level_(accuracy_level) {
+  ORT_ENFORCE(block_size_ >= 16 && block_size_ <= 256 && (block_size_ & (block_size_ - 1)) == 0,
+              "MatMulNBits quantization block size must be a power of 2 in [16, 256]. Got: ", block_size_);
+  ORT_ENFORCE(accuracy_level_ >= 0 && accuracy_level_ <= 4,
+              "MatMulNBits quantization accuracy level must be in [0, 4]. Got: ", accuracy_level_);
+}
+
+Status MatMulNBitsQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // A weight shared by several MatMul nodes is only quantized once.
+  InlinedHashMap<std::string, QuantizedWeight> quantized_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    // Level1 MatMulAddFusion has already turned 2D MatMul + Add into Gemm, so Gemm nodes that are a plain
+    // MatMul with an optional [N] bias are quantized too.
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11, 13});
+    if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    bool trans_b = false;
+    bool has_bias = false;
+    if (is_gemm) {
+      const auto& attrs = node.GetAttributes();
+      auto get_int = [&attrs](const char* name, int64_t default_value) {
+        auto it = attrs.find(name);
+        return it != attrs.end() ? it->second.i() : default_value;
+      };
+      auto get_float = [&attrs](const char* name, float default_value) {
+        auto it = attrs.find(name);
+        return it != attrs.end() ? it->second.f() : default_value;
+      };
+
+      trans_b = get_int("transB", 0) != 0;
+      has_bias = node.InputDefs().size() > 2 && node.InputDefs()[2]->Exists();
+      if (get_int("transA", 0) != 0 || get_float("alpha", 1.0f) != 1.0f ||
+          (has_bias && get_float("beta", 1.0f) != 1.0f)) {
+        continue;
+      }
+
+      // The CUDA MatMulNBits kernel does not add the bias input.
+      if (has_bias && node.GetExecutionProviderType() == kCudaExecutionProvider) {
+        continue;
+      }
+    }
+
+    const NodeArg& weight_arg = *node.InputDefs()[1];
+    const TensorProto* weight_proto = graph_utils::GetConstantInitializer(graph, weight_arg.Name());
+    if (weight_proto == nullptr || weight_proto->dims_size() != 2) {
+      continue;
+    }
+
+    // The CPU MatMulNBits kernel only has an fp32 implementation.
+    const auto data_type = weight_proto->data_type();
+    if (data_type != TensorProto_DataType_FLOAT &&
+        !(data_type == TensorProto_DataType_FLOAT16 && node.GetExecutionProviderType() != kCpuExecutionProvider)) {
+      continue;
+    }
+
+    // Skip weights that do not fill a single block, there is nothing to gain from quantizing them.
+    const int64_t K = weight_proto->dims(trans_b ? 1 : 0);
+    const int64_t N = weight_proto->dims(trans_b ? 0 : 1);
+    if (K < block_size_ || N == 0 || K > std::numeric_limits<int>::max() || N > std::numeric_limits<int>::max()) {
+      continue;
+    }
+
+    NodeArg* bias = nullptr;
+    if (has_bias) {
+      bias = GetGemmBiasForMatMulNBits(graph, node, N);
+      if (bias == nullptr) {
+        continue;
+      }
+    }
+
+    // A weight used both as is and transposed is quantized once for each.
+    const std::string weight_key = trans_b ? weight_arg.Name() + "/transB" : weight_arg.Name();
+    auto it = quantized_weights.find(weight_key);
+    if (it == quantized_weights.end()) {
+      Initializer weight{*weight_proto, graph.ModelPath()};
+      const int block_size = static_cast<int>(block_size_);
+      QuantizedWeight quantized =
+          data_type == TensorProto_DataType_FLOAT
+              ? QuantizeWeight<float>(graph, weight_arg.Name(), weight, trans_b, block_size, is_symmetric_,
+                                      static_cast<int>(K), static_cast<int>(N))
+              : QuantizeWeight<MLFloat16>(graph, weight_arg.Name(), weight, trans_b, block_size, is_symmetric_,
+                                          static_cast<int>(K), static_cast<int>(N));
+      it = quantized_weights.emplace(weight_key, quantized).first;
+    }
+
+    const QuantizedWeight& quantized = it->second;
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    InlinedVector<NodeArg*> inputs{node.MutableInputDefs()[0], quantized.data, quantized.scales};
+    if (quantized.zero_points != nullptr || bias != nullptr) {
+      inputs.push_back(quantized.zero_points != nullptr ? quantized.zero_points : &empty_arg);
+    }
+    if (bias != nullptr) {
+      inputs.push_back(&empty_arg);  // g_idx
+      inputs.push_back(bias);
+    }
+
+    Node& matmul_nbits = graph.AddNode(graph.GenerateNodeName(node.Name() + "_MatMulNBits"), "MatMulNBits",
+                                       "MatMul with weight quantized at load time", inputs, node.MutableOutputDefs(),
+                                       nullptr, kMSDomain);
+    matmul_nbits.AddAttribute("K", K);
+    matmul_nbits.AddAttribute("N", N);
+    matmul_nbits.AddAttribute("bits", static_cast<int64_t>(kQBits));
+    matmul_nbits.AddAttribute("block_size", block_size_);
+    matmul_nbits.AddAttribute("accuracy_level", accuracy_level_);
+    matmul_nbits.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // The original weight initializer is removed by graph resolve once it has no consumers left.
+    graph_utils::FinalizeNodeFusion(graph, {node}, matmul_nbits);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * Quantizes the constant weight of MatMul and Gemm nodes to 4 bits at load time, replacing
+ *   MatMul(A, B) -> MatMulNBits(A, quantized B, scales[, zero_points])
+ *   Gemm(A, B[, C]) -> MatMulNBits(A, quantized B, scales[, zero_points][, bias = C])
+ *
+ * Gemm nodes are matched because MatMulAddFusion turns 2D MatMul + Add into Gemm before this
+ * transformer runs. They must have transA = 0 and alpha = 1. A bias must have shape [N] or [1, N]
+ * and beta = 1, and Gemm nodes with a bias are left alone on CUDA, whose MatMulNBits kernel does
+ * not add it. transB = 1 weights are transposed before they are quantized.
+ *
+ * B must be a 2D fp32 or fp16 initializer. It is quantized blockwise along K, in the
+ * same layout as the offline matmul_4bits_quantizer, so the MatMulNBits kernel pre-packs
+ * it exactly as it would a pre-quantized model.
+ *
+ * Note: This trades accuracy for weight memory and bandwidth. It is only enabled
+ * through the session options.
+ */
+class MatMulNBitsQuantization : public GraphTransformer {
+ public:
+  /**
+   * Constructor.
+   * @param block_size The number of elements along K sharing a scale. A power of 2, at least 16.
+   * @param is_symmetric Whether the weights are quantized without zero points.
+   * @param accuracy_level The accuracy_level attribute of the created MatMulNBits nodes.
+   * @param compatible_execution_providers The compatible execution providers.
+   */
+  MatMulNBitsQuantization(int64_t block_size, bool is_symmetric, int64_t accuracy_level,
+                          const InlinedHashSet<std::string_view>& compatible_execution_providers = {});
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const int64_t block_size_;
+  const bool is_symmetric_;
+  const int64_t accuracy_level_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/mixed_precision_transformer.h"
+
+#include <cmath>
+
+#include "core/framework/data_types.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// the ops that are converted to fp16 if the CPU EP has an fp16 kernel for them, and whether they are compute bound.
+// other ops stay in fp32, either because they are sensitive to the reduced range and precision of fp16 or because
+// the CPU EP has no fp16 kernel for them, e.g. MatMul.
+struct AllowedOp {
+  std::string_view op_type;
+  bool compute_bound;
+};
+
+constexpr AllowedOp kAllowedOps[] = {
+    {"Conv", true},
+    {"Gemm", true},
+    {"AveragePool", false},
+    {"GlobalAveragePool", false},
+    {"LeakyRelu", false},
+    {"MaxPool", false},
+    {"Relu", false},
+};
+
+const AllowedOp* FindAllowedOp(const Node& node) {
+  if (node.Domain() != kOnnxDomain) {
+    return nullptr;
+  }
+
+  for (const auto& op : kAllowedOps) {
+    if (op.op_type == node.OpType()) {
+      return &op;
+    }
+  }
+
+  return nullptr;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// values that are finite in fp32 must stay finite in fp16.
+bool IsInFp16Range(const Initializer& initializer) {
+  constexpr float kFp16Max = 65504.0f;
+  for (float value : initializer.DataAsSpan<float>()) {
+    if (std::isfinite(value) && std::abs(value) > kFp16Max) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the fp16 Gemm kernel only uses MlasHalfGemmBatch without transposes, with alpha and beta of 1 and a bias of shape
+// [N], [1, N] or [N, 1]. other Gemms fall back to Eigen, which is much slower than the fp32 MLAS Gemm.
+bool IsMlasHalfGemm(const Node& node) {
+  const auto* trans_a = graph_utils::GetNodeAttribute(node, "transA");
+  const auto* trans_b = graph_utils::GetNodeAttribute(node, "transB");
+  const auto* alpha = graph_utils::GetNodeAttribute(node, "alpha");
+  const auto* beta = graph_utils::GetNodeAttribute(node, "beta");
+  if ((trans_a != nullptr && trans_a->i() != 0) || (trans_b != nullptr && trans_b->i() != 0) ||
+      (alpha != nullptr && alpha->f() != 1.0f) || (beta != nullptr && beta->f() != 1.0f)) {
+    return false;
+  }
+
+  // without a bias the kernel sets beta to 0, which also leaves the MLAS path.
+  const auto& inputs = node.InputDefs();
+  if (inputs.size() < 3 || !inputs[2]->Exists()) {
+    return false;
+  }
+
+  const auto* b_shape = inputs[1]->Shape();
+  const auto* c_shape = inputs[2]->Shape();
+  if (b_shape == nullptr || b_shape->dim_size() != 2 || !b_shape->dim(1).has_dim_value() || c_shape == nullptr) {
+    return false;
+  }
+  const int64_t n = b_shape->dim(1).dim_value();
+  auto dim_is = [c_shape](int index, int64_t value) {
+    return c_shape->dim(index).has_dim_value() && c_shape->dim(index).dim_value() == value;
+  };
+  return (c_shape->dim_size() == 1 && dim_is(0, n)) ||
+         (c_shape->dim_size() == 2 && ((dim_is(0, 1) && dim_is(1, n)) || (dim_is(0, n) && dim_is(1, 1))));
+}
+
+NodeArg& CreateFp16NodeArg(Graph& graph, const NodeArg& arg) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_fp16"), &type);
+}
+
+void AddCast(Graph& graph, NodeArg& input, NodeArg& output, TensorProto_DataType to) {
+  Node& cast = graph.AddNode(graph.GenerateNodeName("MixedPrecisionCast_" + input.Name()), "Cast",
+                             "Cast at the boundary of an fp16 region", {&input}, {&output});
+  cast.AddAttribute("to", static_cast<int64_t>(to));
+  cast.SetExecutionProviderType(kCpuExecutionProvider);
+}
+
+}  // namespace
+
+bool MixedPrecisionTransformer::IsConvertible(const Graph& graph, const Node& node) const {
+  if (FindAllowedOp(node) == nullptr ||
+      excluded_op_types_.count(node.OpType()) > 0 ||
+      node.GetExecutionProviderType() != kCpuExecutionProvider ||
+      node.InputDefs().empty() ||
+      !IsFloatTensor(*node.InputDefs()[0])) {
+    return false;
+  }
+
+  if (node.OpType() == "Gemm" && !IsMlasHalfGemm(node)) {
+    return false;
+  }
+
+  // all outputs are converted, so skip nodes with other outputs, e.g. MaxPool with Indices.
+  for (const NodeArg* output : node.OutputDefs()) {
+    if (output->Exists() && !IsFloatTensor(*output)) {
+      return false;
+    }
+  }
+
+  for (const NodeArg* input : node.InputDefs()) {
+    if (!IsFloatTensor(*input)) {
+      continue;
+    }
+
+    const auto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false);
+    if (initializer != nullptr && !IsInFp16Range(Initializer{*initializer, graph.ModelPath()})) {
+      return false;
+    }
+  }
+
+  const KernelCreateInfo* kernel_create_info = nullptr;
+  const auto status = cpu_kernel_registry_->TryFindKernel(
+      node, kCpuExecutionProvider, {{"T", DataTypeImpl::GetTensorType<MLFloat16>()}}, &kernel_create_info);
+  return status.IsOK() && kernel_create_info != nullptr;
+}
+
+Status MixedPrecisionTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashSet<NodeIndex> convertible;
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (IsConvertible(graph, node)) {
+      convertible.insert(node_index);
+    }
+  }
+
+  // group the convertible nodes into connected regions and keep the regions with a compute bound node.
+  InlinedHashSet<NodeIndex> converted;
+  InlinedHashSet<NodeIndex> visited;
+  for (auto node_index : node_topology_list) {
+    if (convertible.count(node_index) == 0 || !visited.insert(node_index).second) {
+      continue;
+    }
+
+    InlinedVector<NodeIndex> region{node_index};
+    bool compute_bound = false;
+    auto visit = [&](const Node& neighbor) {
+      if (convertible.count(neighbor.Index()) > 0 && visited.insert(neighbor.Index()).second) {
+        region.push_back(neighbor.Index());
+      }
+    };
+
+    for (size_t i = 0; i < region.size(); ++i) {
+      const Node& node = *graph.GetNode(region[i]);
+      compute_bound = compute_bound || FindAllowedOp(node)->compute_bound;
+      for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+        visit(*it);
+      }
+      for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+        visit(*it);
+      }
+    }
+
+    if (compute_bound) {
+      converted.insert(region.begin(), region.end());
+    }
+  }
+
+  // the fp16 replacements of the fp32 values read or written by converted nodes. each value is converted once, so a
+  // value entering or leaving a region gets a single Cast and a constant initializer a single fp16 copy.
+  InlinedHashMap<std::string, NodeArg*> fp16_values;
+
+  for (auto node_index : node_topology_list) {
+    if (converted.count(node_index) == 0) {
+      continue;
+    }
+
+    Node& node = *graph.GetNode(node_index);
+    auto& output_defs = node.MutableOutputDefs();
+
+    // outputs consumed by nodes outside of the region or returned by the graph are cast back to fp32.
+    InlinedVector<bool> consumed_in_fp32(output_defs.size(), false);
+    for (size_t i = 0; i < output_defs.size(); ++i) {
+      consumed_in_fp32[i] = graph.IsOutput(output_defs[i]);
+    }
+    for (auto edge = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); edge != end; ++edge) {
+      if (converted.count(edge->GetNode().Index()) == 0) {
+        consumed_in_fp32[edge->GetSrcArgIndex()] = true;
+      }
+    }
+
+    // the edges are recreated for the new values when the graph is resolved.
+    graph_utils::GraphEdge::RemoveGraphEdges(graph, graph_utils::GraphEdge::GetNodeInputEdges(node));
+    graph_utils::GraphEdge::RemoveGraphEdges(graph, graph_utils::GraphEdge::GetNodeOutputEdges(node));
+
+    for (NodeArg*& input : node.MutableInputDefs()) {
+      if (!IsFloatTensor(*input)) {
+        continue;
+      }
+
+      auto fp16_value = fp16_values.find(input->Name());
+      if (fp16_value == fp16_values.end()) {
+        NodeArg* fp16_input = nullptr;
+        const auto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false);
+        if (initializer != nullptr) {
+          Initializer fp32_initializer{*initializer, graph.ModelPath()};
+          fp16_input = &graph_utils::AddInitializer(
+              graph, fp32_initializer.ToFP16(graph.GenerateNodeArgName(input->Name() + "_fp16")));
+        } else {
+          fp16_input = &CreateFp16NodeArg(graph, *input);
+          AddCast(graph, *input, *fp16_input, TensorProto_DataType_FLOAT16);
+        }
+        fp16_value = fp16_values.emplace(input->Name(), fp16_input).first;
+      }
+
+      input = fp16_value->second;
+    }
+
+    for (size_t i = 0; i < output_defs.size(); ++i) {
+      NodeArg*& output = output_defs[i];
+      if (!output->Exists()) {
+        continue;
+      }
+
+      NodeArg& fp16_output = CreateFp16NodeArg(graph, *output);
+      if (consumed_in_fp32[i]) {
+        AddCast(graph, fp16_output, *output, TensorProto_DataType_FLOAT);
+      }
+      fp16_values.emplace(output->Name(), &fp16_output);
+      output = &fp16_output;
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+
+#include "core/framework/kernel_registry.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MixedPrecisionTransformer
+
+Converts regions of fp32 nodes assigned to the CPU EP to fp16 to halve the size of the activations they read and write.
+
+Only ops on an allow list are converted, and only when the CPU EP has an fp16 kernel for the node. Ops that are
+numerically sensitive to the range and precision of fp16 (Softmax, normalizations, reductions, Exp/Log, ...) are not
+on the list and stay in fp32, as do nodes with a constant initializer input that is out of the fp16 range.
+Gemm is only converted when the fp16 kernel can use MLAS: no transposes, alpha and beta of 1 and a bias of one row.
+Connected convertible nodes form a region. A region is only converted if it contains a compute bound node (Conv,
+Gemm) as the Casts would otherwise cost more than they save. Constant initializers of a region are converted
+to fp16 initializers, and a single Cast is inserted per value entering or leaving the region.
+
+  X -> Conv(W) -> Relu -> MaxPool -> Softmax   ==>
+  X -> Cast(fp16) -> Conv(W_fp16) -> Relu -> MaxPool -> Cast(fp32) -> Softmax
+*/
+class MixedPrecisionTransformer : public GraphTransformer {
+ public:
+  MixedPrecisionTransformer(std::shared_ptr<KernelRegistry> cpu_kernel_registry,
+                            InlinedHashSet<std::string> excluded_op_types = {}) noexcept
+      : GraphTransformer("MixedPrecisionTransformer", {kCpuExecutionProvider}),
+        cpu_kernel_registry_(std::move(cpu_kernel_registry)),
+        excluded_op_types_(std::move(excluded_op_types)) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool IsConvertible(const Graph& graph, const Node& node) const;
+
+  std::shared_ptr<KernelRegistry> cpu_kernel_registry_;
+  InlinedHashSet<std::string> excluded_op_types_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/ml_preprocessing_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Appends the float parameters of a step in the layout of FusedMLPreprocessing, and its norm for a Normalizer.
+// Returns false if the node cannot be fused.
+bool GetStepParameters(const Node& node, std::vector<float>& parameters, std::vector<std::string>& norms) {
+  const auto& op_type = node.OpType();
+  if (op_type == "Imputer") {
+    const auto* imputed_values = graph_utils::GetNodeAttribute(node, "imputed_value_floats");
+    const auto* replaced_value = graph_utils::GetNodeAttribute(node, "replaced_value_float");
+    if (imputed_values == nullptr || imputed_values->floats_size() == 0 || replaced_value == nullptr) {
+      return false;
+    }
+    parameters.push_back(replaced_value->f());
+    parameters.insert(parameters.end(), imputed_values->floats().begin(), imputed_values->floats().end());
+    return true;
+  }
+
+  if (op_type == "Scaler") {
+    const auto* offset = graph_utils::GetNodeAttribute(node, "offset");
+    const auto* scale = graph_utils::GetNodeAttribute(node, "scale");
+    if (offset == nullptr || scale == nullptr || scale->floats_size() == 0 ||
+        offset->floats_size() != scale->floats_size()) {
+      return false;
+    }
+    parameters.insert(parameters.end(), offset->floats().begin(), offset->floats().end());
+    parameters.insert(parameters.end(), scale->floats().begin(), scale->floats().end());
+    return true;
+  }
+
+  if (op_type == "Normalizer") {
+    const auto* norm = graph_utils::GetNodeAttribute(node, "norm");
+    if (norm == nullptr || (norm->s() != "MAX" && norm->s() != "L1" && norm->s() != "L2")) {
+      return false;
+    }
+    norms.push_back(norm->s());
+    return true;
+  }
+
+  if (op_type == "Binarizer") {
+    const auto* threshold = graph_utils::GetNodeAttribute(node, "threshold");
+    parameters.push_back(threshold != nullptr ? threshold->f() : 1.0f);
+    return true;
+  }
+
+  return false;
+}
+
+bool IsFusionCandidate(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  static const std::vector<std::string> supported_data_types{"tensor(float)"};
+  if (!(graph_utils::IsSupportedOptypeVersionAndDomain(node, "Imputer", {1}, kMLDomain) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Scaler", {1}, kMLDomain) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Normalizer", {1}, kMLDomain) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Binarizer", {1}, kMLDomain)) ||
+      !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      !optimizer_utils::IsSupportedDataType(node, supported_data_types)) {
+    return false;
+  }
+
+  // The kernels of these operators treat a tensor of rank 1 or 2 as rows of features. Other ranks are left alone.
+  const TensorShapeProto* shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr || shape->dim_size() < 1 || shape->dim_size() > 2) {
+    return false;
+  }
+
+  std::vector<float> parameters;
+  std::vector<std::string> norms;
+  return GetStepParameters(node, parameters, norms);
+}
+
+}  // namespace
+
+Status MLPreprocessingFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashSet<NodeIndex> visited;
+  std::vector<InlinedVector<Node*>> chains;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (visited.count(node.Index()) > 0 || !IsFusionCandidate(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // The nodes are visited in topological order, so the first candidate of a chain is its head.
+    InlinedVector<Node*> chain{&node};
+    visited.insert(node.Index());
+    while (optimizer_utils::CheckOutputEdges(graph, *chain.back(), 1)) {
+      Node& next = *graph.GetNode(chain.back()->OutputNodesBegin()->Index());
+      if (visited.count(next.Index()) > 0 || !IsFusionCandidate(next, GetCompatibleExecutionProviders()) ||
+          next.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+      chain.push_back(&next);
+      visited.insert(next.Index());
+    }
+
+    if (chain.size() > 1) {
+      chains.push_back(std::move(chain));
+    }
+  }
+
+  for (const auto& chain : chains) {
+    std::vector<std::string> steps;
+    std::vector<float> parameters;
+    std::vector<int64_t> parameter_sizes;
+    std::vector<std::string> norms;
+    for (const Node* node : chain) {
+      const size_t size = parameters.size();
+      GetStepParameters(*node, parameters, norms);
+      steps.push_back(node->OpType());
+      parameter_sizes.push_back(static_cast<int64_t>(parameters.size() - size));
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(chain.back()->Name() + "/MLPreprocessingFusion/"),
+                                     "FusedMLPreprocessing", "fused ML preprocessing operators",
+                                     {chain.front()->MutableInputDefs()[0]}, {chain.back()->MutableOutputDefs()[0]},
+                                     nullptr, kMSDomain);
+    fused_node.AddAttribute("steps", gsl::span<const std::string>(steps));
+    fused_node.AddAttribute("parameters", gsl::span<const float>(parameters));
+    fused_node.AddAttribute("parameter_sizes", gsl::span<const int64_t>(parameter_sizes));
+    if (!norms.empty()) {
+      fused_node.AddAttribute("norms", gsl::span<const std::string>(norms));
+    }
+    fused_node.SetExecutionProviderType(chain.front()->GetExecutionProviderType());
+
+    for (Node* node : chain) {
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
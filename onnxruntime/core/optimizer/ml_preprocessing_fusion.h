@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MLPreprocessingFusion
+
+Fuse chains of row-wise ai.onnx.ml preprocessing operators on fp32 data, as exported from scikit-learn pipelines,
+into a single com.microsoft.FusedMLPreprocessing node:
+
+  X -> Imputer -> Scaler -> Normalizer -> Binarizer -> Y
+
+Any sequence of Imputer (float values), Scaler, Normalizer and Binarizer of at least two nodes is fused, when X is
+a float tensor of rank 1 or 2 and each intermediate value has no other consumer. The fused kernel processes the rows
+block by block through the whole chain and in parallel, so no intermediate tensor is allocated.
+*/
+class MLPreprocessingFusion : public GraphTransformer {
+ public:
+  MLPreprocessingFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MLPreprocessingFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -43,8 +43,9 @@ NhwcConvLookup(
   return &(iter->second);
 }
 
-NhwcTransformer::NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry) noexcept
-    : GraphTransformer("NhwcTransformer"), cpu_allocator_(std::move(cpu_allocator)) {
+NhwcTransformer::NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry,
+                                 bool enable_fp32) noexcept
+    : GraphTransformer("NhwcTransformer"), cpu_allocator_(std::move(cpu_allocator)), enable_fp32_(enable_fp32) {
   if (!cpu_kernel_registry) {
     // This is a CPU op nodes optimizer, not useful if cpu EP is not available.
     return;
@@ -164,6 +165,81 @@ NhwcTransformer::NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<Ker
           OpTransformInfo{nhwc_gavgpool_fp16.op_type_, nhwc_gavgpool_fp16.domain_, nhwc_gavgpool_fp16.version_, false});
     }
   }
+
+  if (enable_fp32) {
+    // fp32 ops are only converted on request, by default they are left to the NCHWc transformer.
+    {
+      // fp32 conv -> fp32 nhwc conv
+      OpKernelRegistryId nhwc_conv_fp32{
+          "NhwcFusedConv", kMSDomain, 1, {{"T", {DataTypeImpl::GetTensorType<float>()}}}};
+
+      const KernelCreateInfo* kernel_create_info{};
+      const auto status = cpu_kernel_registry->TryFindKernel(
+          kCpuExecutionProvider, nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_,
+          nhwc_conv_fp32.version_, nhwc_conv_fp32.type_constraints_, &kernel_create_info);
+      if (status.IsOK() && kernel_create_info != nullptr) {
+        kernel_create_info = nullptr;
+        conv_table_.emplace(
+            OpIdInfo("Conv", kOnnxDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_, nhwc_conv_fp32.version_, false});
+        conv_table_.emplace(
+            OpIdInfo("FusedConv", kMSDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_, nhwc_conv_fp32.version_, false});
+      }
+    }
+
+    {
+      // fp32 MaxPool -> fp32 nhwc MaxPool
+      OpKernelRegistryId nhwc_maxpool_fp32{
+          "MaxPool", kMSInternalNHWCDomain, 12, {{"T", {DataTypeImpl::GetTensorType<float>()}}}};
+
+      const KernelCreateInfo* kernel_create_info{};
+      const auto status = cpu_kernel_registry->TryFindKernel(
+          kCpuExecutionProvider, nhwc_maxpool_fp32.op_type_, nhwc_maxpool_fp32.domain_,
+          nhwc_maxpool_fp32.version_, nhwc_maxpool_fp32.type_constraints_, &kernel_create_info);
+      if (status.IsOK() && kernel_create_info != nullptr) {
+        kernel_create_info = nullptr;
+        conv_table_.emplace(
+            OpIdInfo("MaxPool", kOnnxDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_maxpool_fp32.op_type_, nhwc_maxpool_fp32.domain_, nhwc_maxpool_fp32.version_, false});
+      }
+    }
+
+    {
+      // fp32 AveragePool -> fp32 nhwc AveragePool
+      OpKernelRegistryId nhwc_avgpool_fp32{
+          "AveragePool", kMSInternalNHWCDomain, 11, {{"T", {DataTypeImpl::GetTensorType<float>()}}}};
+
+      const KernelCreateInfo* kernel_create_info{};
+      const auto status = cpu_kernel_registry->TryFindKernel(
+          kCpuExecutionProvider, nhwc_avgpool_fp32.op_type_, nhwc_avgpool_fp32.domain_,
+          nhwc_avgpool_fp32.version_, nhwc_avgpool_fp32.type_constraints_, &kernel_create_info);
+      if (status.IsOK() && kernel_create_info != nullptr) {
+        kernel_create_info = nullptr;
+        conv_table_.emplace(
+            OpIdInfo("AveragePool", kOnnxDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_avgpool_fp32.op_type_, nhwc_avgpool_fp32.domain_, nhwc_avgpool_fp32.version_, false});
+      }
+    }
+
+    {
+      // fp32 GlobalAveragePool -> fp32 nhwc GlobalAveragePool
+      OpKernelRegistryId nhwc_gavgpool_fp32{
+          "GlobalAveragePool", kMSInternalNHWCDomain, 1, {{"T", {DataTypeImpl::GetTensorType<float>()}}}};
+
+      const KernelCreateInfo* kernel_create_info{};
+      const auto status = cpu_kernel_registry->TryFindKernel(
+          kCpuExecutionProvider, nhwc_gavgpool_fp32.op_type_, nhwc_gavgpool_fp32.domain_,
+          nhwc_gavgpool_fp32.version_, nhwc_gavgpool_fp32.type_constraints_, &kernel_create_info);
+      if (status.IsOK() && kernel_create_info != nullptr) {
+        kernel_create_info = nullptr;
+        conv_table_.emplace(
+            OpIdInfo("GlobalAveragePool", kOnnxDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_gavgpool_fp32.op_type_, nhwc_gavgpool_fp32.domain_, nhwc_gavgpool_fp32.version_,
+                            false});
+      }
+    }
+  }
 };
 
 Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -200,6 +276,14 @@ Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       continue;
     }
 
+    // Skip MaxPool that produces the Indices output, the NHWC kernels only compute the pooled values
+    if (node->OpType() == "MaxPool") {
+      const auto outputs = node->Outputs();
+      if (outputs.size() > 1 && !outputs[1].empty()) {
+        continue;
+      }
+    }
+
     // Skip if unknown rank
     auto shape = NodeFromApiNode(*node).InputDefs()[0]->Shape();
     if (shape == nullptr) {
@@ -228,7 +312,8 @@ Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
   }
 
   if (modified) {
-    Optimize(*api_graph, kCpuExecutionProvider, OrtEPCostCheck, OrtExtendedHandlers());
+    Optimize(*api_graph, kCpuExecutionProvider, enable_fp32_ ? OrtEPCostCheckFp32Nhwc : OrtEPCostCheck,
+             OrtExtendedHandlers());
   }
 
   return Status::OK();
@@ -71,11 +71,16 @@ namespace onnxruntime {
 
 Transformer that optimizes the graph by using NHWC nodes instead of NCHW nodes
 and inserts nodes to transpose tensors as needed.
+
+Quantized and fp16 operators are always converted when their NHWC kernels are
+available. fp32 Conv, FusedConv and pooling operators are only converted when
+enable_fp32 is set, as they are otherwise handled by the NchwcTransformer.
 */
 class NhwcTransformer : public GraphTransformer {
  private:
  public:
-  explicit NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry) noexcept;
+  explicit NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry,
+                           bool enable_fp32 = false) noexcept;
 
   /**
    * @brief Usually called right after constructor, it shows whether
@@ -91,6 +96,7 @@ class NhwcTransformer : public GraphTransformer {
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
   AllocatorPtr cpu_allocator_;
+  bool enable_fp32_;
 
   /**
    * A mapping table to identify operators that need to be transformed, and map
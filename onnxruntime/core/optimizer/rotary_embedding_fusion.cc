@@ -0,0 +1,349 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/rotary_embedding_fusion.h"
+
+#include <cstring>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+bool GetConstantInt(const Graph& graph, const NodeArg* arg, int64_t& value) {
+  InlinedVector<int64_t> values;
+  if (arg == nullptr || !arg->Exists() || !optimizer_utils::AppendTensorFromInitializer(graph, *arg, values) ||
+      values.size() != 1) {
+    return false;
+  }
+  value = values[0];
+  return true;
+}
+
+const NodeArg* GetInput(const Node& node, size_t index) {
+  return index < node.InputDefs().size() && node.InputDefs()[index]->Exists() ? node.InputDefs()[index] : nullptr;
+}
+
+bool IsSingleConsumerNode(const Graph& graph, const Node& node) {
+  return optimizer_utils::CheckOutputEdges(graph, node, 1);
+}
+
+// Matches a Slice with step 1 of `axis` of its input and returns the start and end.
+bool MatchSlice(const Graph& graph, const Node& slice, int64_t axis, int64_t rank, int64_t& start, int64_t& end) {
+  int64_t slice_axis = 0;
+  int64_t step = 1;
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(slice, "Slice", {10, 11, 13}) ||
+      !GetConstantInt(graph, GetInput(slice, 1), start) ||
+      !GetConstantInt(graph, GetInput(slice, 2), end) ||
+      !GetConstantInt(graph, GetInput(slice, 3), slice_axis) ||
+      (GetInput(slice, 4) != nullptr && !GetConstantInt(graph, GetInput(slice, 4), step))) {
+    return false;
+  }
+  return step == 1 && (slice_axis == axis || slice_axis + rank == axis);
+}
+
+// Matches rotate_half(x) = Concat(Neg(x2), x1) where x1 and x2 are the halves of the last axis of x, taken with
+// Slice nodes or a Split. Returns x and appends the matched nodes.
+const NodeArg* MatchRotateHalf(const Graph& graph, const Node& concat, int64_t head_size,
+                               InlinedVector<const Node*>& nodes) {
+  constexpr int64_t rank = 4;
+  const int64_t half = head_size / 2;
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(concat, "Concat", {4, 11, 13}) ||
+      concat.InputDefs().size() != 2 || !IsSingleConsumerNode(graph, concat)) {
+    return nullptr;
+  }
+  const auto* axis_attr = graph_utils::GetNodeAttribute(concat, "axis");
+  if (axis_attr == nullptr || (axis_attr->i() != -1 && axis_attr->i() != rank - 1)) {
+    return nullptr;
+  }
+
+  const Node* neg = graph.GetProducerNode(concat.InputDefs()[0]->Name());
+  const Node* first_half = graph.GetProducerNode(concat.InputDefs()[1]->Name());
+  if (neg == nullptr || first_half == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*neg, "Neg", {6, 13}) || !IsSingleConsumerNode(graph, *neg)) {
+    return nullptr;
+  }
+  const Node* second_half = graph.GetProducerNode(neg->InputDefs()[0]->Name());
+  if (second_half == nullptr) {
+    return nullptr;
+  }
+
+  const NodeArg* x = first_half->InputDefs()[0];
+  if (first_half->OpType() == "Split") {
+    // both halves come from the same Split with two equal outputs.
+    if (first_half != second_half || first_half->OutputDefs().size() != 2 ||
+        concat.InputDefs()[1] != first_half->OutputDefs()[0] || neg->InputDefs()[0] != first_half->OutputDefs()[1] ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*first_half, "Split", {2, 11, 13, 18}) ||
+        !optimizer_utils::CheckOutputEdges(graph, *first_half, 2)) {
+      return nullptr;
+    }
+    const auto* split_axis = graph_utils::GetNodeAttribute(*first_half, "axis");
+    if (split_axis == nullptr || (split_axis->i() != -1 && split_axis->i() != rank - 1)) {
+      return nullptr;
+    }
+    InlinedVector<int64_t> split_sizes;
+    const auto* split_attr = graph_utils::GetNodeAttribute(*first_half, "split");
+    if (split_attr != nullptr) {
+      split_sizes.assign(split_attr->ints().begin(), split_attr->ints().end());
+    } else if (GetInput(*first_half, 1) != nullptr &&
+               !optimizer_utils::AppendTensorFromInitializer(graph, *GetInput(*first_half, 1), split_sizes)) {
+      return nullptr;
+    }
+    if (!split_sizes.empty() && (split_sizes.size() != 2 || split_sizes[0] != half || split_sizes[1] != half)) {
+      return nullptr;
+    }
+    nodes.push_back(first_half);
+  } else {
+    int64_t first_start = 0, first_end = 0, second_start = 0, second_end = 0;
+    if (second_half->InputDefs()[0] != x ||
+        !MatchSlice(graph, *first_half, rank - 1, rank, first_start, first_end) ||
+        !MatchSlice(graph, *second_half, rank - 1, rank, second_start, second_end) ||
+        first_start != 0 || first_end != half || second_start != half || second_end < head_size ||
+        !IsSingleConsumerNode(graph, *first_half) || !IsSingleConsumerNode(graph, *second_half)) {
+      return nullptr;
+    }
+    nodes.push_back(first_half);
+    nodes.push_back(second_half);
+  }
+
+  nodes.push_back(neg);
+  nodes.push_back(&concat);
+  return x;
+}
+
+// Matches Unsqueeze(Gather(cache, position_ids), axis 1), optionally with a Slice of the rows of the cache before the
+// Gather, and returns the cache and position_ids.
+bool MatchCache(const Graph& graph, const NodeArg& arg, const TensorProto*& cache, const NodeArg*& position_ids) {
+  const Node* unsqueeze = graph.GetProducerNode(arg.Name());
+  if (unsqueeze == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*unsqueeze, "Unsqueeze", {1, 11, 13})) {
+    return false;
+  }
+  InlinedVector<int64_t> axes;
+  if (const auto* axes_attr = graph_utils::GetNodeAttribute(*unsqueeze, "axes"); axes_attr != nullptr) {
+    axes.assign(axes_attr->ints().begin(), axes_attr->ints().end());
+  } else if (GetInput(*unsqueeze, 1) == nullptr ||
+             !optimizer_utils::AppendTensorFromInitializer(graph, *GetInput(*unsqueeze, 1), axes)) {
+    return false;
+  }
+  if (axes.size() != 1 || axes[0] != 1) {
+    return false;
+  }
+
+  const Node* gather = graph.GetProducerNode(unsqueeze->InputDefs()[0]->Name());
+  if (gather == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*gather, "Gather", {1, 11, 13})) {
+    return false;
+  }
+  const auto* gather_axis = graph_utils::GetNodeAttribute(*gather, "axis");
+  if (gather_axis != nullptr && gather_axis->i() != 0) {
+    return false;
+  }
+
+  // slicing the first rows of the cache does not change the rows the valid position ids gather.
+  const NodeArg* cache_arg = gather->InputDefs()[0];
+  if (const Node* slice = graph.GetProducerNode(cache_arg->Name()); slice != nullptr) {
+    int64_t start = 0, end = 0;
+    if (!MatchSlice(graph, *slice, 0, 2, start, end) || start != 0) {
+      return false;
+    }
+    cache_arg = slice->InputDefs()[0];
+  }
+
+  cache = graph_utils::GetConstantInitializer(graph, cache_arg->Name());
+  position_ids = gather->InputDefs()[1];
+  return cache != nullptr && cache->dims_size() == 2 &&
+         position_ids->TypeAsProto() != nullptr &&
+         position_ids->TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_INT64;
+}
+
+bool SameDim(const TensorShapeProto_Dimension& a, const TensorShapeProto_Dimension& b) {
+  return (a.has_dim_value() && b.has_dim_value() && a.dim_value() == b.dim_value()) ||
+         (a.has_dim_param() && b.has_dim_param() && a.dim_param() == b.dim_param());
+}
+
+// Returns the first half of each row of `cache` as an initializer, or nullptr if the halves of a row differ.
+NodeArg* GetHalfCache(Graph& graph, const TensorProto& cache, InlinedHashMap<std::string, NodeArg*>& half_caches) {
+  auto it = half_caches.find(cache.name());
+  if (it != half_caches.end()) {
+    return it->second;
+  }
+
+  Initializer initializer{cache, graph.ModelPath()};
+  const auto bytes = initializer.DataAsByteSpan();
+  const size_t rows = gsl::narrow<size_t>(cache.dims(0));
+  const size_t row_size = rows == 0 ? 0 : bytes.size() / rows;
+  const size_t half_row_size = row_size / 2;
+
+  std::string half_data(rows * half_row_size, '\0');
+  for (size_t row = 0; row < rows; ++row) {
+    const uint8_t* row_data = bytes.data() + row * row_size;
+    if (std::memcmp(row_data, row_data + half_row_size, half_row_size) != 0) {
+      half_caches[cache.name()] = nullptr;
+      return nullptr;
+    }
+    std::memcpy(half_data.data() + row * half_row_size, row_data, half_row_size);
+  }
+
+  TensorProto half_cache;
+  half_cache.set_name(graph.GenerateNodeArgName(cache.name() + "_half"));
+  half_cache.set_data_type(cache.data_type());
+  half_cache.add_dims(cache.dims(0));
+  half_cache.add_dims(cache.dims(1) / 2);
+  utils::SetRawDataInTensorProto(half_cache, std::move(half_data));
+
+  NodeArg* half_cache_arg = &graph_utils::AddInitializer(graph, half_cache);
+  half_caches[cache.name()] = half_cache_arg;
+  return half_cache_arg;
+}
+
+}  // namespace
+
+Status RotaryEmbeddingFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the caches converted to the half format, by the name of the original cache. q and k share them.
+  InlinedHashMap<std::string, NodeArg*> half_caches;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& add_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(add_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7, 13, 14}) ||
+        !graph_utils::IsSupportedProvider(add_node, GetCompatibleExecutionProviders()) ||
+        add_node.GetInputEdgesCount() != 2) {
+      continue;
+    }
+
+    const Node* mul_nodes[2] = {graph.GetProducerNode(add_node.InputDefs()[0]->Name()),
+                                graph.GetProducerNode(add_node.InputDefs()[1]->Name())};
+    if (mul_nodes[0] == nullptr || mul_nodes[1] == nullptr || mul_nodes[0] == mul_nodes[1] ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*mul_nodes[0], "Mul", {7, 13, 14}) ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*mul_nodes[1], "Mul", {7, 13, 14}) ||
+        !IsSingleConsumerNode(graph, *mul_nodes[0]) || !IsSingleConsumerNode(graph, *mul_nodes[1])) {
+      continue;
+    }
+
+    // find the Mul with rotate_half(x), it is multiplied with sin.
+    const NodeArg* x = nullptr;
+    const NodeArg* cos = nullptr;
+    const NodeArg* sin = nullptr;
+    InlinedVector<const Node*> nodes_to_remove;
+    for (int rotated = 0; rotated < 2 && x == nullptr; ++rotated) {
+      const Node& rotated_mul = *mul_nodes[rotated];
+      const Node& plain_mul = *mul_nodes[1 - rotated];
+      for (int i = 0; i < 2 && x == nullptr; ++i) {
+        const Node* concat = graph.GetProducerNode(rotated_mul.InputDefs()[i]->Name());
+        const NodeArg* plain_input = plain_mul.InputDefs()[0];
+        const NodeArg* plain_other = plain_mul.InputDefs()[1];
+        const auto* shape = plain_input->Shape();
+        if (concat == nullptr || shape == nullptr || shape->dim_size() != 4) {
+          continue;
+        }
+        const auto& head_dim = shape->dim(3);
+        if (!head_dim.has_dim_value() || head_dim.dim_value() % 2 != 0) {
+          continue;
+        }
+
+        nodes_to_remove.clear();
+        const NodeArg* rotated_input = MatchRotateHalf(graph, *concat, head_dim.dim_value(), nodes_to_remove);
+        if (rotated_input == nullptr) {
+          continue;
+        }
+        if (rotated_input != plain_input) {
+          std::swap(plain_input, plain_other);
+        }
+        if (rotated_input == plain_input) {
+          x = rotated_input;
+          cos = plain_other;
+          sin = rotated_mul.InputDefs()[1 - i];
+        }
+      }
+    }
+
+    if (x == nullptr) {
+      continue;
+    }
+
+    const TensorProto* cos_cache = nullptr;
+    const TensorProto* sin_cache = nullptr;
+    const NodeArg* position_ids = nullptr;
+    const NodeArg* sin_position_ids = nullptr;
+    const auto& x_shape = *x->Shape();
+    const int64_t head_size = x_shape.dim(3).dim_value();
+    if (!MatchCache(graph, *cos, cos_cache, position_ids) ||
+        !MatchCache(graph, *sin, sin_cache, sin_position_ids) ||
+        position_ids != sin_position_ids ||
+        cos_cache->dims(1) != head_size || sin_cache->dims(1) != head_size ||
+        cos_cache->data_type() != x->TypeAsProto()->tensor_type().elem_type() ||
+        sin_cache->data_type() != cos_cache->data_type() || cos_cache->dims(0) != sin_cache->dims(0)) {
+      continue;
+    }
+
+    // RotaryEmbedding takes position ids of shape (batch_size, sequence_length).
+    const auto* position_ids_shape = position_ids->Shape();
+    if (position_ids_shape == nullptr || position_ids_shape->dim_size() != 2 ||
+        !SameDim(position_ids_shape->dim(0), x_shape.dim(0)) || !SameDim(position_ids_shape->dim(1), x_shape.dim(2))) {
+      continue;
+    }
+
+    NodeArg* cos_half = GetHalfCache(graph, *cos_cache, half_caches);
+    NodeArg* sin_half = GetHalfCache(graph, *sin_cache, half_caches);
+    if (cos_half == nullptr || sin_half == nullptr) {
+      continue;
+    }
+
+    const Node* cos_unsqueeze = graph.GetProducerNode(cos->Name());
+    const Node* sin_unsqueeze = graph.GetProducerNode(sin->Name());
+
+    InlinedVector<NodeArg*> rotary_input_defs{graph.GetNodeArg(x->Name()), graph.GetNodeArg(position_ids->Name()),
+                                              cos_half, sin_half};
+    Node& rotary_node = graph.AddNode(graph.GenerateNodeName(add_node.Name() + "/RotaryEmbeddingFusion/"),
+                                      "RotaryEmbedding", "fused rotary position embedding", rotary_input_defs, {}, {},
+                                      kMSDomain);
+    rotary_node.AddAttribute("interleaved", static_cast<int64_t>(0));
+    rotary_node.SetExecutionProviderType(add_node.GetExecutionProviderType());
+
+    // connect position_ids now, so their producer is kept when the Gathers consuming them are removed below.
+    if (const Node* position_ids_producer = graph.GetProducerNode(position_ids->Name());
+        position_ids_producer != nullptr) {
+      graph.AddEdge(position_ids_producer->Index(), rotary_node.Index(),
+                    optimizer_utils::IndexOfNodeOutput(*position_ids_producer, *position_ids), 1);
+    }
+
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse;
+    for (const Node* node : nodes_to_remove) {
+      nodes_to_fuse.push_back(*graph.GetNode(node->Index()));
+    }
+    nodes_to_fuse.push_back(*graph.GetNode(mul_nodes[0]->Index()));
+    nodes_to_fuse.push_back(*graph.GetNode(mul_nodes[1]->Index()));
+    nodes_to_fuse.push_back(add_node);
+
+    // the first node of the list is the start of rotate_half, whose input edge from x is moved to the fused node.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, rotary_node);
+
+    // the cos and sin computations are shared by q and k, remove them once they are no longer used.
+    for (const Node* unsqueeze : {cos_unsqueeze, sin_unsqueeze}) {
+      if (unsqueeze->GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(*unsqueeze)) {
+        graph_utils::RemoveNodesWithOneOutputBottomUp(graph, *unsqueeze);
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
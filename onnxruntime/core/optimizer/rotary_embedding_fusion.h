@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class RotaryEmbeddingFusion
+
+Fuses the rotary position embedding of LLaMA style decoders exported from PyTorch into a RotaryEmbedding node.
+
+  x * cos + rotate_half(x) * sin
+  rotate_half(x) = Concat(Neg(x[..., head_size / 2:]), x[..., :head_size / 2])
+  cos = Unsqueeze(Gather(cos_cache, position_ids), 1), sin = Unsqueeze(Gather(sin_cache, position_ids), 1)
+
+x is (batch_size, num_heads, sequence_length, head_size), the halves of x are taken with two Slice nodes or a Split,
+and the rows of the cache may be sliced before the Gather. The caches must be constant initializers of shape
+(max_sequence_length, head_size) where both halves of each row are equal, as they are built as
+concat(freqs, freqs). They are replaced with their first halves, the format RotaryEmbedding expects.
+*/
+class RotaryEmbeddingFusion : public GraphTransformer {
+ public:
+  RotaryEmbeddingFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("RotaryEmbeddingFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,475 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/symbolic_shape_folding.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// The value of one element of a shape tensor: coefficient * product(symbols).
+// A symbol is the dim_param of an inferred dim, or "<tensor name>:<axis>" for a dim that has neither a value nor a
+// dim_param. Two elements with the same coefficient and symbols are equal at runtime.
+struct DimExpr {
+  bool known{false};
+  int64_t coefficient{1};
+  std::vector<std::string> symbols;  // sorted
+
+  static DimExpr Constant(int64_t value) {
+    DimExpr expr;
+    expr.known = true;
+    expr.coefficient = value;
+    return expr;
+  }
+
+  static DimExpr Symbol(std::string symbol) {
+    DimExpr expr;
+    expr.known = true;
+    expr.symbols.push_back(std::move(symbol));
+    return expr;
+  }
+
+  bool IsConstant() const { return known && symbols.empty(); }
+
+  bool operator==(const DimExpr& other) const {
+    return known && other.known && coefficient == other.coefficient && symbols == other.symbols;
+  }
+};
+
+using ShapeValue = std::vector<DimExpr>;
+
+bool MultiplyOverflows(int64_t a, int64_t b) {
+  return a != 0 && (b == std::numeric_limits<int64_t>::min() || a == std::numeric_limits<int64_t>::min() ||
+                    std::abs(b) > std::numeric_limits<int64_t>::max() / std::abs(a));
+}
+
+DimExpr Multiply(const DimExpr& a, const DimExpr& b) {
+  if (!a.known || !b.known || MultiplyOverflows(a.coefficient, b.coefficient)) {
+    return {};
+  }
+
+  DimExpr result;
+  result.known = true;
+  result.coefficient = a.coefficient * b.coefficient;
+  std::merge(a.symbols.begin(), a.symbols.end(), b.symbols.begin(), b.symbols.end(),
+             std::back_inserter(result.symbols));
+  return result;
+}
+
+// Only divisions that are exact for any value of the symbols are folded. Integer division truncates otherwise.
+DimExpr Divide(const DimExpr& a, const DimExpr& b) {
+  if (!a.known || !b.known || b.coefficient == 0 || a.coefficient % b.coefficient != 0) {
+    return {};
+  }
+
+  DimExpr result;
+  result.known = true;
+  result.coefficient = a.coefficient / b.coefficient;
+  result.symbols = a.symbols;
+  for (const auto& symbol : b.symbols) {
+    auto it = std::find(result.symbols.begin(), result.symbols.end(), symbol);
+    if (it == result.symbols.end()) {
+      return {};
+    }
+    result.symbols.erase(it);
+  }
+  return result;
+}
+
+// Returns dim `axis` of `tensor`, using its inferred shape where available.
+DimExpr DimOf(const NodeArg& tensor, int64_t axis) {
+  const TensorShapeProto* shape = tensor.Shape();
+  if (shape == nullptr) {
+    // the dim can still be matched with another reference to the same dim of the same tensor.
+    return axis >= 0 ? DimExpr::Symbol(tensor.Name() + ":" + std::to_string(axis)) : DimExpr{};
+  }
+
+  const int64_t rank = shape->dim_size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  if (axis < 0 || axis >= rank) {
+    return {};
+  }
+
+  const auto& dim = shape->dim(static_cast<int>(axis));
+  if (utils::HasDimValue(dim)) {
+    return DimExpr::Constant(dim.dim_value());
+  }
+  if (utils::HasDimParam(dim)) {
+    return DimExpr::Symbol(dim.dim_param());
+  }
+  return DimExpr::Symbol(tensor.Name() + ":" + std::to_string(axis));
+}
+
+// Clamps a start or end index of a Slice on a 1D tensor of `size` elements.
+int64_t ClampSliceIndex(int64_t index, int64_t size) {
+  if (index < 0) {
+    index += size;
+  }
+  return std::clamp<int64_t>(index, 0, size);
+}
+
+bool GetSingleInitializerValue(const Graph& graph, const Node& node, size_t input_index, int64_t& value) {
+  const auto& input_defs = node.InputDefs();
+  InlinedVector<int64_t> values;
+  if (input_index >= input_defs.size() || !input_defs[input_index]->Exists() ||
+      !optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[input_index], values, true) ||
+      values.size() != 1) {
+    return false;
+  }
+  value = values[0];
+  return true;
+}
+
+// Derives the values of shape tensors computed by chains of shape manipulating nodes.
+class ShapeValueEvaluator {
+ public:
+  explicit ShapeValueEvaluator(const Graph& graph) : graph_(graph) {}
+
+  std::optional<ShapeValue> Evaluate(const NodeArg& arg) {
+    auto it = cache_.find(arg.Name());
+    if (it != cache_.end()) {
+      return it->second;
+    }
+
+    std::optional<ShapeValue> value = EvaluateImpl(arg);
+    cache_.emplace(arg.Name(), value);
+    return value;
+  }
+
+ private:
+  std::optional<ShapeValue> EvaluateImpl(const NodeArg& arg) {
+    const TensorProto* initializer = graph_utils::GetConstantInitializer(graph_, arg.Name());
+    if (initializer != nullptr) {
+      InlinedVector<int64_t> data;
+      if (initializer->dims_size() > 1 || !optimizer_utils::AppendTensorFromInitializer(graph_, arg, data, true)) {
+        return std::nullopt;
+      }
+
+      ShapeValue value;
+      value.reserve(data.size());
+      for (int64_t element : data) {
+        value.push_back(DimExpr::Constant(element));
+      }
+      return value;
+    }
+
+    const Node* producer = graph_.GetProducerNode(arg.Name());
+    if (producer == nullptr || producer->Domain() != kOnnxDomain) {
+      return std::nullopt;
+    }
+
+    const Node& node = *producer;
+    const std::string& op_type = node.OpType();
+    const auto& input_defs = node.InputDefs();
+
+    if (op_type == "Shape") {
+      return EvaluateShape(node);
+    }
+
+    if (op_type == "Identity" || op_type == "Squeeze" || op_type == "Unsqueeze") {
+      // scalars and single element 1D tensors are not distinguished, so these only pass the values through.
+      return Evaluate(*input_defs[0]);
+    }
+
+    if (op_type == "Cast") {
+      const auto* to = graph_utils::GetNodeAttribute(node, "to");
+      if (to == nullptr || to->i() != TensorProto_DataType_INT64) {
+        return std::nullopt;
+      }
+      return Evaluate(*input_defs[0]);
+    }
+
+    if (op_type == "Concat") {
+      const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+      if (axis == nullptr || (axis->i() != 0 && axis->i() != -1)) {
+        return std::nullopt;
+      }
+
+      ShapeValue value;
+      for (const NodeArg* input : input_defs) {
+        auto input_value = Evaluate(*input);
+        if (!input_value) {
+          return std::nullopt;
+        }
+        value.insert(value.end(), input_value->begin(), input_value->end());
+      }
+      return value;
+    }
+
+    if (op_type == "Gather") {
+      return EvaluateGather(node);
+    }
+
+    if (op_type == "Slice") {
+      return EvaluateSlice(node);
+    }
+
+    if (op_type == "Mul" || op_type == "Div" || op_type == "Add" || op_type == "Sub") {
+      return EvaluateBinary(node);
+    }
+
+    return std::nullopt;
+  }
+
+  std::optional<ShapeValue> EvaluateShape(const Node& shape) {
+    const NodeArg& input = *shape.InputDefs()[0];
+    const TensorShapeProto* input_shape = input.Shape();
+
+    int64_t start = 0;
+    std::optional<int64_t> end;
+    if (const auto* start_attr = graph_utils::GetNodeAttribute(shape, "start"); start_attr != nullptr) {
+      start = start_attr->i();
+    }
+    if (const auto* end_attr = graph_utils::GetNodeAttribute(shape, "end"); end_attr != nullptr) {
+      end = end_attr->i();
+    }
+
+    if (input_shape == nullptr) {
+      // the number of elements is unknown without the rank.
+      return std::nullopt;
+    }
+
+    const int64_t rank = input_shape->dim_size();
+    start = ClampSliceIndex(start, rank);
+    const int64_t stop = end ? ClampSliceIndex(*end, rank) : rank;
+
+    ShapeValue value;
+    for (int64_t axis = start; axis < stop; ++axis) {
+      value.push_back(DimOf(input, axis));
+    }
+    return value;
+  }
+
+  std::optional<ShapeValue> EvaluateGather(const Node& gather) {
+    const auto* axis = graph_utils::GetNodeAttribute(gather, "axis");
+    if (axis != nullptr && axis->i() != 0) {
+      return std::nullopt;
+    }
+
+    InlinedVector<int64_t> indices;
+    if (!optimizer_utils::AppendTensorFromInitializer(graph_, *gather.InputDefs()[1], indices, true)) {
+      return std::nullopt;
+    }
+
+    auto data = Evaluate(*gather.InputDefs()[0]);
+    if (!data) {
+      return std::nullopt;
+    }
+
+    const int64_t size = static_cast<int64_t>(data->size());
+    ShapeValue value;
+    value.reserve(indices.size());
+    for (int64_t index : indices) {
+      if (index < 0) {
+        index += size;
+      }
+      if (index < 0 || index >= size) {
+        return std::nullopt;
+      }
+      value.push_back((*data)[static_cast<size_t>(index)]);
+    }
+    return value;
+  }
+
+  std::optional<ShapeValue> EvaluateSlice(const Node& slice) {
+    int64_t start = 0;
+    int64_t end = 0;
+    int64_t axis = 0;
+    int64_t step = 1;
+    if (graph_utils::MatchesOpSinceVersion(slice, {1})) {
+      InlinedVector<int64_t> starts;
+      InlinedVector<int64_t> ends;
+      InlinedVector<int64_t> axes;
+      if (!graph_utils::GetRepeatedNodeAttributeValues(slice, "starts", starts) ||
+          !graph_utils::GetRepeatedNodeAttributeValues(slice, "ends", ends) ||
+          starts.size() != 1 || ends.size() != 1) {
+        return std::nullopt;
+      }
+      if (graph_utils::GetRepeatedNodeAttributeValues(slice, "axes", axes) && axes.size() != 1) {
+        return std::nullopt;
+      }
+      start = starts[0];
+      end = ends[0];
+      axis = axes.empty() ? 0 : axes[0];
+    } else {
+      if (!GetSingleInitializerValue(graph_, slice, 1, start) || !GetSingleInitializerValue(graph_, slice, 2, end)) {
+        return std::nullopt;
+      }
+
+      const auto& input_defs = slice.InputDefs();
+      if ((input_defs.size() > 3 && input_defs[3]->Exists() && !GetSingleInitializerValue(graph_, slice, 3, axis)) ||
+          (input_defs.size() > 4 && input_defs[4]->Exists() && !GetSingleInitializerValue(graph_, slice, 4, step))) {
+        return std::nullopt;
+      }
+    }
+
+    if ((axis != 0 && axis != -1) || step != 1) {
+      return std::nullopt;
+    }
+
+    auto data = Evaluate(*slice.InputDefs()[0]);
+    if (!data) {
+      return std::nullopt;
+    }
+
+    const int64_t size = static_cast<int64_t>(data->size());
+    start = ClampSliceIndex(start, size);
+    end = ClampSliceIndex(end, size);
+    return end > start ? ShapeValue(data->begin() + start, data->begin() + end) : ShapeValue{};
+  }
+
+  std::optional<ShapeValue> EvaluateBinary(const Node& node) {
+    auto a = Evaluate(*node.InputDefs()[0]);
+    auto b = Evaluate(*node.InputDefs()[1]);
+    if (!a || !b) {
+      return std::nullopt;
+    }
+
+    // only the broadcasting of a single element is supported.
+    const size_t size = std::max(a->size(), b->size());
+    if ((a->size() != size && a->size() != 1) || (b->size() != size && b->size() != 1)) {
+      return std::nullopt;
+    }
+
+    const std::string& op_type = node.OpType();
+    ShapeValue value;
+    value.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      const DimExpr& lhs = (*a)[a->size() == 1 ? 0 : i];
+      const DimExpr& rhs = (*b)[b->size() == 1 ? 0 : i];
+      if (op_type == "Mul") {
+        value.push_back(Multiply(lhs, rhs));
+      } else if (op_type == "Div") {
+        value.push_back(Divide(lhs, rhs));
+      } else if (lhs.IsConstant() && rhs.IsConstant()) {
+        // Add and Sub are only evaluated for constants, sums of symbols are not represented.
+        value.push_back(DimExpr::Constant(op_type == "Add" ? lhs.coefficient + rhs.coefficient
+                                                           : lhs.coefficient - rhs.coefficient));
+      } else {
+        value.push_back({});
+      }
+    }
+    return value;
+  }
+
+  const Graph& graph_;
+  InlinedHashMap<std::string, std::optional<ShapeValue>> cache_;
+};
+
+}  // namespace
+
+Status SymbolicShapeFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the values are cached by name. they stay valid as folding only removes nodes and adds new names.
+  ShapeValueEvaluator evaluator(graph);
+
+  int folded_count = 0;
+  for (auto node_index : node_topology_list) {
+    auto* p_reshape = graph.GetNode(node_index);
+    if (p_reshape == nullptr)
+      continue;  // node was removed
+
+    Node& reshape = *p_reshape;
+    ORT_RETURN_IF_ERROR(Recurse(reshape, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(reshape, "Reshape", {5, 13, 14, 19, 21}) ||
+        !graph_utils::IsSupportedProvider(reshape, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto* allow_zero = graph_utils::GetNodeAttribute(reshape, "allowzero");
+    if (allow_zero != nullptr && allow_zero->i() != 0) {
+      continue;
+    }
+
+    // the shape has to be computed by nodes, otherwise there is nothing to fold.
+    const NodeArg& data = *reshape.InputDefs()[0];
+    const NodeArg& shape = *reshape.InputDefs()[1];
+    const Node* p_shape_producer = graph_utils::GetInputNode(reshape, 1);
+    if (p_shape_producer == nullptr) {
+      continue;
+    }
+
+    auto shape_value = evaluator.Evaluate(shape);
+    if (!shape_value) {
+      continue;
+    }
+
+    InlinedVector<int64_t> folded_shape;
+    folded_shape.reserve(shape_value->size());
+    int inferred_dim_count = 0;
+    bool has_symbolic_dim = false;
+    for (size_t i = 0; i < shape_value->size(); ++i) {
+      const DimExpr& element = (*shape_value)[i];
+      if (element.IsConstant()) {
+        folded_shape.push_back(element.coefficient);
+        inferred_dim_count += element.coefficient == -1 ? 1 : 0;
+      } else if (element == DimOf(data, static_cast<int64_t>(i))) {
+        folded_shape.push_back(0);
+      } else {
+        folded_shape.push_back(-1);
+        ++inferred_dim_count;
+        has_symbolic_dim = true;
+      }
+    }
+
+    if (inferred_dim_count > 1) {
+      continue;
+    }
+
+    // -1 only gives back the symbolic dim if the other dims are known and non-zero. with a zero-size input, e.g.
+    // [P, B, H, D] reshaped to [P, B * H * D] with P == 0, the -1 of [0, -1] cannot be inferred.
+    if (has_symbolic_dim &&
+        std::any_of(folded_shape.begin(), folded_shape.end(), [](int64_t dim) { return dim == 0; })) {
+      continue;
+    }
+
+    TensorProto shape_initializer_proto;
+    shape_initializer_proto.set_name(graph.GenerateNodeArgName(shape.Name() + "_folded"));
+    shape_initializer_proto.add_dims(static_cast<int64_t>(folded_shape.size()));
+    shape_initializer_proto.set_data_type(TensorProto_DataType_INT64);
+    utils::SetRawDataInTensorProto(shape_initializer_proto, folded_shape.data(), folded_shape.size() * sizeof(int64_t));
+    NodeArg& shape_initializer_arg = graph_utils::AddInitializer(graph, shape_initializer_proto);
+
+    const Node& shape_producer = *p_shape_producer;
+    const int src_arg_index = graph_utils::GetNodeOutputIndexFromOutputName(shape_producer, shape.Name());
+    graph.RemoveEdge(shape_producer.Index(), reshape.Index(), src_arg_index, 1);
+    graph_utils::ReplaceNodeInput(reshape, 1, shape_initializer_arg);
+
+    // remove the shape computation if nothing else consumes it.
+    if (shape_producer.GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(shape_producer)) {
+      graph_utils::RemoveNodesWithOneOutputBottomUp(graph, shape_producer);
+    }
+
+    ++folded_count;
+    modified = true;
+  }
+
+  if (folded_count > 0) {
+    LOGS(logger, INFO) << "Total folded reshape shape count: " << folded_count;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
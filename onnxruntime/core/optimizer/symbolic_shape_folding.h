@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SymbolicShapeFolding
+
+Folds the shape computation feeding a Reshape into a constant shape initializer when the dims are symbolic.
+
+The value of the shape input is derived symbolically through Shape, Gather, Slice, Squeeze, Unsqueeze, Concat,
+Cast and Mul/Div/Add/Sub nodes. Each element is a product of known dims, dim_params of inferred shapes and dims of
+tensors without inferred shapes. An element that is provably equal to the same dim of the Reshape data input is
+replaced with 0, a constant element is kept, and at most one element that cannot be proven is replaced with -1.
+The shape computation is removed if the Reshape was its only consumer.
+
+  X -> Shape -> Gather(0) -> Unsqueeze \
+  X -> Shape -> Gather(1) -> Unsqueeze -> Concat -> Reshape(X, .)   ==>   Reshape(X, [0, 0, 12, 64])
+                         [12], [64]  /
+
+Reshape nodes with allowzero set are skipped since 0 does not copy the input dim for them.
+*/
+class SymbolicShapeFolding : public GraphTransformer {
+ public:
+  SymbolicShapeFolding(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SymbolicShapeFolding", compatible_execution_providers) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -156,9 +156,8 @@ const HandlerMap& OrtExtendedHandlers() {
   return extended_handler_map;
 }
 
-CostCheckResult OrtEPCostCheck(const api::GraphRef& graph, const api::NodeRef& node,
-                               const std::vector<int64_t>& /*perm*/,
-                               const std::unordered_set<std::string>& /*outputs_leading_to_transpose*/) {
+static CostCheckResult OrtEPCostCheckImpl(const api::GraphRef& graph, const api::NodeRef& node,
+                                          bool enable_fp32_nhwc) {
   // special case some kernels based on the ORT implementation details
   if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
     if (node.IsOp("MaxPool")) {
@@ -168,13 +167,16 @@ CostCheckResult OrtEPCostCheck(const api::GraphRef& graph, const api::NodeRef& n
 
     if (node.IsOp("Resize")) {
       // Resize is included because it has higher perf in the NHWC variant when
-      // the input X is 4D int8 tensor and the mode is linear
+      // the input X is 4D int8 tensor and the mode is linear. With the fp32 NHWC
+      // layout, float is included too so that Resize between NHWC convolutions
+      // does not split the NHWC chain.
       auto X_value_info = graph.GetValueInfo(node.Inputs()[0]);
       auto X_shape = X_value_info->Shape();
       auto X_dtype = X_value_info->DType();
       auto mode = node.GetAttributeString("mode");
       if (X_shape && X_shape->size() == 4 &&
-          (X_dtype == api::DataType::UINT8 || X_dtype == api::DataType::INT8) &&
+          (X_dtype == api::DataType::UINT8 || X_dtype == api::DataType::INT8 ||
+           (enable_fp32_nhwc && X_dtype == api::DataType::FLOAT)) &&
           mode && *mode == "linear") {
         return CostCheckResult::kPushTranspose;
       }
@@ -184,6 +186,18 @@ CostCheckResult OrtEPCostCheck(const api::GraphRef& graph, const api::NodeRef& n
   return CostCheckResult::kFallThrough;
 }
 
+CostCheckResult OrtEPCostCheck(const api::GraphRef& graph, const api::NodeRef& node,
+                               const std::vector<int64_t>& /*perm*/,
+                               const std::unordered_set<std::string>& /*outputs_leading_to_transpose*/) {
+  return OrtEPCostCheckImpl(graph, node, /*enable_fp32_nhwc*/ false);
+}
+
+CostCheckResult OrtEPCostCheckFp32Nhwc(const api::GraphRef& graph, const api::NodeRef& node,
+                                       const std::vector<int64_t>& /*perm*/,
+                                       const std::unordered_set<std::string>& /*outputs_leading_to_transpose*/) {
+  return OrtEPCostCheckImpl(graph, node, /*enable_fp32_nhwc*/ true);
+}
+
 static std::unique_ptr<api::NodeRef> SwapNodeImpl(api::GraphRef& graph, api::NodeRef& node,
                                                   std::string_view op_type, std::string_view domain,
                                                   std::optional<int> since_version) {
@@ -32,6 +32,16 @@ onnx_transpose_optimization::CostCheckResult OrtEPCostCheck(
     const std::vector<int64_t>& perm,
     const std::unordered_set<std::string>& outputs_leading_to_transpose);
 
+/// <summary>
+/// OrtEPCostCheck for graphs using the fp32 NHWC layout of the CPU EP. Linear 4D float Resize nodes also let
+/// transposes through, as their NHWC variant keeps the chain of NHWC convolutions in one layout.
+/// </summary>
+onnx_transpose_optimization::CostCheckResult OrtEPCostCheckFp32Nhwc(
+    const onnx_transpose_optimization::api::GraphRef& graph,
+    const onnx_transpose_optimization::api::NodeRef& node,
+    const std::vector<int64_t>& perm,
+    const std::unordered_set<std::string>& outputs_leading_to_transpose);
+
 /// <summary>
 /// Swaps out a node for a new copy of that node with the specified op type and domain.
 /// Current API does not allow nodes to have their op types or domains changed, so a new node is needed. All
@@ -4,6 +4,7 @@
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/math/matmul.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -163,6 +164,47 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+bool GemmPackBBlockSparse(AllocatorPtr& alloc,
+                          const Tensor& tensor_b,
+                          bool trans_b,
+                          float min_sparsity,
+                          IAllocatorUniquePtr<void>& packed_b,
+                          size_t& packed_b_size,
+                          TensorShape& b_shape) {
+  // Only handle the common case of a 2D weight matrix.
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  const float* b_data = tensor_b.Data<float>();
+
+  // Prefer taller blocks as they need fewer block indices, but fall back to single row
+  // blocks if the zeros are not structured enough.
+  for (size_t block_k : {4, 1}) {
+    packed_b_size = MlasBlockSparseGemmPackBSize(trans, N, K, b_data, trans_b ? K : N, block_k, min_sparsity);
+    if (packed_b_size == 0) {
+      continue;
+    }
+
+    packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+    auto* packed_b_data = packed_b.get();
+
+    // Initialize memory to 0 as there could be some padding associated with pre-packed
+    // buffer memory and we don not want it uninitialized and generate different hashes
+    // if and when we try to cache this pre-packed buffer for sharing between sessions.
+    memset(packed_b_data, 0, packed_b_size);
+    MlasBlockSparseGemmPackB(trans, N, K, b_data, trans_b ? K : N, block_k, packed_b_data);
+    return true;
+  }
+
+  return false;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -186,7 +228,16 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
     } else
 #endif
     {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      // The block sparse kernel does not support a transposed A.
+      if (block_sparse_min_sparsity_ > 0.0f && trans_a_attr_ == 0) {
+        is_packed = GemmPackBBlockSparse(alloc, tensor, trans_b_attr_ != 0, block_sparse_min_sparsity_,
+                                         packed_b_, packed_b_size, b_shape_);
+        packed_b_is_block_sparse_ = is_packed;
+      }
+
+      if (!is_packed) {
+        is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -211,6 +262,16 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+// TunableOp is only available when the kernel is run by the CPU EP, other EPs may reuse this kernel.
+static cpu::tunable::CpuTuningContext* GetCpuTuningContext(const OpKernelInfo& info) {
+  const auto* ep = info.GetExecutionProvider();
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+
+  return static_cast<cpu::tunable::CpuTuningContext*>(ep->GetTuningContext());
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -234,47 +295,70 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const auto* b_data = b ? b->Data<float>() : nullptr;
   auto* y_data = y->MutableData<float>();
 
-  const size_t max_len = helper.OutputOffsets().size();
+  auto* tuning_ctx = GetCpuTuningContext(Info());
+  if (tuning_ctx != nullptr && tuning_ctx->IsTunableOpEnabled()) {
+    return cpu::tunable::TunableMatMul(tuning_ctx, this, helper, trans_a, trans_b, a_data, b_data, y_data,
+                                       thread_pool);
+  }
+
+  ComputeGemm(helper, trans_a, trans_b, a_data, b_data, y_data, 0, helper.OutputOffsets().size(), thread_pool);
+  return Status::OK();
+}
+
+void MatMul<float>::ComputeGemm(const MatMulComputeHelper& helper, bool trans_a, bool trans_b,
+                                const float* a_data, const float* b_data, float* y_data,
+                                size_t batch_begin, size_t batch_end, concurrency::ThreadPool* thread_pool) const {
+  const size_t batch_count = batch_end - batch_begin;
   const size_t M = static_cast<size_t>(helper.M());
   const size_t N = static_cast<size_t>(helper.N());
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
+
+  if (packed_b_is_block_sparse_) {
+    for (size_t i = batch_begin; i < batch_end; i++) {
+      MlasBlockSparseGemm(M, N, K, alpha_attr_, a_data + helper.LeftOffsets()[i], lda, packed_b_.get(),
+                          y_data + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return;
+  }
+
 #if defined(__aarch64__) && defined(__linux__)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
-    std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
-    for (size_t i = 0; i < max_len; i++) {
+    std::vector<MLAS_SBGEMM_DATA_PARAMS> data(batch_count);
+    for (size_t i = 0; i < batch_count; i++) {
+      const size_t batch = batch_begin + i;
       data[i].BIsfp32 = !(bool(packed_b_));
       data[i].AIsfp32 = true;
-      data[i].A = a_data + helper.LeftOffsets()[i];
+      data[i].A = a_data + helper.LeftOffsets()[batch];
       data[i].lda = lda;
-      data[i].B = data[i].BIsfp32 ? b_data + helper.RightOffsets()[i] : (float*)packed_b_.get();
+      data[i].B = data[i].BIsfp32 ? b_data + helper.RightOffsets()[batch] : (float*)packed_b_.get();
       data[i].ldb = ldb;
-      data[i].C = y_data + helper.OutputOffsets()[i];
+      data[i].C = y_data + helper.OutputOffsets()[batch];
       data[i].ldc = N;
       data[i].Bias = nullptr;
       data[i].OutputProcessor = nullptr;
     }
-    MlasSBGemmBatch(M, N, K, max_len, data.data(), thread_pool);
+    MlasSBGemmBatch(M, N, K, batch_count, data.data(), thread_pool);
   } else
 #endif
   {
-    std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
-    for (size_t i = 0; i < max_len; i++) {
+    std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch_count);
+    for (size_t i = 0; i < batch_count; i++) {
+      const size_t batch = batch_begin + i;
       data[i].BIsPacked = bool(packed_b_);
-      data[i].A = a_data + helper.LeftOffsets()[i];
+      data[i].A = a_data + helper.LeftOffsets()[batch];
       data[i].lda = lda;
-      data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+      data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[batch];
       data[i].ldb = ldb;
-      data[i].C = y_data + helper.OutputOffsets()[i];
+      data[i].C = y_data + helper.OutputOffsets()[batch];
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
     MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+                  M, N, K, data.data(), batch_count, thread_pool);
   }
-  return Status::OK();
 }
 
 }  // namespace onnxruntime
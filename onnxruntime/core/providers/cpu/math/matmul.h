@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
@@ -34,6 +36,9 @@ class MatMul<float> final : public OpKernel {
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
 #endif
+
+    block_sparse_min_sparsity_ = ParseStringWithClassicLocale<float>(
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasBlockSparseGemmMinSparsity, "0"));
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -45,10 +50,26 @@ class MatMul<float> final : public OpKernel {
 
   Status Compute(OpKernelContext* context) const override;
 
+  // Runs the GEMMs of the batches in [batch_begin, batch_end) described by helper.
+  // b_data is ignored if B was pre-packed. Used by the TunableOp to try different thread partitionings.
+  void ComputeGemm(const MatMulComputeHelper& helper, bool trans_a, bool trans_b,
+                   const float* a_data, const float* b_data, float* y_data,
+                   size_t batch_begin, size_t batch_end, concurrency::ThreadPool* thread_pool) const;
+
+  // 'D'ense, 'P'acked or block 'S'parse B, as the fastest GEMM strategy differs between them.
+  char PackedBKind() const {
+    return packed_b_is_block_sparse_ ? 'S' : (packed_b_ ? 'P' : 'D');
+  }
+
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // B is pre-packed in the MLAS block sparse format rather than the SGEMM format.
+  // Only used when B has enough all-zero blocks, see kOrtSessionOptionsMlasBlockSparseGemmMinSparsity.
+  float block_sparse_min_sparsity_;
+  bool packed_b_is_block_sparse_{false};
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
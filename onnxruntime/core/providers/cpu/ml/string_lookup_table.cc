@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/string_lookup_table.h"
+
+#include <cstring>
+
+namespace onnxruntime {
+namespace ml {
+
+namespace {
+
+constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// Number of keys hashed ahead of their probe in FindBatch.
+constexpr size_t kPrefetchDistance = 16;
+
+inline void Prefetch(const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address);
+#else
+  ORT_UNUSED_PARAMETER(address);
+#endif
+}
+
+inline uint64_t Rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+}  // namespace
+
+uint64_t StringLookupTable::Hash(std::string_view key) {
+  // Word at a time multiply-rotate, followed by the MurmurHash3 finalizer so that both the low bits (group) and the
+  // high bits (tag) depend on every byte.
+  constexpr uint64_t kMul1 = 0x9E3779B97F4A7C15ULL;
+  constexpr uint64_t kMul2 = 0xC2B2AE3D27D4EB4FULL;
+
+  const char* data = key.data();
+  size_t size = key.size();
+  uint64_t hash = kMul2 ^ (static_cast<uint64_t>(size) * kMul1);
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, 8);
+    hash = Rotl((hash ^ word) * kMul1, 31) * kMul2;
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, size);
+    hash = Rotl((hash ^ word) * kMul1, 31) * kMul2;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+void StringLookupTable::Reserve(size_t num_keys) {
+  // keep the load factor at or below 1/2
+  size_t num_slots = 2 * kGroupSize;
+  while (num_slots < 2 * num_keys) {
+    num_slots *= 2;
+  }
+  if (num_slots > tags_.size()) {
+    Rehash(num_slots);
+  }
+}
+
+void StringLookupTable::Rehash(size_t num_slots) {
+  tags_.assign(num_slots, 0);
+  slot_entries_.assign(num_slots, 0);
+  for (uint32_t entry = 0; entry < static_cast<uint32_t>(entries_.size()); ++entry) {
+    InsertSlot(entry, Hash(Key(entry)));
+  }
+}
+
+void StringLookupTable::InsertSlot(uint32_t entry, uint64_t hash) {
+  const size_t group_mask = tags_.size() / kGroupSize - 1;
+  for (size_t group = FirstGroup(hash);; group = (group + 1) & group_mask) {
+    for (size_t slot = group * kGroupSize; slot < (group + 1) * kGroupSize; ++slot) {
+      if (tags_[slot] == 0) {
+        tags_[slot] = Tag(hash);
+        slot_entries_[slot] = entry;
+        return;
+      }
+    }
+  }
+}
+
+std::pair<uint32_t, bool> StringLookupTable::Insert(std::string_view key) {
+  if (tags_.empty()) {
+    Rehash(2 * kGroupSize);
+  }
+
+  const uint64_t hash = Hash(key);
+  const uint32_t found = Find(key, hash);
+  if (found != kNotFound) {
+    return {found, false};
+  }
+
+  ORT_ENFORCE(arena_.size() + key.size() <= std::numeric_limits<uint32_t>::max() && entries_.size() < kNotFound,
+              "The vocabulary is too large.");
+  if (2 * (entries_.size() + 1) > tags_.size()) {
+    Rehash(2 * tags_.size());
+  }
+
+  const auto entry = static_cast<uint32_t>(entries_.size());
+  entries_.push_back({static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(key.size())});
+  arena_.insert(arena_.end(), key.begin(), key.end());
+  InsertSlot(entry, hash);
+  return {entry, true};
+}
+
+uint32_t StringLookupTable::Find(std::string_view key, uint64_t hash) const {
+  if (tags_.empty()) {
+    return kNotFound;
+  }
+
+  const uint8_t tag = Tag(hash);
+  const uint64_t pattern = kLowBits * tag;
+  const size_t group_mask = tags_.size() / kGroupSize - 1;
+  for (size_t group = FirstGroup(hash);; group = (group + 1) & group_mask) {
+    const uint8_t* group_tags = tags_.data() + group * kGroupSize;
+    uint64_t word;
+    std::memcpy(&word, group_tags, kGroupSize);
+
+    // A byte of x is 0 where the tag matches. The test has false positives, but no false negatives, and the
+    // candidates are checked below.
+    const uint64_t x = word ^ pattern;
+    if (((x - kLowBits) & ~x & kHighBits) != 0) {
+      for (size_t i = 0; i < kGroupSize; ++i) {
+        if (group_tags[i] == tag) {
+          const uint32_t entry = slot_entries_[group * kGroupSize + i];
+          if (Key(entry) == key) {
+            return entry;
+          }
+        }
+      }
+    }
+
+    // the high bit of the tag of an occupied slot is set, a group with an empty slot ends the probe sequence
+    if ((~word & kHighBits) != 0) {
+      return kNotFound;
+    }
+  }
+}
+
+void StringLookupTable::FindBatch(const std::string* keys, size_t count, uint32_t* entry_indices) const {
+  if (tags_.empty()) {
+    std::fill_n(entry_indices, count, kNotFound);
+    return;
+  }
+
+  uint64_t hashes[kPrefetchDistance];
+  for (size_t start = 0; start < count; start += kPrefetchDistance) {
+    const size_t batch_size = std::min(kPrefetchDistance, count - start);
+    for (size_t i = 0; i < batch_size; ++i) {
+      hashes[i] = Hash(keys[start + i]);
+      const size_t slot = FirstGroup(hashes[i]) * kGroupSize;
+      Prefetch(tags_.data() + slot);
+      Prefetch(slot_entries_.data() + slot);
+    }
+    for (size_t i = 0; i < batch_size; ++i) {
+      entry_indices[start + i] = Find(keys[start + i], hashes[i]);
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
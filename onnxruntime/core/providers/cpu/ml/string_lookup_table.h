@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+/**
+Compact hash table from strings to the index of their entry, for the vocabularies of LabelEncoder and CategoryMapper.
+
+The bytes of the keys are stored back to back in a single arena, and the table is open addressing over groups of
+8 slots. Each slot has a 1 byte tag made of 7 bits of the hash, and the tags of a group are compared to the tag of
+the key at once with 64 bit word operations, so the key bytes are only compared when a tag matches. An entry costs
+its key bytes plus about 18 bytes, instead of a node or slot holding a std::string.
+
+Keys are added with Insert while the owning kernel is constructed. The table is not modified afterwards and lookups
+may run concurrently.
+*/
+class StringLookupTable {
+ public:
+  static constexpr uint32_t kNotFound = std::numeric_limits<uint32_t>::max();
+
+  // Sizes the table for num_keys keys so that inserting them does not rehash.
+  void Reserve(size_t num_keys);
+
+  // Adds key if it is not in the table yet. Returns the index of its entry and true if it was added.
+  // Entries are numbered in the order their keys were first inserted.
+  std::pair<uint32_t, bool> Insert(std::string_view key);
+
+  size_t Size() const { return entries_.size(); }
+
+  static uint64_t Hash(std::string_view key);
+
+  uint32_t Find(std::string_view key) const { return Find(key, Hash(key)); }
+
+  // Find with the precomputed Hash(key).
+  uint32_t Find(std::string_view key, uint64_t hash) const;
+
+  // entry_indices[i] = Find(keys[i]). The hashes of a small batch of keys are computed and their groups prefetched
+  // before the batch is probed, which overlaps the cache misses of large tables.
+  void FindBatch(const std::string* keys, size_t count, uint32_t* entry_indices) const;
+
+ private:
+  static constexpr size_t kGroupSize = 8;
+
+  struct Entry {
+    uint32_t offset;  // in arena_
+    uint32_t length;
+  };
+
+  static uint8_t Tag(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
+  size_t FirstGroup(uint64_t hash) const { return static_cast<size_t>(hash) & (tags_.size() / kGroupSize - 1); }
+  std::string_view Key(uint32_t entry) const {
+    return std::string_view(arena_.data() + entries_[entry].offset, entries_[entry].length);
+  }
+
+  void Rehash(size_t num_slots);
+  void InsertSlot(uint32_t entry, uint64_t hash);
+
+  std::vector<char> arena_;
+  std::vector<Entry> entries_;
+  std::vector<uint8_t> tags_;            // 0 for an empty slot
+  std::vector<uint32_t> slot_entries_;  // entry of each occupied slot
+};
+
+/**
+Map from strings to values of type TValue built on a StringLookupTable.
+*/
+template <typename TValue>
+class StringMap {
+ public:
+  void Reserve(size_t num_keys) {
+    table_.Reserve(num_keys);
+    values_.reserve(num_keys);
+  }
+
+  // Maps key to value. If key is already mapped, its value is replaced only if overwrite is true.
+  void Insert(std::string_view key, const TValue& value, bool overwrite) {
+    const auto inserted = table_.Insert(key);
+    if (inserted.second) {
+      values_.push_back(value);
+    } else if (overwrite) {
+      values_[inserted.first] = value;
+    }
+  }
+
+  // output[i] = value of input[i], or default_value if input[i] is not a key. Large inputs are split over the
+  // thread pool.
+  void Lookup(gsl::span<const std::string> input, gsl::span<TValue> output, const TValue& default_value,
+              concurrency::ThreadPool* thread_pool) const {
+    static constexpr std::ptrdiff_t kBatchSize = 64;
+    const auto size = static_cast<std::ptrdiff_t>(input.size());
+    const std::ptrdiff_t num_batches = (size + kBatchSize - 1) / kBatchSize;
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, num_batches,
+        TensorOpCost{static_cast<double>(kBatchSize * sizeof(std::string)),
+                     static_cast<double>(kBatchSize * sizeof(TValue)), static_cast<double>(kBatchSize * 64)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          uint32_t entries[kBatchSize];
+          for (std::ptrdiff_t batch = first; batch < last; ++batch) {
+            const std::ptrdiff_t start = batch * kBatchSize;
+            const std::ptrdiff_t count = std::min(kBatchSize, size - start);
+            table_.FindBatch(input.data() + start, static_cast<size_t>(count), entries);
+            for (std::ptrdiff_t i = 0; i < count; ++i) {
+              output[start + i] = entries[i] == StringLookupTable::kNotFound ? default_value : values_[entries[i]];
+            }
+          }
+        });
+  }
+
+ private:
+  StringLookupTable table_;
+  std::vector<TValue> values_;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -12,6 +12,9 @@
 namespace onnxruntime {
 namespace ml {
 
+// upper bound of the number of kernel values computed at once, so the buffer stays in the order of 16MB
+static constexpr ptrdiff_t kMaxKernelsPerBlock = 4 * 1024 * 1024;
+
 ONNX_CPU_OPERATOR_ML_KERNEL(
     SVMClassifier,
     1,
@@ -63,6 +66,7 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   if (vector_count_ > 0) {
     feature_count_ = support_vectors_.size() / vector_count_;  // length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
+    set_support_vectors(support_vectors_, vector_count_);
   } else {
     feature_count_ = coefficients_.size() / class_count_;  // liblinear mode
     mode_ = SVM_TYPE::SVM_LINEAR;
@@ -236,74 +240,105 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
       classifier_scores = final_scores;
     }
 
-    kernels_data.resize(num_batches * vector_count_);
     votes_data.resize(num_batches * class_count_, 0);
-
-    auto kernels_span = gsl::make_span<float>(kernels_data.data(), kernels_data.size());
     auto votes_span = gsl::make_span<int64_t>(votes_data.data(), votes_data.size());
 
-    // combine the input data with the support vectors and apply the kernel type
-    // output is {num_batches, vector_count_}
-    batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
-                              threadpool);
-
-    for (int64_t n = 0; n < num_batches; n++) {
-      // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
-      // per class.
-      // coefficients: [num_classes - 1, vector_count_]
-      //
-      // e.g. say you have 3 classes, with 3 x 3 coefficients
-      //
-      // AA AB AC
-      // BA BB BC
-      // CA CB CC
-      //
-      // you can remove the diagonal line of items comparing a class with itself leaving one less row.
-      //
-      // BA AB AC
-      // CA CB BC
-      //
-      // for each class there is a coefficient per support vector, and a class has one or more support vectors.
-      //
-      // Combine the scores for the two combinations for two classes with their coefficient.
-      // e.g. AB combines with BA.
-      // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
-
-      auto cur_kernels = kernels_span.subspan(n * SafeInt<size_t>(vector_count_), onnxruntime::narrow<size_t>(vector_count_));
-      auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration), onnxruntime::narrow<size_t>(num_classifiers));
-      auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
-      auto scores_iter = cur_scores.begin();
-
-      size_t classifier_idx = 0;
-      for (int64_t i = 0; i < class_count_ - 1; i++) {
-        int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
-        int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
-        int64_t i_coeff_row_offset = vector_count_ * i;
-
-        for (int64_t j = i + 1; j < class_count_; j++) {
-          int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
-          int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
-          int64_t j_coeff_row_offset = vector_count_ * (j - 1);
-
-          double sum = 0;
-
-          const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
-          const float* val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_i)]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
-          val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_j)]);
-
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[classifier_idx++];
-
-          *scores_iter++ = static_cast<float>(sum);
-          ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
+    // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
+    // per class.
+    // coefficients: [num_classes - 1, vector_count_]
+    //
+    // e.g. say you have 3 classes, with 3 x 3 coefficients
+    //
+    // AA AB AC
+    // BA BB BC
+    // CA CB CC
+    //
+    // you can remove the diagonal line of items comparing a class with itself leaving one less row.
+    //
+    // BA AB AC
+    // CA CB BC
+    //
+    // for each class there is a coefficient per support vector, and a class has one or more support vectors.
+    //
+    // Combine the scores for the two combinations for two classes with their coefficient.
+    // e.g. AB combines with BA.
+    // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
+    //
+    // The dot products of the coefficients of each row with the kernels of the support vectors of each class are
+    // computed with a GEMM per class:
+    //   class_sums[n][c][row] = sum over the support vectors v of class c of kernels[n][v] * coefficients[row][v]
+    // so the score of the classifier comparing classes i < j is class_sums[n][i][j - 1] + class_sums[n][j][i] + rho.
+    //
+    // The batches are processed in blocks to bound the size of the kernels buffer, {block_size, vector_count_}.
+    const ptrdiff_t num_rows = class_count_ - 1;
+    const ptrdiff_t class_sums_per_batch = class_count_ * num_rows;
+    const ptrdiff_t block_size = std::max<ptrdiff_t>(
+        1, std::min<ptrdiff_t>(num_batches, kMaxKernelsPerBlock / std::max<ptrdiff_t>(vector_count_, 1)));
+
+    kernels_data.resize(block_size * SafeInt<size_t>(vector_count_));
+    std::vector<float> class_sums_data(block_size * SafeInt<size_t>(class_sums_per_batch));
+
+    for (ptrdiff_t block_start = 0; block_start < num_batches; block_start += block_size) {
+      const ptrdiff_t block_batches = std::min<ptrdiff_t>(block_size, num_batches - block_start);
+
+      auto kernels_span = gsl::make_span<float>(kernels_data.data(), block_batches * SafeInt<size_t>(vector_count_));
+      auto block_x = x_data.subspan(block_start * SafeInt<size_t>(feature_count_),
+                                    block_batches * SafeInt<size_t>(feature_count_));
+
+      // combine the input data with the support vectors and apply the kernel type
+      // output is {block_batches, vector_count_}
+      batched_kernel_dot<float>(block_x, support_vectors_, block_batches, vector_count_, feature_count_, 0.f,
+                                kernels_span, threadpool);
+
+      for (ptrdiff_t c = 0; c < class_count_ && num_rows > 0; c++) {
+        const size_t start_index_c = onnxruntime::narrow<size_t>(starting_vector_[onnxruntime::narrow<size_t>(c)]);
+        const size_t class_c_support_count =
+            onnxruntime::narrow<size_t>(vectors_per_class_[onnxruntime::narrow<size_t>(c)]);
+        float* class_sums = class_sums_data.data() + c * num_rows;
+
+        if (class_c_support_count == 0) {
+          for (ptrdiff_t n = 0; n < block_batches; n++) {
+            std::fill_n(class_sums + n * class_sums_per_batch, num_rows, 0.f);
+          }
+          continue;
         }
+
+        MlasGemm(CblasNoTrans, CblasTrans,
+                 static_cast<size_t>(block_batches), static_cast<size_t>(num_rows), class_c_support_count,
+                 1.f, kernels_data.data() + start_index_c, static_cast<size_t>(vector_count_),
+                 coefficients_.data() + start_index_c, static_cast<size_t>(vector_count_),
+                 0.f, class_sums, static_cast<size_t>(class_sums_per_batch),
+                 threadpool);
       }
+
+      // one-vs-one voting
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, block_batches,
+          TensorOpCost{static_cast<double>(class_sums_per_batch) * sizeof(float),
+                       static_cast<double>(num_classifiers + class_count_) * sizeof(float),
+                       static_cast<double>(num_classifiers) * 4},
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t block_n = first; block_n < last; block_n++) {
+              const int64_t n = block_start + block_n;
+              const float* class_sums = class_sums_data.data() + block_n * class_sums_per_batch;
+              auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration),
+                                                          onnxruntime::narrow<size_t>(num_classifiers));
+              auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_),
+                                                  onnxruntime::narrow<size_t>(class_count_));
+              auto scores_iter = cur_scores.begin();
+
+              size_t classifier_idx = 0;
+              for (int64_t i = 0; i < class_count_ - 1; i++) {
+                for (int64_t j = i + 1; j < class_count_; j++) {
+                  const float sum = class_sums[i * num_rows + j - 1] + class_sums[j * num_rows + i] +
+                                    rho_[classifier_idx++];
+
+                  *scores_iter++ = sum;
+                  ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
+                }
+              }
+            }
+          });
     }
   }
 
@@ -374,16 +409,18 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
                                          write_additional_scores, true, nullptr);
   };
 
-  // TODO: Refine this rough metric to choose when to parallelize.
-  if (num_batches > 512) {
-    concurrency::ThreadPool::TryBatchParallelFor(threadpool, num_batches, finalize_batch, -1);
-  } else {
-    {
-      for (ptrdiff_t i = 0; i < num_batches; ++i) {
-        finalize_batch(i);
-      }
-    }
-  }
+  // the probability calibration iterates over the class_count_ x class_count_ pairwise probabilities
+  const double finalize_cost = have_proba ? static_cast<double>(class_count_squared) * 16
+                                          : static_cast<double>(final_scores_per_batch) * 4;
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, num_batches,
+      TensorOpCost{static_cast<double>(final_scores_per_batch) * sizeof(float),
+                   static_cast<double>(final_scores_per_batch) * sizeof(float), finalize_cost},
+      [&finalize_batch](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t i = first; i < last; ++i) {
+          finalize_batch(i);
+        }
+      });
 
   return Status::OK();
 }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <numeric>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
@@ -28,6 +30,23 @@ class SVMCommon {
   }
 
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
+
+  // precompute what batched_kernel_dot needs of the support vectors, [vector_count, feature_count]
+  void set_support_vectors(gsl::span<const float> support_vectors, ptrdiff_t vector_count) {
+    support_vector_squared_norms_.clear();
+    if (kernel_type_ != KERNEL::RBF || vector_count == 0) {
+      return;
+    }
+
+    const size_t feature_count = support_vectors.size() / static_cast<size_t>(vector_count);
+    support_vector_squared_norms_.resize(static_cast<size_t>(vector_count));
+    for (size_t i = 0; i < support_vector_squared_norms_.size(); ++i) {
+      auto support_vector = support_vectors.subspan(i * feature_count, feature_count);
+      support_vector_squared_norms_[i] = std::inner_product(support_vector.begin(), support_vector.end(),
+                                                            support_vector.begin(), 0.f);
+    }
+  }
+
   KERNEL get_kernel_type() const { return kernel_type_; }
 
   template <typename T>
@@ -39,28 +58,52 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
+      // |a - b|^2 = |a|^2 + |b|^2 - 2 * a.b, so the dot products are computed with a GEMM.
+      // b must be the support vectors given to set_support_vectors, which precomputed |b|^2.
+      ORT_ENFORCE(support_vector_squared_norms_.size() == static_cast<size_t>(n),
+                  "The squared norms of the support vectors were not computed.");
 
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
 
-        cur_batch += k;  // move to start of next batch
-      }
+      const T* b_norms = support_vector_squared_norms_.data();
+      const T gamma = gamma_;
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m,
+          TensorOpCost{static_cast<double>(k + n) * sizeof(T), static_cast<double>(n) * sizeof(T),
+                       static_cast<double>(k + 8 * n)},
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t batch = first; batch < last; ++batch) {
+              const T* cur_batch = a.data() + batch * k;
+              T a_norm = 0.f;
+              for (ptrdiff_t feature = 0; feature < k; ++feature) {
+                a_norm += cur_batch[feature] * cur_batch[feature];
+              }
+
+              // The expansion cancels the digits of distances that are small compared to the norms, e.g. an input
+              // close to a support vector far from the origin, and may even make them negative. Those distances are
+              // computed again from the differences, which gives the same results as the direct computation.
+              T* cur_out = out.data() + batch * n;
+              for (ptrdiff_t support_vector = 0; support_vector < n; ++support_vector) {
+                T distance = cur_out[support_vector] + a_norm + b_norms[support_vector];
+                if (distance < kDirectDistanceRatio * (a_norm + b_norms[support_vector])) {
+                  const T* cur_support_vector = b.data() + support_vector * k;
+                  distance = 0.f;
+                  for (ptrdiff_t feature = 0; feature < k; ++feature) {
+                    const T diff = cur_batch[feature] - cur_support_vector[feature];
+                    distance += diff * diff;
+                  }
+                }
+                cur_out[support_vector] = -gamma * distance;
+              }
+
+              MlasComputeExp(cur_out, cur_out, static_cast<size_t>(n));
+            }
+          });
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -96,16 +139,22 @@ class SVMCommon {
   }
 
  private:
+  // RBF distances below this fraction of |a|^2 + |b|^2 are computed from the differences. The expansion is accurate
+  // to a few float epsilons of |a|^2 + |b|^2, so larger distances keep all but their last digit or so.
+  static constexpr float kDirectDistanceRatio = 0.1f;
+
   KERNEL kernel_type_;
   float gamma_{0.f};
   float coef0_{0.f};
   float degree_{0.f};
+  std::vector<float> support_vector_squared_norms_;
 };
 
 class SVMClassifier final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
   using SVMCommon::get_kernel_type;
   using SVMCommon::set_kernel_type;
+  using SVMCommon::set_support_vectors;
 
  public:
   SVMClassifier(const OpKernelInfo& info);
@@ -8,8 +8,12 @@
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace onnxruntime {
 
@@ -25,69 +29,99 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
-
-template <>
-struct NgramPart<int64_t>;
-
-template <>
-struct NgramPart<std::string>;
-
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
-
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = InlinedHashMap<int64_t, std::unique_ptr<NgramPartInt>>;
-
-#ifndef DISABLE_ABSEIL
-using StrMap = absl::flat_hash_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                   std::hash<std::string>, std::equal_to<std::string>>;
-#else
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
-#endif
-
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+// Trie of the n-grams of the pool, stored in flat arrays.
+//
+// The tokens of the pool are numbered in a vocabulary, and an input row is translated to these token ids once, so
+// walking the trie compares integers only. A node of the trie is an n-gram prefix. Its children are a range of
+// children_, sorted by token id, except for the children of the root which are indexed directly by token id.
+// For (1,2,3), the node of (1,2) has id 0 if (1,2) itself is not in the pool, and the node of (1,2,3) has a valid id.
+class NgramTrie {
+ public:
+  static constexpr uint32_t kNoToken = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kRoot = 0;
+
+  // Token ids are dense, assigned in the order the tokens are first seen.
+  template <class Vocabulary, class Key>
+  static uint32_t AddToken(Vocabulary& vocabulary, const Key& key) {
+    return vocabulary.emplace(key, static_cast<uint32_t>(vocabulary.size())).first->second;
+  }
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+  // Adds ngrams n-grams of ngram_size tokens from token_ids, numbered from ngram_id. Returns the next ngram_id.
+  size_t Add(const uint32_t* token_ids, size_t ngrams, size_t ngram_size, size_t ngram_id) {
+    if (nodes_.empty()) {
+      nodes_.push_back(0);
+    }
+    for (; ngrams > 0; --ngrams, token_ids += ngram_size) {
+      uint32_t node = kRoot;
+      for (size_t n = 0; n < ngram_size; ++n) {
+        const uint64_t edge = (uint64_t{node} << 32) | token_ids[n];
+        auto p = edges_.emplace(edge, static_cast<uint32_t>(nodes_.size()));
+        if (p.second) {
+          nodes_.push_back(0);
+        }
+        node = p.first->second;
+      }
+      ORT_ENFORCE(nodes_[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+      nodes_[node] = ngram_id;
+      ++ngram_id;
+    }
+    return ngram_id;
+  }
 
-// Returns next ngram_id
-template <class K, class ForwardIter, class Map>
-inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
-  for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
+  // Lays out the children of every node once all the n-grams are added.
+  void Finalize(size_t vocabulary_size) {
+    std::vector<std::pair<uint64_t, uint32_t>> edges(edges_.begin(), edges_.end());
+    edges_ = {};
+    std::sort(edges.begin(), edges.end());
+
+    root_children_.assign(vocabulary_size, kNoNode);
+    first_child_.assign(nodes_.size() + 1, 0);
+    children_.reserve(edges.size());
+    for (const auto& edge : edges) {
+      const auto parent = static_cast<uint32_t>(edge.first >> 32);
+      const auto token = static_cast<uint32_t>(edge.first);
+      if (parent == kRoot) {
+        root_children_[token] = edge.second;
+      } else {
+        children_.push_back({token, edge.second});
+        ++first_child_[parent + 1];
       }
-      ++n;
-      m = &p.first->second->leafs_;
+    }
+    for (size_t i = 1; i < first_child_.size(); ++i) {
+      first_child_[i] += first_child_[i - 1];
     }
   }
-  return ngram_id;
-}
+
+  bool Empty() const { return nodes_.size() <= 1; }
+
+  // The n-gram id of node, 0 if the node is only a prefix.
+  size_t Id(uint32_t node) const { return nodes_[node]; }
+
+  uint32_t Child(uint32_t node, uint32_t token) const {
+    if (node == kRoot) {
+      return root_children_[token];
+    }
+    const Edge* first = children_.data() + first_child_[node];
+    const Edge* last = children_.data() + first_child_[node + 1];
+    const Edge* hit = std::lower_bound(first, last, token,
+                                       [](const Edge& edge, uint32_t t) { return edge.token < t; });
+    return hit != last && hit->token == token ? hit->node : kNoNode;
+  }
+
+ private:
+  struct Edge {
+    uint32_t token;
+    uint32_t node;
+  };
+
+  std::vector<size_t> nodes_;  // n-gram id of each node
+  std::vector<uint32_t> root_children_;
+  std::vector<uint32_t> first_child_;
+  std::vector<Edge> children_;
+  // (parent << 32 | token) -> child, only while the trie is built
+  InlinedHashMap<uint64_t, uint32_t> edges_;
+};
 
 }  // namespace ngram_details
 }  // namespace onnxruntime
@@ -96,10 +130,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -134,11 +164,11 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // Token ids of the pool_strings entries, which the string_views refer to
+  InlinedHashMap<std::string_view, uint32_t> str_vocabulary_;
+  // Token ids of the pool_int64s entries
+  InlinedHashMap<int64_t, uint32_t> int64_vocabulary_;
+  NgramTrie trie_;
 
   size_t output_size_ = 0;
 
@@ -223,6 +253,17 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
   const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
+  std::vector<uint32_t> pool_token_ids;
+  pool_token_ids.reserve(total_items);
+  if (pool_strings.empty()) {
+    for (int64_t token : pool_int64s) {
+      pool_token_ids.push_back(NgramTrie::AddToken(impl_->int64_vocabulary_, token));
+    }
+  } else {
+    for (const std::string& token : pool_strings) {
+      pool_token_ids.push_back(NgramTrie::AddToken(impl_->str_vocabulary_, std::string_view(token)));
+    }
+  }
   size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = onnxruntime::narrow<size_t>(impl_->min_gram_length_);
@@ -240,84 +281,54 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       auto ngrams = items / ngram_size;
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
-        } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
-        }
+        ngram_id = impl_->trie_.Add(pool_token_ids.data() + start_idx, ngrams, ngram_size, ngram_id);
       } else {
         ngram_id += ngrams;
       }
     }
     ++ngram_size;
   }
+  impl_->trie_.Finalize(std::max(impl_->str_vocabulary_.size(), impl_->int64_vocabulary_.size()));
 }
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-void TfIdfVectorizer::ComputeImpl(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size,
-                                  bool is_input_string, gsl::span<float> output_data,
+void TfIdfVectorizer::ComputeImpl(gsl::span<const uint32_t> row_token_ids, gsl::span<float> output_data,
                                   std::function<void(size_t, gsl::span<float>&)>& fn_weight) const {
-  const void* const row_begin = AdvanceElementPtr(x_data_raw, row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
   const auto& impl = *impl_;
+  const auto& trie = impl.trie_;
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
   auto start_ngram_size = impl.min_gram_length_;
+  const size_t row_size = row_token_ids.size();
   size_t output_idx;
 
   for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
+    for (size_t ngram_start = 0; ngram_start < row_size; ++ngram_start) {
       // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
+      if (ngram_start + SafeInt<size_t>(skip_distance) * (start_ngram_size - 1) >= row_size) {
         break;
       }
 
-      auto ngram_item = ngram_start;
-      if (is_input_string) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          str_map = &hit->second->leafs_;
+      uint32_t node = NgramTrie::kRoot;
+      size_t ngram_item = ngram_start;
+      for (auto ngram_size = 1;
+           ngram_size <= max_gram_length &&
+           ngram_item < row_size;
+           ++ngram_size, ngram_item += skip_distance) {
+        const uint32_t token = row_token_ids[ngram_item];
+        if (token == NgramTrie::kNoToken) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (elem_size == 4) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          int_map = &hit->second->leafs_;
+        node = trie.Child(node, token);
+        if (node == NgramTrie::kNoNode) {
+          break;
+        }
+        if (ngram_size >= start_ngram_size && trie.Id(node) != 0) {
+          output_idx = impl.OutputIdToIncrement(trie.Id(node));
+          fn_weight(output_idx, output_data);
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -372,9 +383,9 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   auto output_data = Y->MutableData<float>();
   const bool is_input_string = X->IsDataTypeString();
 
-  if (total_items == 0 ||
-      (is_input_string && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+  if (total_items == 0 || impl.trie_.Empty() ||
+      (is_input_string && impl.str_vocabulary_.empty()) ||
+      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl.int64_vocabulary_.empty())) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -385,7 +396,7 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   }
 
   auto x_data_raw = ctx->Input<Tensor>(0)->DataRaw();
-  const auto elem_size = X->DataType()->Size();
+  const bool is_input_int32 = X->IsDataType<int32_t>();
   int32_t num_batches = std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 2, num_rows);
 
   const auto& w = impl.weights_;
@@ -414,14 +425,37 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
       assert(false);
   }
 
-  std::function<void(ptrdiff_t)> fn = [this, C, output_data, x_data_raw, elem_size,
-                                       is_input_string, num_batches, num_rows, &fn_weight](ptrdiff_t batch_num) {
+  // Token ids of a row, kNoToken for the items that are not in the pool.
+  auto translate_row = [&impl, C, x_data_raw, is_input_string, is_input_int32](ptrdiff_t row_num,
+                                                                                std::vector<uint32_t>& token_ids) {
+    token_ids.resize(C);
+    const size_t offset = row_num * C;
+    if (is_input_string) {
+      const auto* row = static_cast<const std::string*>(x_data_raw) + offset;
+      for (size_t i = 0; i < C; ++i) {
+        auto hit = impl.str_vocabulary_.find(std::string_view(row[i]));
+        token_ids[i] = hit == impl.str_vocabulary_.end() ? NgramTrie::kNoToken : hit->second;
+      }
+    } else {
+      for (size_t i = 0; i < C; ++i) {
+        const int64_t val = is_input_int32 ? int64_t{static_cast<const int32_t*>(x_data_raw)[offset + i]}
+                                           : static_cast<const int64_t*>(x_data_raw)[offset + i];
+        auto hit = impl.int64_vocabulary_.find(val);
+        token_ids[i] = hit == impl.int64_vocabulary_.end() ? NgramTrie::kNoToken : hit->second;
+      }
+    }
+  };
+
+  std::function<void(ptrdiff_t)> fn = [this, output_data, num_batches, num_rows, &translate_row,
+                                       &fn_weight](ptrdiff_t batch_num) {
+    std::vector<uint32_t> token_ids;
     // Frequency holder allocate [B..output_size_] and init all to zero.
     auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_batches, static_cast<size_t>(num_rows));
     for (auto row_num = work.start; row_num < work.end; ++row_num) {
       auto out = gsl::span<float>(output_data + row_num * this->impl_->output_size_, this->impl_->output_size_);
       std::fill(out.begin(), out.end(), 0.0f);
-      ComputeImpl(x_data_raw, elem_size, row_num, C, is_input_string, out, fn_weight);
+      translate_row(row_num, token_ids);
+      ComputeImpl(token_ids, out, fn_weight);
     }
   };
 
@@ -13,10 +13,13 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +121,89 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// Corners and area of the boxes of a batch, as structure of arrays so that the IoU of a box with many others is
+// computed by a vectorizable loop over contiguous values. The values are computed exactly as SuppressByIOU does.
+struct BoxesSoA {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Resize(size_t size) {
+    x_min.resize(size);
+    y_min.resize(size);
+    x_max.resize(size);
+    y_max.resize(size);
+    area.resize(size);
+  }
+
+  void Set(size_t i, const float* box, int64_t center_point_box) {
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min[i], x_max[i]);
+      MaxMin(box[0], box[2], y_min[i], y_max[i]);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[i] = box[0] - width_half;
+      x_max[i] = box[0] + width_half;
+      y_min[i] = box[1] - height_half;
+      y_max[i] = box[1] + height_half;
+    }
+    area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+  }
+};
+
+// Returns true if the IoU of box with any of the first count boxes of selected exceeds iou_threshold, with the
+// same conditions as SuppressByIOU. The boxes are tested by chunks without branches inside a chunk.
+bool SuppressedBySelected(const BoxesSoA& boxes, size_t box, const BoxesSoA& selected, size_t count,
+                          float iou_threshold) {
+  constexpr size_t kChunkSize = 16;
+  const float x_min = boxes.x_min[box];
+  const float y_min = boxes.y_min[box];
+  const float x_max = boxes.x_max[box];
+  const float y_max = boxes.y_max[box];
+  const float area = boxes.area[box];
+  if (area <= .0f) {
+    return false;
+  }
+
+  const float* s_x_min = selected.x_min.data();
+  const float* s_y_min = selected.y_min.data();
+  const float* s_x_max = selected.x_max.data();
+  const float* s_y_max = selected.y_max.data();
+  const float* s_area = selected.area.data();
+  for (size_t chunk = 0; chunk < count; chunk += kChunkSize) {
+    const size_t chunk_end = std::min(count, chunk + kChunkSize);
+    int suppressed = 0;
+    for (size_t i = chunk; i < chunk_end; ++i) {
+      const float intersection_x_min = std::max(x_min, s_x_min[i]);
+      const float intersection_x_max = std::min(x_max, s_x_max[i]);
+      const float intersection_y_min = std::max(y_min, s_y_min[i]);
+      const float intersection_y_max = std::min(y_max, s_y_max[i]);
+      const float intersection_area = (intersection_x_max - intersection_x_min) *
+                                      (intersection_y_max - intersection_y_min);
+      const float union_area = area + s_area[i] - intersection_area;
+      suppressed |= static_cast<int>(intersection_x_max > intersection_x_min) &
+                    static_cast<int>(intersection_y_max > intersection_y_min) &
+                    static_cast<int>(intersection_area > .0f) &
+                    static_cast<int>(s_area[i] > .0f) &
+                    static_cast<int>(union_area > .0f) &
+                    static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -142,68 +228,114 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
     BoxInfoPtr() = default;
     explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+    // Orders by decreasing score, then by increasing index.
     inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+      return score_ > rhs.score_ || (score_ == rhs.score_ && index_ < rhs.index_);
     }
   };
 
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
+  const size_t num_boxes = static_cast<size_t>(pc.num_boxes_);
+  const size_t max_selected = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), num_boxes);
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  // The boxes of a batch are shared by all of its classes, so they are converted once.
+  std::vector<BoxesSoA> batch_boxes(narrow<size_t>(pc.num_batches_));
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(pc.num_batches_),
+      TensorOpCost{static_cast<double>(num_boxes * 4 * sizeof(float)),
+                   static_cast<double>(num_boxes * 5 * sizeof(float)), static_cast<double>(num_boxes * 8)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t batch_index = first; batch_index < last; ++batch_index) {
+          BoxesSoA& boxes = batch_boxes[batch_index];
+          boxes.Resize(num_boxes);
+          const float* batch_data = boxes_data + batch_index * pc.num_boxes_ * 4;
+          for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+            boxes.Set(box_index, batch_data + 4 * box_index, center_point_box);
           }
         }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+      });
+
+  // Each (batch, class) pair is an independent work item. Its selected indices are concatenated in order afterwards
+  // so the output does not depend on the scheduling.
+  const auto num_work_items = narrow<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<SelectedIndex>> selected_per_item(static_cast<size_t>(num_work_items));
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_work_items,
+      TensorOpCost{static_cast<double>(num_boxes * sizeof(float)),
+                   static_cast<double>(max_selected * sizeof(SelectedIndex)),
+                   static_cast<double>(num_boxes) * (std::log2(static_cast<double>(num_boxes) + 1) + max_selected)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<BoxInfoPtr> candidate_boxes;
+        candidate_boxes.reserve(num_boxes);
+        BoxesSoA selected_boxes;
+        selected_boxes.Resize(max_selected);
+
+        for (std::ptrdiff_t item = first; item < last; ++item) {
+          const int64_t batch_index = item / pc.num_classes_;
+          const int64_t class_index = item % pc.num_classes_;
+          const BoxesSoA& boxes = batch_boxes[batch_index];
+          auto& selected_indices = selected_per_item[item];
+
+          // Filter by score_threshold_
+          candidate_boxes.clear();
+          const float* class_scores = scores_data + item * pc.num_boxes_;
+          if (pc.score_threshold_ != nullptr) {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+              if (class_scores[box_index] > score_threshold) {
+                candidate_boxes.emplace_back(class_scores[box_index], box_index);
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+              candidate_boxes.emplace_back(class_scores[box_index], box_index);
+            }
           }
-        }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          // Only the first max_selected candidates can be selected if none is suppressed, so rather than sorting all
+          // of them, the candidates are sorted in chunks as the greedy selection progresses.
+          const size_t sort_chunk_size = std::max<size_t>(max_selected, 64);
+          size_t sorted_end = 0;
+          size_t num_selected = 0;
+          for (size_t candidate = 0; candidate < candidate_boxes.size() && num_selected < max_selected; ++candidate) {
+            if (candidate == sorted_end) {
+              const size_t chunk_end = std::min(candidate_boxes.size(), sorted_end + sort_chunk_size);
+              std::partial_sort(candidate_boxes.begin() + sorted_end, candidate_boxes.begin() + chunk_end,
+                                candidate_boxes.end());
+              sorted_end = chunk_end;
+            }
+
+            const auto box_index = static_cast<size_t>(candidate_boxes[candidate].index_);
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+            // threshold
+            if (SuppressedBySelected(boxes, box_index, selected_boxes, num_selected, iou_threshold)) {
+              continue;
+            }
+
+            selected_boxes.x_min[num_selected] = boxes.x_min[box_index];
+            selected_boxes.y_min[num_selected] = boxes.y_min[box_index];
+            selected_boxes.x_max[num_selected] = boxes.x_max[box_index];
+            selected_boxes.y_max[num_selected] = boxes.y_max[box_index];
+            selected_boxes.area[num_selected] = boxes.area[box_index];
+            ++num_selected;
+            selected_indices.emplace_back(batch_index, class_index, static_cast<int64_t>(box_index));
+          }
         }
-        sorted_boxes.pop();
-      }  // while
-    }    // for class_index
-  }      // for batch_index
+      });
+
+  size_t num_selected = 0;
+  for (const auto& selected_indices : selected_per_item) {
+    num_selected += selected_indices.size();
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (const auto& selected_indices : selected_per_item) {
+    output_data = std::copy(selected_indices.begin(), selected_indices.end(), output_data);
+  }
 
   return Status::OK();
 }
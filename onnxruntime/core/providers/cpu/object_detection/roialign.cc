@@ -154,6 +154,51 @@ static void PreCalcForBilinearInterpolate(const int64_t height, const int64_t wi
   }
 }
 
+// Number of channels interpolated together from each entry of the pre_calc table. The weights and positions of an
+// entry are loaded once for the block, and the channels of the block are independent accumulations.
+constexpr int64_t kRoiAlignChannelBlock = 8;
+
+// Computes the outputs of channels [c_begin, c_begin + num_c) of a ROI from the pre_calc table of the ROI.
+template <typename T>
+void RoiAlignChannelBlock(const T* bottom_data, int64_t height, int64_t width, int64_t pooled_height,
+                          int64_t pooled_width, int64_t roi_bin_grid_h, int64_t roi_bin_grid_w, int64_t count,
+                          const std::vector<PreCalc<T>>& pre_calc, RoiAlignMode mode, int64_t num_c, T* top_data) {
+  const int64_t plane_size = height * width;
+  const int64_t pooled_size = pooled_height * pooled_width;
+  const int64_t num_samples = roi_bin_grid_h * roi_bin_grid_w;
+  const PreCalc<T>* pc = pre_calc.data();
+
+  for (int64_t index = 0; index < pooled_size; ++index, pc += num_samples) {
+    T output_val[kRoiAlignChannelBlock] = {};
+    if (mode == RoiAlignMode::avg) {  // avg pooling
+      for (int64_t sample = 0; sample < num_samples; ++sample) {
+        const PreCalc<T>& p = pc[sample];
+        const T* data = bottom_data;
+        for (int64_t c = 0; c < num_c; ++c, data += plane_size) {
+          output_val[c] += p.w1 * data[p.pos1] + p.w2 * data[p.pos2] + p.w3 * data[p.pos3] + p.w4 * data[p.pos4];
+        }
+      }
+      for (int64_t c = 0; c < num_c; ++c) {
+        output_val[c] /= count;
+      }
+    } else {  // max pooling
+      for (int64_t sample = 0; sample < num_samples; ++sample) {
+        const PreCalc<T>& p = pc[sample];
+        const T* data = bottom_data;
+        for (int64_t c = 0; c < num_c; ++c, data += plane_size) {
+          T val = std::max(std::max(std::max(p.w1 * data[p.pos1], p.w2 * data[p.pos2]), p.w3 * data[p.pos3]),
+                           p.w4 * data[p.pos4]);
+          output_val[c] = sample == 0 ? val : std::max(output_val[c], val);
+        }
+      }
+    }
+
+    for (int64_t c = 0; c < num_c; ++c) {
+      top_data[c * pooled_size + index] = output_val[c];
+    }
+  }
+}
+
 template <typename T>
 void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, float spatial_scale, int64_t height,
                      int64_t width, int64_t sampling_ratio, const T* bottom_rois, int64_t num_roi_cols, T* top_data,
@@ -163,12 +208,22 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
   int64_t pooled_height = output_shape[2];
   int64_t pooled_width = output_shape[3];
 
+  // A work item is a group of channels of a ROI, so that few ROIs with many channels still use all the threads.
+  // The pre_calc table of the ROI is computed by each of its work items; it is small compared to the work over the
+  // channels of a group.
+  constexpr int64_t kChannelsPerWorkItem = 8 * kRoiAlignChannelBlock;
+  const int64_t groups_per_roi = (channels + kChannelsPerWorkItem - 1) / kChannelsPerWorkItem;
+
   // 100 is a random chosed value, need be tuned
-  double cost = static_cast<double>(channels * pooled_width * pooled_height * 100);
+  double cost = static_cast<double>(std::min(channels, kChannelsPerWorkItem) * pooled_width * pooled_height * 100);
 
-  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois), cost, [&](ptrdiff_t n, ptrdiff_t end) {
-    for (; n != end; ++n) {
-      int64_t index_n = n * channels * pooled_width * pooled_height;
+  const auto num_work_items = static_cast<ptrdiff_t>(n_rois * groups_per_roi);
+  ThreadPool::TryParallelFor(ttp, num_work_items, cost, [&](ptrdiff_t item, ptrdiff_t end) {
+    std::vector<PreCalc<T>> pre_calc;
+    for (; item != end; ++item) {
+      const int64_t n = item / groups_per_roi;
+      const int64_t c_begin = (item % groups_per_roi) * kChannelsPerWorkItem;
+      const int64_t c_end = std::min(c_begin + kChannelsPerWorkItem, channels);
 
       const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
       const auto roi_batch_ind = batch_indices_ptr[n];
@@ -201,59 +256,20 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
 
       // we want to precalculate indices and weights shared by all channels,
       // this is the key point of optimization
-      std::vector<PreCalc<T>> pre_calc(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
+      pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
       PreCalcForBilinearInterpolate(height, width, pooled_height, pooled_width, roi_bin_grid_h, roi_bin_grid_w,
                                     roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
                                     roi_bin_grid_w, pre_calc);
 
-      for (int64_t c = 0; c < channels; c++) {
-        int64_t index_n_c = index_n + c * pooled_width * pooled_height;
+      for (int64_t c = c_begin; c < c_end; c += kRoiAlignChannelBlock) {
         const T* offset_bottom_data =
             bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-        int64_t pre_calc_index = 0;
-
-        for (int64_t ph = 0; ph < pooled_height; ph++) {
-          for (int64_t pw = 0; pw < pooled_width; pw++) {
-            int64_t index = index_n_c + ph * pooled_width + pw;
-
-            T output_val = 0.;
-            if (mode == RoiAlignMode::avg) {  // avg pooling
-              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                  const auto& pc = pre_calc[onnxruntime::narrow<size_t>(pre_calc_index)];
-                  output_val += pc.w1 * offset_bottom_data[pc.pos1] + pc.w2 * offset_bottom_data[pc.pos2] +
-                                pc.w3 * offset_bottom_data[pc.pos3] + pc.w4 * offset_bottom_data[pc.pos4];
-
-                  pre_calc_index += 1;
-                }
-              }
-              output_val /= count;
-            } else {  // max pooling
-              bool max_flag = false;
-              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                  const auto& pc = pre_calc[onnxruntime::narrow<size_t>(pre_calc_index)];
-                  T val = std::max(
-                      std::max(std::max(pc.w1 * offset_bottom_data[pc.pos1], pc.w2 * offset_bottom_data[pc.pos2]),
-                               pc.w3 * offset_bottom_data[pc.pos3]),
-                      pc.w4 * offset_bottom_data[pc.pos4]);
-                  if (!max_flag) {
-                    output_val = val;
-                    max_flag = true;
-                  } else {
-                    output_val = std::max(output_val, val);
-                  }
-
-                  pre_calc_index += 1;
-                }
-              }
-            }
-
-            top_data[index] = output_val;
-          }  // for pw
-        }    // for ph
-      }      // for c
-    }        // for n
+        T* offset_top_data = top_data + (n * channels + c) * pooled_width * pooled_height;
+        RoiAlignChannelBlock(offset_bottom_data, height, width, pooled_height, pooled_width, roi_bin_grid_h,
+                             roi_bin_grid_w, count, pre_calc, mode, std::min(kRoiAlignChannelBlock, c_end - c),
+                             offset_top_data);
+      }
+    }  // for item
   });
 }
 }  // namespace
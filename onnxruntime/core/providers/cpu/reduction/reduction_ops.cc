@@ -349,6 +349,37 @@ void ReduceAggregatorBase::FastReduceRKR(const Tensor&, const gsl::span<const in
   ValidateMustBeOverloaded();
 }
 
+void ReduceAggregatorBase::FastReduceColumnsF32(MLAS_REDUCE_KIND reduce_kind, const float* data, int64_t n_rows,
+                                                int64_t N, float* out, concurrency::ThreadPool* tp) {
+  // Threads work on whole blocks of 16 columns, the width of the MLAS kernel.
+  constexpr int64_t block_size = 16;
+  const int64_t n_blocks = (N + block_size - 1) / block_size;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(n_blocks), ParallelReduceFastCost(block_size, n_rows, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const int64_t begin = first * block_size;
+        const int64_t end = std::min(N, last * block_size);
+        MlasReduceColumnsF32(reduce_kind, data + begin, onnxruntime::narrow<size_t>(n_rows),
+                             onnxruntime::narrow<size_t>(end - begin), onnxruntime::narrow<size_t>(N), out + begin);
+      });
+}
+
+void ReduceAggregatorBase::FastReduceKRKF32(MLAS_REDUCE_KIND reduce_kind, const float* data,
+                                            const gsl::span<const int64_t>& fast_shape, float* out,
+                                            concurrency::ThreadPool* tp) {
+  const int64_t n_rows = fast_shape[1];
+  const int64_t N = fast_shape[2];
+  const int64_t stridei = n_rows * N;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(n_rows, N, sizeof(float), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t d = first; d < last; ++d) {
+          MlasReduceColumnsF32(reduce_kind, data + d * stridei, onnxruntime::narrow<size_t>(n_rows),
+                               onnxruntime::narrow<size_t>(N), onnxruntime::narrow<size_t>(N), out + d * N);
+        }
+      });
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  gsl::span<const int64_t> reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
@@ -12,6 +12,7 @@
 #include "core/util/math.h"
 #endif
 #include "core/framework/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
@@ -159,6 +160,13 @@ class ReduceAggregatorBase {
   static void FastReduceRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceKRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceRKR(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
+
+ protected:
+  // MLAS vectorized implementations of the reductions over the outer axes shared by the fp32 aggregators.
+  static void FastReduceColumnsF32(MLAS_REDUCE_KIND reduce_kind, const float* data, int64_t n_rows, int64_t N,
+                                   float* out, concurrency::ThreadPool* tp);
+  static void FastReduceKRKF32(MLAS_REDUCE_KIND reduce_kind, const float* data,
+                               const gsl::span<const int64_t>& fast_shape, float* out, concurrency::ThreadPool* tp);
 };
 
 template <typename T, typename TVAL = T>
@@ -214,7 +222,11 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
   inline ReduceAggregatorSum(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
   inline void update(const T& v) { this->accumulator_ += v; }
   static T aggall(const T* from_data, int64_t size) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).sum();
+    if constexpr (std::is_same_v<float, T>) {
+      return MlasReduceF32(MlasReduceSum, from_data, onnxruntime::narrow<size_t>(size));
+    } else {
+      return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).sum();
+    }
   }
   inline T aggall(const T* from_data) {
     return aggall(from_data, this->N_);
@@ -250,6 +262,11 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
     T* out = output.MutableData<T>();
 
     int64_t n_rows = fast_shape[0];
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceColumnsF32(MlasReduceSum, data, n_rows, N, out, tp);
+      return;
+    }
+
     memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
     concurrency::ThreadPool::TryParallelFor(
         tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
@@ -268,6 +285,11 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
     int64_t stridei = fast_shape[1] * fast_shape[2];
     int64_t strideo = fast_shape[2];
     T* out = output.MutableData<T>();
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceKRKF32(MlasReduceSum, data, fast_shape, out, tp);
+      return;
+    }
+
     std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
     concurrency::ThreadPool::TryParallelFor(
         tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
@@ -307,7 +329,11 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
  public:
   inline ReduceAggregatorMean(int64_t N, const T&) : ReduceAggregatorSum<T>(N, 0) {}
   static T aggall(const T* from_data, int64_t size) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).mean();
+    if constexpr (std::is_same_v<float, T>) {
+      return ReduceAggregatorSum<T>::aggall(from_data, size) / static_cast<T>(size);
+    } else {
+      return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).mean();
+    }
   }
   inline T aggall(const T* from_data) {
     return aggall(from_data, this->N_);
@@ -375,6 +401,8 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
   static T aggall(const T* from_data, int64_t size) {
     if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
       return Eigen::Map<const Eigen::Matrix<bool, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).cast<int>().maxCoeff();
+    } else if constexpr (std::is_same_v<float, T>) {
+      return MlasReduceF32(MlasReduceMaximum, from_data, onnxruntime::narrow<size_t>(size));
     } else { /* generic impl */
       return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).maxCoeff();
     }
@@ -419,6 +447,11 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceColumnsF32(MlasReduceMaximum, data, n_rows, N, out, tp);
+      return;
+    }
+
     memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
 
     concurrency::ThreadPool::TryParallelFor(
@@ -445,6 +478,11 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
     int64_t strideo = fast_shape[2];
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceKRKF32(MlasReduceMaximum, data, fast_shape, out, tp);
+      return;
+    }
+
     concurrency::ThreadPool::TryParallelFor(
         tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
         [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
@@ -579,7 +617,11 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
  public:
   inline ReduceAggregatorMin(int64_t N, const T& init) : ReduceAggregator<T, T>(N, init) {}
   static T aggall(const T* from_data, int64_t size) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).minCoeff();
+    if constexpr (std::is_same_v<float, T>) {
+      return MlasReduceF32(MlasReduceMinimum, from_data, onnxruntime::narrow<size_t>(size));
+    } else {
+      return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).minCoeff();
+    }
   }
   inline T aggall(const T* from_data) {
     return aggall(from_data, this->N_);
@@ -629,6 +671,11 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceColumnsF32(MlasReduceMinimum, data, n_rows, N, out, tp);
+      return;
+    }
+
     memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
 
     concurrency::ThreadPool::TryParallelFor(
@@ -655,6 +702,11 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
     int64_t strideo = fast_shape[2];
+    if constexpr (std::is_same_v<float, T>) {
+      ReduceAggregatorBase::FastReduceKRKF32(MlasReduceMinimum, data, fast_shape, out, tp);
+      return;
+    }
+
     concurrency::ThreadPool::TryParallelFor(
         tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
         [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
@@ -726,14 +778,71 @@ template <typename T>
 class ReduceAggregatorL2 : public ReduceAggregator<T, T> {
  public:
   inline ReduceAggregatorL2(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
+  static T aggall(const T* from_data, int64_t size) {
+    if constexpr (std::is_same_v<float, T>) {
+      return reduce_sqrt<T>(MlasReduceF32(MlasReduceSumSquare, from_data, onnxruntime::narrow<size_t>(size)));
+    } else {
+      return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).norm();
+    }
+  }
   inline T aggall(const T* from_data) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).norm();
+    return aggall(from_data, this->N_);
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
   inline T get_value() { return reduce_sqrt<T>(this->accumulator_); }
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction, only fp32 has vectorized kernels for the reductions over the outer axes.
+  static inline FastReduceKind WhichFastReduce() {
+    if constexpr (std::is_same_v<float, T>) {
+      return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK;
+    } else {
+      return FastReduceKind::kKR;
+    }
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t d = first; d < last; ++d) {
+            out[d] = aggall(data + d * stridei, stridei);
+          }
+        });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<float, T>) {
+      T* out = output.MutableData<T>();
+      ReduceAggregatorBase::FastReduceColumnsF32(MlasReduceSumSquare, input.Data<T>(), fast_shape[0], fast_shape[1],
+                                                 out, tp);
+      for (int64_t i = 0; i < fast_shape[1]; ++i) {
+        out[i] = reduce_sqrt<T>(out[i]);
+      }
+    } else {
+      ReduceAggregatorBase::FastReduceRK(input, fast_shape, output, tp);
+    }
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<float, T>) {
+      T* out = output.MutableData<T>();
+      ReduceAggregatorBase::FastReduceKRKF32(MlasReduceSumSquare, input.Data<T>(), fast_shape, out, tp);
+      for (int64_t i = 0; i < fast_shape[0] * fast_shape[2]; ++i) {
+        out[i] = reduce_sqrt<T>(out[i]);
+      }
+    } else {
+      ReduceAggregatorBase::FastReduceKRK(input, fast_shape, output, tp);
+    }
+  }
 };
 
 template <typename T>
@@ -760,11 +869,18 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
     max_ = reduce_isinf(init) ? this->accumulator_ : init;
   }
   inline T aggall(const T* from_data) {
-    max_ = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).maxCoeff();
-    for (int64_t i = 0; i < this->N_; ++i) {
-      update(from_data[i]);
+    if constexpr (std::is_same_v<float, T>) {
+      return MlasReduceLogSumExpF32(from_data, onnxruntime::narrow<size_t>(this->N_));
+    } else {
+      // Infinite and NaN values are left out of the maximum, as in update0.
+      for (int64_t i = 0; i < this->N_; ++i) {
+        update0(from_data[i]);
+      }
+      for (int64_t i = 0; i < this->N_; ++i) {
+        update(from_data[i]);
+      }
+      return get_value();
     }
-    return get_value();
   }
   inline void update0(const T& v) {
     max_ = (reduce_isinf(v) || reduce_isnan(v) || v < max_) ? max_ : v;
@@ -774,6 +890,25 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kKR;
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 8),
+        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t d = first; d < last; ++d) {
+            out[d] = ReduceAggregatorLogSumExp<T>(stridei, data[d * stridei]).aggall(data + d * stridei);
+          }
+        });
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
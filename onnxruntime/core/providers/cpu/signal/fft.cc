@@ -0,0 +1,422 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/signal/fft.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace signal {
+
+namespace {
+
+// Prime factors up to this value run as a stage of the mixed-radix FFT, larger ones use Bluestein.
+constexpr size_t kMaxDirectRadix = 31;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// std::complex multiplication handles infinities and NaN at the cost of a library call.
+template <typename T>
+inline std::complex<T> Mul(const std::complex<T>& a, const std::complex<T>& b) {
+  return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// multiply by -i for a forward transform or by i for an inverse transform
+template <typename T>
+inline std::complex<T> RotateQuarter(const std::complex<T>& a, bool inverse) {
+  return inverse ? std::complex<T>(-a.imag(), a.real()) : std::complex<T>(a.imag(), -a.real());
+}
+
+// multiply by i
+template <typename T>
+inline std::complex<T> MulI(const std::complex<T>& a) {
+  return {-a.imag(), a.real()};
+}
+
+template <typename T>
+std::complex<T> Root(size_t numerator, size_t denominator, bool inverse) {
+  const double angle = (inverse ? 2.0 : -2.0) * kPi * static_cast<double>(numerator) / static_cast<double>(denominator);
+  return {static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle))};
+}
+
+InlinedVector<size_t> Factorize(size_t n) {
+  InlinedVector<size_t> factors;
+  while (n % 8 == 0) {
+    factors.push_back(8);
+    n /= 8;
+  }
+  while (n % 4 == 0) {
+    factors.push_back(4);
+    n /= 4;
+  }
+  if (n % 2 == 0) {
+    factors.push_back(2);
+    n /= 2;
+  }
+  for (size_t p = 3; p * p <= n; p += 2) {
+    while (n % p == 0) {
+      factors.push_back(p);
+      n /= p;
+    }
+  }
+  if (n > 1) {
+    factors.push_back(n);
+  }
+  return factors;
+}
+
+template <typename T>
+inline void Butterfly4(const std::complex<T>* a, std::complex<T>* b, bool inverse) {
+  const auto t0 = a[0] + a[2];
+  const auto t1 = a[0] - a[2];
+  const auto t2 = a[1] + a[3];
+  const auto t3 = RotateQuarter(a[1] - a[3], inverse);
+  b[0] = t0 + t2;
+  b[1] = t1 + t3;
+  b[2] = t0 - t2;
+  b[3] = t1 - t3;
+}
+
+}  // namespace
+
+template <typename T>
+FFTPlan<T>::FFTPlan(size_t length, bool inverse) : length_(length), inverse_(inverse) {
+  ORT_ENFORCE(length > 0, "The length of a FFT must be positive.");
+
+  const auto factors = Factorize(length);
+  if (!factors.empty() && factors.back() > kMaxDirectRadix) {
+    // Bluestein chirp-z: the transform is a convolution of the signal with a chirp, computed with power-of-two FFTs
+    convolution_length_ = 1;
+    while (convolution_length_ < 2 * length - 1) {
+      convolution_length_ <<= 1;
+    }
+    const size_t M = convolution_length_;
+    forward_ = std::make_unique<FFTPlan<T>>(M, false);
+    backward_ = std::make_unique<FFTPlan<T>>(M, true);
+
+    // chirp[n] = w^(n * n / 2). n * n is reduced modulo 2 * length to keep the angle accurate.
+    chirp_.resize(length);
+    for (size_t n = 0; n < length; n++) {
+      const auto n2 = static_cast<size_t>((static_cast<uint64_t>(n) * n) % (2 * static_cast<uint64_t>(length)));
+      chirp_[n] = Root<T>(n2, 2 * length, inverse);
+    }
+
+    std::vector<std::complex<T>> filter(M, std::complex<T>(0, 0));
+    for (size_t n = 0; n < length; n++) {
+      filter[n] = std::conj(chirp_[n]);
+      if (n > 0) {
+        filter[M - n] = filter[n];
+      }
+    }
+
+    // the inverse FFT of the convolution is not scaled, fold its 1 / M in the filter
+    chirp_filter_fft_.resize(M);
+    std::vector<std::complex<T>> scratch(forward_->ScratchSize());
+    forward_->Transform(filter.data(), chirp_filter_fft_.data(), scratch.data());
+    for (auto& value : chirp_filter_fft_) {
+      value /= static_cast<T>(M);
+    }
+    return;
+  }
+
+  size_t n = length;
+  size_t stride = 1;
+  for (const size_t radix : factors) {
+    Stage stage;
+    stage.radix = radix;
+    stage.m = n / radix;
+    stage.stride = stride;
+    stage.twiddles.resize(stage.m * (radix - 1));
+    for (size_t p = 0; p < stage.m; p++) {
+      for (size_t u = 1; u < radix; u++) {
+        stage.twiddles[p * (radix - 1) + u - 1] = Root<T>((p * u) % n, n, inverse);
+      }
+    }
+    if (radix > 5 && radix != 8) {
+      stage.roots.resize(radix);
+      for (size_t u = 0; u < radix; u++) {
+        stage.roots[u] = Root<T>(u, radix, inverse);
+      }
+    }
+    stages_.push_back(std::move(stage));
+    n /= radix;
+    stride *= radix;
+  }
+}
+
+template <typename T>
+size_t FFTPlan<T>::ScratchSize() const {
+  if (convolution_length_ != 0) {
+    return 2 * convolution_length_ + forward_->ScratchSize();
+  }
+  return stages_.size() > 1 ? length_ : 0;
+}
+
+template <typename T>
+void FFTPlan<T>::Transform(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  if (convolution_length_ != 0) {
+    Bluestein(input, output, scratch);
+    return;
+  }
+
+  if (stages_.empty()) {
+    output[0] = input[0];
+    return;
+  }
+
+  // The stages alternate between the output and the scratch buffer, so that the last one writes the output.
+  const size_t num_stages = stages_.size();
+  const std::complex<T>* x = input;
+  for (size_t i = 0; i < num_stages; i++) {
+    std::complex<T>* y = ((num_stages - 1 - i) % 2 == 0) ? output : scratch;
+    RunStage(stages_[i], x, y);
+    x = y;
+  }
+}
+
+// One stage of the self-sorting decimation in frequency FFT. For p < m and q < stride:
+//   y[q + stride * (radix * p + u)] = w^(p * u) * sum_t x[q + stride * (p + t * m)] * w_radix^(t * u)
+// The values of q are independent transforms, laid out contiguously so the inner loop vectorizes.
+template <typename T>
+void FFTPlan<T>::RunStage(const Stage& stage, const std::complex<T>* x, std::complex<T>* y) const {
+  const size_t radix = stage.radix;
+  const size_t m = stage.m;
+  const size_t s = stage.stride;
+  const bool inverse = inverse_;
+
+  switch (radix) {
+    case 2:
+      for (size_t p = 0; p < m; p++) {
+        const auto w1 = stage.twiddles[p];
+        const auto* x0 = x + s * p;
+        const auto* x1 = x + s * (p + m);
+        auto* y0 = y + s * (2 * p);
+        auto* y1 = y0 + s;
+        for (size_t q = 0; q < s; q++) {
+          const auto a0 = x0[q];
+          const auto a1 = x1[q];
+          y0[q] = a0 + a1;
+          y1[q] = Mul(a0 - a1, w1);
+        }
+      }
+      break;
+    case 3: {
+      const T sin_3 = static_cast<T>((inverse ? 1.0 : -1.0) * std::sqrt(3.0) / 2);
+      for (size_t p = 0; p < m; p++) {
+        const auto* w = stage.twiddles.data() + p * 2;
+        auto* y0 = y + s * (3 * p);
+        for (size_t q = 0; q < s; q++) {
+          const auto a0 = x[q + s * p];
+          const auto a1 = x[q + s * (p + m)];
+          const auto a2 = x[q + s * (p + 2 * m)];
+          const auto t = a1 + a2;
+          const auto mid = a0 - t * static_cast<T>(0.5);
+          const auto d = MulI((a1 - a2) * sin_3);
+          y0[q] = a0 + t;
+          y0[q + s] = Mul(mid + d, w[0]);
+          y0[q + 2 * s] = Mul(mid - d, w[1]);
+        }
+      }
+      break;
+    }
+    case 4:
+      for (size_t p = 0; p < m; p++) {
+        const auto* w = stage.twiddles.data() + p * 3;
+        auto* y0 = y + s * (4 * p);
+        for (size_t q = 0; q < s; q++) {
+          std::complex<T> a[4];
+          std::complex<T> b[4];
+          for (size_t t = 0; t < 4; t++) {
+            a[t] = x[q + s * (p + t * m)];
+          }
+          Butterfly4(a, b, inverse);
+          y0[q] = b[0];
+          y0[q + s] = Mul(b[1], w[0]);
+          y0[q + 2 * s] = Mul(b[2], w[1]);
+          y0[q + 3 * s] = Mul(b[3], w[2]);
+        }
+      }
+      break;
+    case 5: {
+      const T sign = inverse ? 1 : -1;
+      const T c1 = static_cast<T>(std::cos(2 * kPi / 5));
+      const T c2 = static_cast<T>(std::cos(4 * kPi / 5));
+      const T s1 = sign * static_cast<T>(std::sin(2 * kPi / 5));
+      const T s2 = sign * static_cast<T>(std::sin(4 * kPi / 5));
+      for (size_t p = 0; p < m; p++) {
+        const auto* w = stage.twiddles.data() + p * 4;
+        auto* y0 = y + s * (5 * p);
+        for (size_t q = 0; q < s; q++) {
+          const auto a0 = x[q + s * p];
+          const auto a1 = x[q + s * (p + m)];
+          const auto a2 = x[q + s * (p + 2 * m)];
+          const auto a3 = x[q + s * (p + 3 * m)];
+          const auto a4 = x[q + s * (p + 4 * m)];
+          const auto t1 = a1 + a4;
+          const auto t2 = a2 + a3;
+          const auto d1 = a1 - a4;
+          const auto d2 = a2 - a3;
+          const auto m1 = a0 + t1 * c1 + t2 * c2;
+          const auto m2 = a0 + t1 * c2 + t2 * c1;
+          const auto n1 = MulI(d1 * s1 + d2 * s2);
+          const auto n2 = MulI(d1 * s2 - d2 * s1);
+          y0[q] = a0 + t1 + t2;
+          y0[q + s] = Mul(m1 + n1, w[0]);
+          y0[q + 2 * s] = Mul(m2 + n2, w[1]);
+          y0[q + 3 * s] = Mul(m2 - n2, w[2]);
+          y0[q + 4 * s] = Mul(m1 - n1, w[3]);
+        }
+      }
+      break;
+    }
+    case 8: {
+      const auto w8 = Root<T>(1, 8, inverse);
+      for (size_t p = 0; p < m; p++) {
+        const auto* w = stage.twiddles.data() + p * 7;
+        auto* y0 = y + s * (8 * p);
+        for (size_t q = 0; q < s; q++) {
+          // two radix 4 butterflies on the even and odd inputs, combined with the roots of order 8
+          std::complex<T> even[4];
+          std::complex<T> odd[4];
+          std::complex<T> b_even[4];
+          std::complex<T> b_odd[4];
+          for (size_t t = 0; t < 4; t++) {
+            even[t] = x[q + s * (p + 2 * t * m)];
+            odd[t] = x[q + s * (p + (2 * t + 1) * m)];
+          }
+          Butterfly4(even, b_even, inverse);
+          Butterfly4(odd, b_odd, inverse);
+          b_odd[1] = Mul(b_odd[1], w8);
+          b_odd[2] = RotateQuarter(b_odd[2], inverse);
+          b_odd[3] = RotateQuarter(Mul(b_odd[3], w8), inverse);
+          y0[q] = b_even[0] + b_odd[0];
+          y0[q + 4 * s] = Mul(b_even[0] - b_odd[0], w[3]);
+          for (size_t u = 1; u < 4; u++) {
+            y0[q + u * s] = Mul(b_even[u] + b_odd[u], w[u - 1]);
+            y0[q + (u + 4) * s] = Mul(b_even[u] - b_odd[u], w[u + 3]);
+          }
+        }
+      }
+      break;
+    }
+    default: {
+      // direct DFT of the radix
+      InlinedVector<std::complex<T>, kMaxDirectRadix> a(radix);
+      for (size_t p = 0; p < m; p++) {
+        const auto* w = stage.twiddles.data() + p * (radix - 1);
+        auto* y0 = y + s * (radix * p);
+        for (size_t q = 0; q < s; q++) {
+          for (size_t t = 0; t < radix; t++) {
+            a[t] = x[q + s * (p + t * m)];
+          }
+          for (size_t u = 0; u < radix; u++) {
+            std::complex<T> sum = a[0];
+            for (size_t t = 1; t < radix; t++) {
+              sum += Mul(a[t], stage.roots[(t * u) % radix]);
+            }
+            y0[q + u * s] = u == 0 ? sum : Mul(sum, w[u - 1]);
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+template <typename T>
+void FFTPlan<T>::Bluestein(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  const size_t M = convolution_length_;
+  std::complex<T>* a = scratch;
+  std::complex<T>* a_fft = scratch + M;
+  std::complex<T>* inner_scratch = scratch + 2 * M;
+
+  for (size_t n = 0; n < length_; n++) {
+    a[n] = Mul(input[n], chirp_[n]);
+  }
+  std::fill(a + length_, a + M, std::complex<T>(0, 0));
+
+  forward_->Transform(a, a_fft, inner_scratch);
+  for (size_t k = 0; k < M; k++) {
+    a_fft[k] = Mul(a_fft[k], chirp_filter_fft_[k]);
+  }
+  backward_->Transform(a_fft, a, inner_scratch);
+
+  for (size_t k = 0; k < length_; k++) {
+    output[k] = Mul(a[k], chirp_[k]);
+  }
+}
+
+template <typename T>
+RealFFTPlan<T>::RealFFTPlan(size_t length) : length_(length), half_(length / 2, false) {
+  ORT_ENFORCE(length > 0 && length % 2 == 0, "The length of a real FFT must be even.");
+  twiddles_.resize(length / 2 + 1);
+  for (size_t k = 0; k < twiddles_.size(); k++) {
+    twiddles_[k] = Root<T>(k, length, false);
+  }
+}
+
+template <typename T>
+void RealFFTPlan<T>::Transform(const T* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  // z[n] = x[2n] + i * x[2n + 1]
+  const size_t half = length_ / 2;
+  half_.Transform(reinterpret_cast<const std::complex<T>*>(input), output, scratch);
+
+  // X[k] = E[k] + w^k * O[k] with E[k] = (Z[k] + conj(Z[half - k])) / 2, O[k] = (Z[k] - conj(Z[half - k])) / 2i.
+  // k and half - k are computed together as they read the same values, which allows to work in place.
+  const auto combine = [](const std::complex<T>& z, const std::complex<T>& z_conj, const std::complex<T>& w) {
+    const auto even = (z + z_conj) * static_cast<T>(0.5);
+    const auto odd = (z - z_conj) * static_cast<T>(0.5);
+    return even + Mul(w, std::complex<T>(odd.imag(), -odd.real()));
+  };
+
+  const auto z0 = output[0];
+  output[0] = std::complex<T>(z0.real() + z0.imag(), 0);
+  output[half] = std::complex<T>(z0.real() - z0.imag(), 0);
+  for (size_t k = 1; k <= half - k; k++) {
+    const size_t j = half - k;
+    const auto z_k = output[k];
+    const auto z_j = output[j];
+    output[k] = combine(z_k, std::conj(z_j), twiddles_[k]);
+    output[j] = combine(z_j, std::conj(z_k), twiddles_[j]);
+  }
+}
+
+template <>
+FFTPlanCache::Plans<float>& FFTPlanCache::GetPlans<float>() { return float_plans_; }
+
+template <>
+FFTPlanCache::Plans<double>& FFTPlanCache::GetPlans<double>() { return double_plans_; }
+
+template <typename T>
+const FFTPlan<T>& FFTPlanCache::GetPlan(size_t length, bool inverse) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& plans = inverse ? GetPlans<T>().inverse : GetPlans<T>().forward;
+  auto& plan = plans[length];
+  if (!plan) {
+    plan = std::make_unique<FFTPlan<T>>(length, inverse);
+  }
+  return *plan;
+}
+
+template <typename T>
+const RealFFTPlan<T>& FFTPlanCache::GetRealPlan(size_t length) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& plan = GetPlans<T>().real[length];
+  if (!plan) {
+    plan = std::make_unique<RealFFTPlan<T>>(length);
+  }
+  return *plan;
+}
+
+template class FFTPlan<float>;
+template class FFTPlan<double>;
+template class RealFFTPlan<float>;
+template class RealFFTPlan<double>;
+template const FFTPlan<float>& FFTPlanCache::GetPlan<float>(size_t, bool);
+template const FFTPlan<double>& FFTPlanCache::GetPlan<double>(size_t, bool);
+template const RealFFTPlan<float>& FFTPlanCache::GetRealPlan<float>(size_t);
+template const RealFFTPlan<double>& FFTPlanCache::GetRealPlan<double>(size_t);
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace signal {
+
+/**
+Precomputed plan of a complex FFT of a given length and direction.
+
+Lengths made of the factors 2, 3, 4, 5 and 8 (and small primes) run a mixed-radix self-sorting (Stockham) FFT with
+the twiddle factors of every stage precomputed. Lengths with a large prime factor fall back to the Bluestein chirp-z
+algorithm over a power-of-two FFT, also precomputed.
+
+The transform is not scaled: an inverse transform must be divided by the length by the caller.
+A plan is immutable once created and may be used from several threads with their own scratch buffers.
+*/
+template <typename T>
+class FFTPlan {
+ public:
+  FFTPlan(size_t length, bool inverse);
+
+  size_t Length() const { return length_; }
+  bool IsInverse() const { return inverse_; }
+
+  // number of complex values of the scratch buffer Transform requires.
+  size_t ScratchSize() const;
+
+  // output = FFT(input). input and output are contiguous, have Length() values and must not overlap.
+  void Transform(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  struct Stage {
+    size_t radix;
+    size_t m;       // length of the sub transforms after the stage
+    size_t stride;  // product of the radices of the previous stages
+    // twiddles[p * (radix - 1) + u - 1] = w^(p * u) for the length m * radix of the stage
+    std::vector<std::complex<T>> twiddles;
+    // roots[u] = w^u for the radix, used by radices without a specialized butterfly
+    std::vector<std::complex<T>> roots;
+  };
+
+  void RunStage(const Stage& stage, const std::complex<T>* x, std::complex<T>* y) const;
+  void Bluestein(const std::complex<T>* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+  size_t length_;
+  bool inverse_;
+  std::vector<Stage> stages_;
+
+  // Bluestein
+  size_t convolution_length_ = 0;
+  std::vector<std::complex<T>> chirp_;
+  std::vector<std::complex<T>> chirp_filter_fft_;
+  std::unique_ptr<FFTPlan<T>> forward_;
+  std::unique_ptr<FFTPlan<T>> backward_;
+};
+
+/**
+Precomputed plan of a forward FFT of a real signal of even length.
+
+The signal is transformed as a complex signal of half the length, made of its even and odd samples, and the
+spectrum is recovered from it. Only the Length() / 2 + 1 unique values of the spectrum are computed.
+*/
+template <typename T>
+class RealFFTPlan {
+ public:
+  explicit RealFFTPlan(size_t length);
+
+  size_t Length() const { return length_; }
+
+  size_t ScratchSize() const { return half_.ScratchSize(); }
+
+  // output[0, Length() / 2] = FFT(input). input has Length() values, output has Length() / 2 + 1.
+  void Transform(const T* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  size_t length_;
+  FFTPlan<T> half_;
+  // twiddles_[k] = w^k for the full length
+  std::vector<std::complex<T>> twiddles_;
+};
+
+/**
+Thread-safe cache of the FFT plans of a kernel, so plans and twiddles are created once per length and direction.
+*/
+class FFTPlanCache {
+ public:
+  template <typename T>
+  const FFTPlan<T>& GetPlan(size_t length, bool inverse);
+
+  template <typename T>
+  const RealFFTPlan<T>& GetRealPlan(size_t length);
+
+ private:
+  template <typename T>
+  struct Plans {
+    InlinedHashMap<size_t, std::unique_ptr<FFTPlan<T>>> forward;
+    InlinedHashMap<size_t, std::unique_ptr<FFTPlan<T>>> inverse;
+    InlinedHashMap<size_t, std::unique_ptr<RealFFTPlan<T>>> real;
+  };
+
+  template <typename T>
+  Plans<T>& GetPlans();
+
+  OrtMutex mutex_;
+  Plans<float> float_plans_;
+  Plans<double> double_plans_;
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
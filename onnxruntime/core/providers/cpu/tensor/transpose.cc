@@ -3,12 +3,15 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include "core/framework/element_type_lists.h"
 #include "core/framework/utils.h"
 #include "core/framework/transpose_helper.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "utils.h"
 
@@ -348,6 +351,271 @@ bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int
   return true;
 }
 
+namespace {
+
+// Transpose with unit axes removed and runs of input axes that stay adjacent in the output merged.
+// e.g. Shape=(1,64,56,56) perm=(0,2,3,1) becomes dims=(64,3136) perm=(1,0).
+struct CoalescedTranspose {
+  InlinedVector<size_t> dims;  // input dims
+  InlinedVector<size_t> perm;
+};
+
+CoalescedTranspose CoalesceTransposeAxes(gsl::span<const size_t> permutations, gsl::span<const int64_t> input_dims) {
+  const size_t rank = permutations.size();
+
+  // drop unit axes and renumber the remaining input axes
+  InlinedVector<size_t> squeezed_axis(rank, 0);
+  InlinedVector<size_t> squeezed_dims;
+  for (size_t i = 0; i < rank; ++i) {
+    squeezed_axis[i] = squeezed_dims.size();
+    if (input_dims[i] != 1) {
+      squeezed_dims.push_back(onnxruntime::narrow<size_t>(input_dims[i]));
+    }
+  }
+
+  InlinedVector<size_t> squeezed_perm;
+  for (size_t p : permutations) {
+    if (input_dims[p] != 1) {
+      squeezed_perm.push_back(squeezed_axis[p]);
+    }
+  }
+
+  // group output axes reading consecutive input axes. groups are recorded in output order.
+  InlinedVector<size_t> group_first_axis;
+  InlinedVector<size_t> group_size;
+  for (size_t i = 0; i < squeezed_perm.size(); ++i) {
+    if (i > 0 && squeezed_perm[i] == squeezed_perm[i - 1] + 1) {
+      group_size.back() *= squeezed_dims[squeezed_perm[i]];
+    } else {
+      group_first_axis.push_back(squeezed_perm[i]);
+      group_size.push_back(squeezed_dims[squeezed_perm[i]]);
+    }
+  }
+
+  // the groups partition the input axes, so ordering them by their first input axis gives the input layout
+  constexpr size_t kNoGroup = std::numeric_limits<size_t>::max();
+  InlinedVector<size_t> group_at_axis(squeezed_dims.size(), kNoGroup);
+  for (size_t g = 0; g < group_first_axis.size(); ++g) {
+    group_at_axis[group_first_axis[g]] = g;
+  }
+
+  CoalescedTranspose coalesced;
+  coalesced.perm.resize(group_first_axis.size());
+  for (size_t group : group_at_axis) {
+    if (group != kNoGroup) {
+      coalesced.perm[group] = coalesced.dims.size();
+      coalesced.dims.push_back(group_size[group]);
+    }
+  }
+
+  return coalesced;
+}
+
+// Linear index -> element offsets in two layouts of the same iteration space.
+void ComputeTransposeOffsets(size_t index, gsl::span<const size_t> dims, gsl::span<const size_t> source_strides,
+                             gsl::span<const size_t> target_strides, size_t& source_offset, size_t& target_offset) {
+  source_offset = 0;
+  target_offset = 0;
+  for (size_t i = dims.size(); i-- > 0;) {
+    const size_t coord = index % dims[i];
+    index /= dims[i];
+    source_offset += coord * source_strides[i];
+    target_offset += coord * target_strides[i];
+  }
+}
+
+using TransposeTileFn = void (*)(const uint8_t* source, size_t ld_source, uint8_t* target, size_t ld_target,
+                                 size_t m, size_t n);
+
+template <typename T>
+void TransposeTile(const uint8_t* source, size_t ld_source, uint8_t* target, size_t ld_target, size_t m, size_t n) {
+  MlasTranspose(reinterpret_cast<const T*>(source), ld_source, reinterpret_cast<T*>(target), ld_target, m, n);
+}
+
+template <typename T>
+TransposeTileFn GetTransposeTileFn() {
+  constexpr bool enabled = utils::HasTypeWithSameSize<EnabledDataTypesAllOpsets, T>();
+  return enabled ? &TransposeTile<T> : nullptr;
+}
+
+// Copies the rows of a transpose whose innermost axis is unchanged, in parallel over the rows.
+void DoBlockedRowTranspose(const CoalescedTranspose& t, gsl::span<const size_t> source_strides,
+                           const uint8_t* source, uint8_t* target, size_t element_size,
+                           concurrency::ThreadPool* tp) {
+  const size_t outer_rank = t.dims.size() - 1;
+  const size_t row_size = t.dims.back() * element_size;
+
+  InlinedVector<size_t> outer_dims(outer_rank);
+  InlinedVector<size_t> outer_source_strides(outer_rank);
+  InlinedVector<size_t> outer_target_strides(outer_rank);
+  size_t num_rows = 1;
+  for (size_t i = outer_rank; i-- > 0;) {
+    outer_dims[i] = t.dims[t.perm[i]];
+    outer_source_strides[i] = source_strides[t.perm[i]];
+    outer_target_strides[i] = num_rows;
+    num_rows *= outer_dims[i];
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_rows),
+      TensorOpCost{static_cast<double>(row_size), static_cast<double>(row_size), static_cast<double>(outer_rank)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        size_t source_offset = 0;
+        size_t target_offset = 0;
+        ComputeTransposeOffsets(static_cast<size_t>(first), outer_dims, outer_source_strides, outer_target_strides,
+                                source_offset, target_offset);
+
+        InlinedVector<size_t> coord(outer_rank);
+        for (size_t i = outer_rank, index = static_cast<size_t>(first); i-- > 0;) {
+          coord[i] = index % outer_dims[i];
+          index /= outer_dims[i];
+        }
+
+        uint8_t* local_target = target + target_offset * row_size;
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          memcpy(local_target, source + source_offset * element_size, row_size);
+          local_target += row_size;
+
+          // odometer increment of the source offset
+          for (size_t i = outer_rank; i-- > 0;) {
+            source_offset += outer_source_strides[i];
+            if (++coord[i] < outer_dims[i]) {
+              break;
+            }
+            source_offset -= outer_source_strides[i] * coord[i];
+            coord[i] = 0;
+          }
+        }
+      });
+}
+
+/* Blocked transpose of a coalesced permutation that moves the innermost axis.
+ * Let A be the input axis that becomes the innermost output axis, and B the innermost input axis.
+ * The [A, B] plane is split into cache sized tiles that are transposed with the MLAS strided kernels.
+ * The remaining axes are outer loops, and the thread pool partitions the (outer index, tile) pairs.
+ */
+bool DoBlockedTileTranspose(const CoalescedTranspose& t, gsl::span<const size_t> source_strides,
+                            const uint8_t* source, uint8_t* target, size_t element_size,
+                            concurrency::ThreadPool* tp) {
+  TransposeTileFn tile_fn = nullptr;
+  size_t tile_edge = 0;
+  switch (element_size) {
+    case sizeof(uint8_t):
+      tile_fn = GetTransposeTileFn<uint8_t>();
+      tile_edge = 128;
+      break;
+    case sizeof(uint16_t):
+      tile_fn = GetTransposeTileFn<uint16_t>();
+      tile_edge = 64;
+      break;
+    case sizeof(uint32_t):
+      tile_fn = GetTransposeTileFn<uint32_t>();
+      tile_edge = 64;
+      break;
+    case sizeof(uint64_t):
+      tile_fn = GetTransposeTileFn<uint64_t>();
+      tile_edge = 32;
+      break;
+    default:
+      break;
+  }
+
+  if (tile_fn == nullptr) {
+    return false;
+  }
+
+  const size_t rank = t.dims.size();
+
+  InlinedVector<size_t> target_strides(rank);
+  size_t total = 1;
+  for (size_t i = rank; i-- > 0;) {
+    target_strides[i] = total;
+    total *= t.dims[t.perm[i]];
+  }
+
+  const size_t axis_a = t.perm[rank - 1];
+  const size_t m = t.dims[axis_a];
+  const size_t n = t.dims[rank - 1];
+  const size_t ld_source = source_strides[axis_a];
+  size_t ld_target = 0;
+
+  InlinedVector<size_t> outer_dims;
+  InlinedVector<size_t> outer_source_strides;
+  InlinedVector<size_t> outer_target_strides;
+  for (size_t i = 0; i < rank - 1; ++i) {
+    if (t.perm[i] == rank - 1) {
+      ld_target = target_strides[i];
+    } else {
+      outer_dims.push_back(t.dims[t.perm[i]]);
+      outer_source_strides.push_back(source_strides[t.perm[i]]);
+      outer_target_strides.push_back(target_strides[i]);
+    }
+  }
+
+  // keep the tile area roughly constant when one side of the plane is narrow
+  size_t tile_m = std::min(m, tile_edge);
+  const size_t tile_n = std::min(n, tile_edge * tile_edge / tile_m);
+  tile_m = std::min(m, tile_edge * tile_edge / tile_n);
+
+  const size_t tiles_m = (m + tile_m - 1) / tile_m;
+  const size_t tiles_n = (n + tile_n - 1) / tile_n;
+  const size_t num_units = (total / (m * n)) * tiles_m * tiles_n;
+  const double tile_bytes = static_cast<double>(tile_m * tile_n * element_size);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_units),
+      TensorOpCost{tile_bytes, tile_bytes, static_cast<double>(tile_m * tile_n)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+          size_t index = static_cast<size_t>(unit);
+          const size_t n0 = (index % tiles_n) * tile_n;
+          index /= tiles_n;
+          const size_t m0 = (index % tiles_m) * tile_m;
+          index /= tiles_m;
+
+          size_t source_offset = 0;
+          size_t target_offset = 0;
+          ComputeTransposeOffsets(index, outer_dims, outer_source_strides, outer_target_strides,
+                                  source_offset, target_offset);
+          source_offset += m0 * ld_source + n0;
+          target_offset += n0 * ld_target + m0;
+
+          tile_fn(source + source_offset * element_size, ld_source, target + target_offset * element_size, ld_target,
+                  std::min(tile_m, m - m0), std::min(tile_n, n - n0));
+        }
+      });
+
+  return true;
+}
+
+// Transposes non-string data with the blocked engine. Returns false if the element size is not handled.
+bool DoBlockedTranspose(gsl::span<const size_t> permutations, gsl::span<const int64_t> input_dims,
+                        const uint8_t* source, uint8_t* target, size_t element_size, concurrency::ThreadPool* tp) {
+  const CoalescedTranspose coalesced = CoalesceTransposeAxes(permutations, input_dims);
+  const size_t rank = coalesced.dims.size();
+
+  InlinedVector<size_t> source_strides(rank);
+  size_t total = 1;
+  for (size_t i = rank; i-- > 0;) {
+    source_strides[i] = total;
+    total *= coalesced.dims[i];
+  }
+
+  if (rank <= 1) {
+    memcpy(target, source, total * element_size);
+    return true;
+  }
+
+  if (coalesced.perm[rank - 1] == rank - 1) {
+    DoBlockedRowTranspose(coalesced, source_strides, source, target, element_size, tp);
+    return true;
+  }
+
+  return DoBlockedTileTranspose(coalesced, source_strides, source, target, element_size, tp);
+}
+
+}  // namespace
+
 static Status TransposeImpl(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
                             const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
   TensorShape shape = input_shape_override ? *input_shape_override : input.Shape();
@@ -359,15 +627,13 @@ static Status TransposeImpl(const gsl::span<const size_t>& permutations, const T
     return Status::OK();
   }
 
-  size_t from = 0, to = 0;
-  bool moving_single_axis = IsTransposeMovingSingleAxis(permutations, from, to);
-
-  if (moving_single_axis && !input.IsDataTypeString()) {
-    SingleAxisTranspose(permutations, input, output, from, to, input_shape_override, tp);
+  if (!input.IsDataTypeString() && shape.Size() > 0 &&
+      DoBlockedTranspose(permutations, shape.GetDims(), reinterpret_cast<const uint8_t*>(input.DataRaw()),
+                         reinterpret_cast<uint8_t*>(output.MutableDataRaw()), input.DataType()->Size(), tp)) {
     return Status::OK();
   }
 
-  // fall back to default implementation
+  // strings, empty tensors and element sizes the blocked engine does not handle
   return DoUntypedTranspose(permutations, input, output, input_shape_override);
 }
 
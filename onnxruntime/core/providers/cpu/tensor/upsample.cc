@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "core/common/inlined_containers.h"
@@ -918,49 +919,56 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
-
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+// The 4 taps of the cubic interpolation of an output coordinate along one axis.
+struct CubicTaps {
+  // Index of the first input sample of the grid, before clamping to the input.
+  int64_t start;
+  // Clamped indices of the input samples.
+  std::array<int64_t, CubicModeGridLength> index;
+  std::array<float, CubicModeGridLength> coeff;
+  // The coefficients are divided by coeff_sum, which is not 1 only when exclude_outside is set.
+  float coeff_sum;
+  // The output is extrapolation_value.
+  bool extrapolate;
+};
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
+// Computes the taps of every output coordinate along an axis once, so the interpolation itself is two separable
+// passes over the precomputed tables.
+std::vector<CubicTaps> SetupCubicTaps(int64_t input_size, int64_t output_size, float scale, float cubic_coeff_a,
+                                      bool use_extrapolation, bool exclude_outside, float roi_start, float roi_end,
+                                      const GetOriginalCoordinateFunc& get_original_coordinate) {
+  std::vector<CubicTaps> taps(narrow<size_t>(output_size));
+  for (int64_t i = 0; i < output_size; ++i) {
+    const float in = scale == 1 ? static_cast<float>(i)
+                                : get_original_coordinate(static_cast<float>(i), scale,
+                                                          static_cast<float>(output_size),
+                                                          static_cast<float>(input_size), roi_start, roi_end);
+    auto& t = taps[narrow<size_t>(i)];
+    t.extrapolate = use_extrapolation && (in < 0 || in > static_cast<float>(input_size - 1));
+    const auto in_int = static_cast<int64_t>(std::floor(in));
+    const auto coeffs = GetCubicCoeffs(in - std::floor(in), cubic_coeff_a);
+    t.start = in_int - 1;
+    t.coeff_sum = exclude_outside ? 0.0f : 1.0f;
+    for (size_t k = 0; k < CubicModeGridLength; ++k) {
+      const int64_t index = t.start + static_cast<int64_t>(k);
+      t.index[k] = std::max(static_cast<int64_t>(0), std::min(index, input_size - 1));
+      t.coeff[k] = coeffs[k];
+      if (exclude_outside) {
+        // When true, the weight of sampling locations outside the grid will be set to 0
+        // and the weight will be renormalized so that their sum is 1.0
+        if (index < 0 || index >= input_size) {
+          t.coeff[k] = 0.0f;
+        }
+        t.coeff_sum += t.coeff[k];
+      }
+    }
   }
-  cache[grid_start_pos] = result;
-
-  return result;
+  return taps;
 }
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
+
+// Bicubic resize of planar (NCHW or 2-D) data as two separable passes: each input row needed by a block of output
+// rows is first interpolated horizontally into a scratch buffer, then the output rows are interpolated vertically
+// from 4 of the scratch rows. The planes and the blocks of output rows are distributed over the thread pool.
 template <typename T>
 void ResizeBiCubic(int64_t batch_size,
                    int64_t num_channels,
@@ -975,140 +983,112 @@ void ResizeBiCubic(int64_t batch_size,
                    float extrapolation_value,
                    bool exclude_outside,
                    gsl::span<const float> roi,
-                   const T* Xdata,
-                   T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
-  std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
-
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
-
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
+                   const T* XdataBase,
+                   T* YdataBase,
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
+  const auto roi_y_start = roi.size() / 2 - 2;
+  const auto roi_y_end = roi.size() - 2;
+  const auto roi_x_start = roi.size() / 2 - 1;
+  const auto roi_x_end = roi.size() - 1;
+
+  const std::vector<CubicTaps> y_taps = SetupCubicTaps(input_height, output_height, height_scale, cubic_coeff_a,
+                                                       use_extrapolation, exclude_outside, roi[roi_y_start],
+                                                       roi[roi_y_end], get_original_coordinate);
+  const std::vector<CubicTaps> x_taps = SetupCubicTaps(input_width, output_width, width_scale, cubic_coeff_a,
+                                                       use_extrapolation, exclude_outside, roi[roi_x_start],
+                                                       roi[roi_x_end], get_original_coordinate);
+
+  constexpr int64_t kRowsPerBlock = 16;
+  const int64_t num_planes = batch_size * num_channels;
+  const int64_t blocks_per_plane = (output_height + kRowsPerBlock - 1) / kRowsPerBlock;
+  const double block_cost = static_cast<double>(std::min(kRowsPerBlock, output_height) * output_width) * 16.0;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_planes * blocks_per_plane),
+      TensorOpCost{block_cost, static_cast<double>(std::min(kRowsPerBlock, output_height) * output_width), block_cost},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // Horizontally interpolated input rows of the current block, one slot per distinct input row of its taps,
+        // so at most CubicModeGridLength * kRowsPerBlock of them. block_rows is the sorted input row of each slot.
+        std::vector<float> rows;
+        std::vector<int64_t> block_rows;
+
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const int64_t plane = block / blocks_per_plane;
+          const int64_t y_begin = (block % blocks_per_plane) * kRowsPerBlock;
+          const int64_t y_end = std::min(y_begin + kRowsPerBlock, output_height);
+          const T* Xdata = XdataBase + plane * input_height * input_width;
+          T* Ydata = YdataBase + plane * output_height * output_width;
+
+          block_rows.clear();
+          for (int64_t y = y_begin; y < y_end; ++y) {
+            const auto& t = y_taps[narrow<size_t>(y)];
+            if (!t.extrapolate) {
+              block_rows.insert(block_rows.end(), t.index.begin(), t.index.end());
+            }
           }
-        }
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
+          std::sort(block_rows.begin(), block_rows.end());
+          block_rows.erase(std::unique(block_rows.begin(), block_rows.end()), block_rows.end());
+          rows.resize(block_rows.size() * narrow<size_t>(output_width));
+
+          for (size_t slot = 0; slot < block_rows.size(); ++slot) {
+            const T* input_row = Xdata + block_rows[slot] * input_width;
+            float* h = rows.data() + slot * output_width;
+            for (int64_t x = 0; x < output_width; ++x) {
+              const auto& t = x_taps[narrow<size_t>(x)];
+              float result = 0;
+              for (size_t k = 0; k < CubicModeGridLength; ++k) {
+                result += t.coeff[k] / t.coeff_sum * input_row[t.index[k]];
+              }
+              h[x] = result;
+            }
           }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
+          auto get_row = [&](int64_t row) -> const float* {
+            const auto slot = static_cast<size_t>(
+                std::lower_bound(block_rows.begin(), block_rows.end(), row) - block_rows.begin());
+            return rows.data() + slot * output_width;
+          };
+
+          for (int64_t y = y_begin; y < y_end; ++y) {
+            const auto& ty = y_taps[narrow<size_t>(y)];
+            T* output_row = Ydata + y * output_width;
+
+            // when use_extrapolation is set and original index is out of the dim range
+            // then use extrapolation_value as the output value.
+            if (ty.extrapolate) {
+              std::fill_n(output_row, output_width, static_cast<T>(extrapolation_value));
+              continue;
             }
-          }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
+            const float* h0 = get_row(ty.index[0]);
+            const float* h1 = get_row(ty.index[1]);
+            const float* h2 = get_row(ty.index[2]);
+            const float* h3 = get_row(ty.index[3]);
+            const float c0 = ty.coeff[0];
+            const float c1 = ty.coeff[1];
+            const float c2 = ty.coeff[2];
+            const float c3 = ty.coeff[3];
+            const float sum = ty.coeff_sum;
+            for (int64_t x = 0; x < output_width; ++x) {
+              float result = 0;
+              result += h0[x] * c0 / sum;
+              result += h1[x] * c1 / sum;
+              result += h2[x] * c2 / sum;
+              result += h3[x] * c3 / sum;
+              output_row[x] = static_cast<T>(result);
+            }
+            if (use_extrapolation) {
+              for (int64_t x = 0; x < output_width; ++x) {
+                if (x_taps[narrow<size_t>(x)].extrapolate) {
+                  output_row[x] = static_cast<T>(extrapolation_value);
+                }
+              }
+            }
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
-      }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
-  }
+      });
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -1352,7 +1332,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                       extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      Y->MutableData<float>(), get_original_coordinate_,
+                      output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
       }
       return Status::OK();
     }
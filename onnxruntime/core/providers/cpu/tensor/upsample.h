@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #ifndef SHARED_PROVIDER
 #include "core/framework/op_kernel.h"
@@ -101,38 +102,50 @@ void UpsampleBilinear(const int32_t batch_size,
   BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width,
                                            height_scale, width_scale, roi,
                                            alloc, get_original_coordinate, true);
-  for (int32_t n = 0; n < batch_size; ++n) {
-    concurrency::ThreadPool::TrySimpleParallelFor(
-        tp, num_channels,
-        [&](std::ptrdiff_t c) {
-          const T* const Xdata =
-              XdataBase + (n * num_channels + static_cast<int32_t>(c)) * (input_height * input_width);
-          T* const Ydata = YdataBase + (n * num_channels + static_cast<int32_t>(c)) * (output_height * output_width);
-          for (int32_t y = 0; y < output_height; ++y) {
-            for (int32_t x = 0; x < output_width; ++x) {
-              const int32_t output_offset = output_width * y + x;
-              // when use_extrapolation is set and original index of x or y is out of the dim range
-              // then use extrapolation_value as the output value.
-              if (use_extrapolation &&
-                  ((p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1)) ||
-                   (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1)))) {
-                Ydata[output_offset] = static_cast<T>(extrapolation_value);
-                continue;
-              }
-
-              T X11 = Xdata[p.input_width_mul_y1[y] + p.in_x1[x]];
-              T X21 = Xdata[p.input_width_mul_y1[y] + p.in_x2[x]];
-              T X12 = Xdata[p.input_width_mul_y2[y] + p.in_x1[x]];
-              T X22 = Xdata[p.input_width_mul_y2[y] + p.in_x2[x]];
+  // Rows of all the planes are distributed over the thread pool, so that images with few channels still use all
+  // the threads. The coefficients of a row are loaded once per row.
+  const std::ptrdiff_t num_rows = static_cast<std::ptrdiff_t>(batch_size) * num_channels * output_height;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_rows, static_cast<double>(output_width * 4),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const std::ptrdiff_t plane = row / output_height;
+          const auto y = static_cast<int32_t>(row % output_height);
+          const T* const Xdata = XdataBase + plane * (input_height * input_width);
+          T* const Ydata = YdataBase + plane * (output_height * output_width) + output_width * y;
+
+          // when use_extrapolation is set and original index of x or y is out of the dim range
+          // then use extrapolation_value as the output value.
+          const bool extrapolate_row =
+              use_extrapolation && (p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1));
+          if (extrapolate_row) {
+            std::fill_n(Ydata, output_width, static_cast<T>(extrapolation_value));
+            continue;
+          }
 
-              Ydata[output_offset] = static_cast<T>(p.dx2[x] * p.dy2[y] * X11 +
-                                                    p.dx1[x] * p.dy2[y] * X21 +
-                                                    p.dx2[x] * p.dy1[y] * X12 +
-                                                    p.dx1[x] * p.dy1[y] * X22);
+          const T* const Xrow1 = Xdata + p.input_width_mul_y1[y];
+          const T* const Xrow2 = Xdata + p.input_width_mul_y2[y];
+          const float dy1 = p.dy1[y];
+          const float dy2 = p.dy2[y];
+          for (int32_t x = 0; x < output_width; ++x) {
+            if (use_extrapolation &&
+                (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1))) {
+              Ydata[x] = static_cast<T>(extrapolation_value);
+              continue;
             }
+
+            T X11 = Xrow1[p.in_x1[x]];
+            T X21 = Xrow1[p.in_x2[x]];
+            T X12 = Xrow2[p.in_x1[x]];
+            T X22 = Xrow2[p.in_x2[x]];
+
+            Ydata[x] = static_cast<T>(p.dx2[x] * dy2 * X11 +
+                                      p.dx1[x] * dy2 * X21 +
+                                      p.dx2[x] * dy1 * X12 +
+                                      p.dx1[x] * dy1 * X22);
           }
-        });
-  }
+        }
+      });
 }
 
 template <typename T, bool UseExtrapolation>
@@ -4,6 +4,8 @@
 #include "string_normalizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
 // Used below HAS_DEPRECATED_DECLARATIONS
 #include "onnxruntime_config.h"
 
@@ -14,6 +16,7 @@
 #include <codecvt>
 #include <locale>
 #include <functional>
+#include <vector>
 
 #if defined(__GNUC__)
 // Allow deprecated-declarations warning - std::codecvt_utf8 is deprecatedd
@@ -523,58 +526,98 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   // for UTF-8 and requires additional dependency.
 
   Locale locale(locale_name_);
-  Utf8Converter converter;
 
-  // Compute the largest widestring buffer needed.
-  size_t max_wide_buffer_len = 0;
+  size_t total_bytes = 0;
   for (const auto& s : input_span) {
+    total_bytes += s.size();
+  }
+  const double bytes_per_string = static_cast<double>(total_bytes) / input_span.size();
+  const TensorOpCost cost{bytes_per_string, bytes_per_string, bytes_per_string * 16.0};
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  // Runs fn(i, converter, wchar_buffer) for each i in [0, count), in chunks of strings spread over the thread pool.
+  // Each chunk has its own converter and reuses its wide char buffer. Returns the error of the failed string with the
+  // lowest index, if any, as the serial loop did.
+  auto for_each_string = [&](size_t count,
+                             const std::function<Status(size_t, Utf8Converter&, std::wstring&)>& fn) {
+    OrtMutex status_mutex;
+    Status status;
+    size_t status_index = count;
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(count), cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          Utf8Converter converter;
+          std::wstring wchar_buffer;
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            Status string_status = fn(static_cast<size_t>(i), converter, wchar_buffer);
+            if (!string_status.IsOK()) {
+              std::lock_guard<OrtMutex> lock(status_mutex);
+              if (static_cast<size_t>(i) < status_index) {
+                status_index = static_cast<size_t>(i);
+                status = std::move(string_status);
+              }
+              return;
+            }
+          }
+        });
+    return status;
+  };
+
+  // Converts s to wide chars and changes their case with caseaction.
+  auto to_wide_char = [&locale](Utf8Converter& converter, const std::string& s, CaseAction caseaction,
+                                std::wstring& wchar_buffer) {
     size_t wchars = 0;
     // Checks for invalid UTF-8 characters on Windows
     ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(s, wchars));
-    max_wide_buffer_len = std::max(max_wide_buffer_len, wchars);
-  }
+    wchar_buffer.resize(wchars);
+    ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
+    locale.ChangeCase(caseaction, wchar_buffer);
+    return Status::OK();
+  };
 
-  // Reuse reserved space
-  std::wstring wchar_buffer;
-  wchar_buffer.reserve(max_wide_buffer_len);
+  // Writes s to dest with the case changed as required.
+  auto output_string = [&](const std::string& s, std::string& dest, Utf8Converter& converter,
+                           std::wstring& wchar_buffer) {
+    if (case_change_action_ == NONE) {
+      dest = s;
+      return Status::OK();
+    }
+    ORT_RETURN_IF_ERROR(to_wide_char(converter, s, case_change_action_, wchar_buffer));
+    size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
+    dest.resize(utf8_buffer_len);
+    return converter.ConvertToUtf8(wchar_buffer, dest);
+  };
 
   // Output everything and change case as required
   auto output_no_filtering = [&](const TensorShape& output_shape) {
     auto output_tensor = ctx->Output(0, output_shape);
     auto const output_data = output_tensor->MutableData<std::string>();
-    for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-      const std::string& s = input_span[i];
-      wchar_buffer.resize(max_wide_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-      locale.ChangeCase(case_change_action_, wchar_buffer);
+    return for_each_string(input_span.size(), [&](size_t i, Utf8Converter& converter, std::wstring& wchar_buffer) {
+      return output_string(input_span[i], output_data[i], converter, wchar_buffer);
+    });
+  };
 
-      auto& dest = output_data[i];
-      size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-      dest.resize(utf8_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
+  // Output the strings that are not stop words, in order. keep[i] tells whether input_span[i] is output.
+  auto output_filtered = [&](TensorShapeVector& output_shape, gsl::span<const uint8_t> keep) {
+    InlinedVector<size_t> filtered_strings_indices;
+    filtered_strings_indices.reserve(input_span.size());
+    for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
+      if (keep[i]) {
+        filtered_strings_indices.push_back(i);
+      }
     }
-    return Status::OK();
-  };
 
-  auto output_filtered = [&](const TensorShape& output_shape, gsl::span<const size_t> filtered_indices) {
+    // According to the spec, if all strings are filtered out
+    // the output must have a shape of {1} with a single empty string.
+    const int64_t filtered_count = std::max<int64_t>(1, narrow<int64_t>(filtered_strings_indices.size()));
+    output_shape.push_back(filtered_count);
     auto output_tensor = ctx->Output(0, output_shape);
     auto output_data = output_tensor->MutableData<std::string>();
-    for (size_t i : filtered_indices) {
-      const std::string& s = input_span[i];
-      if (case_change_action_ != NONE) {
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(case_change_action_, wchar_buffer);
-
-        auto& dest = *output_data++;
-        size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-        dest.resize(utf8_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
-      } else {
-        *output_data++ = s;
-      }
-    }
-    return Status::OK();
+    return for_each_string(filtered_strings_indices.size(),
+                           [&](size_t i, Utf8Converter& converter, std::wstring& wchar_buffer) {
+                             return output_string(input_span[filtered_strings_indices[i]], output_data[i], converter,
+                                                  wchar_buffer);
+                           });
   };
 
   Status status;
@@ -585,22 +628,16 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       output_shape.push_back(C);
       status = output_no_filtering(output_shape);
     } else {
-      // we need to filter
-      InlinedVector<size_t> filtered_strings_indices;
-      filtered_strings_indices.reserve(input_span.size());
-
-      for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-        const std::string& s = input_span[i];
-        if (stopwords_.count(s) == 0) {
-          filtered_strings_indices.push_back(i);
-        }
-      }
-
-      // According to the spec, if all strings are filtered out
-      // the output must have a shape of {1} with a single empty string.
-      const int64_t filtered_count = std::max<int64_t>(1, narrow<int64_t>(filtered_strings_indices.size()));
-      output_shape.push_back(filtered_count);
-      status = output_filtered(output_shape, filtered_strings_indices);
+      // we need to filter. The strings are compared as they are, but every input string must be valid UTF-8,
+      // including the filtered out ones and the ones output without a case change.
+      std::vector<uint8_t> keep(input_span.size());
+      ORT_RETURN_IF_ERROR(for_each_string(input_span.size(), [&](size_t i, Utf8Converter& converter, std::wstring&) {
+        size_t wchars = 0;
+        ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(input_span[i], wchars));
+        keep[i] = stopwords_.count(input_span[i]) == 0;
+        return Status::OK();
+      }));
+      status = output_filtered(output_shape, keep);
     }
   } else {
     if (wstopwords_.empty()) {
@@ -611,23 +648,15 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       // Case insensitive filtering is performed by converting the input strings
       // to compare_caseaction_. For that we convert to wchar_t UNICODE.
       // Otherwise, we need to pull ICU library on all platforms.
-      InlinedVector<size_t> filtered_strings_indices;
-      filtered_strings_indices.reserve(input_span.size());
-      for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-        const std::string& s = input_span[i];
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(compare_caseaction_, wchar_buffer);
-        if (wstopwords_.count(wchar_buffer) == 0) {
-          filtered_strings_indices.push_back(i);
-        }
-      }
-
-      // According to the spec, if all strings are filtered out
-      // the output must have a shape of {1} with a single empty string.
-      const int64_t filtered_count = std::max<int64_t>(1, narrow<int64_t>(filtered_strings_indices.size()));
-      output_shape.push_back(filtered_count);
-      status = output_filtered(output_shape, filtered_strings_indices);
+      std::vector<uint8_t> keep(input_span.size());
+      ORT_RETURN_IF_ERROR(for_each_string(input_span.size(),
+                                          [&](size_t i, Utf8Converter& converter, std::wstring& wchar_buffer) {
+                                            ORT_RETURN_IF_ERROR(to_wide_char(converter, input_span[i],
+                                                                             compare_caseaction_, wchar_buffer));
+                                            keep[i] = wstopwords_.count(wchar_buffer) == 0;
+                                            return Status::OK();
+                                          }));
+      status = output_filtered(output_shape, keep);
     }
   }
 
@@ -6,6 +6,7 @@
 #include <limits>
 #include <string>
 #include "core/common/common.h"
+#include "core/platform/threadpool.h"
 namespace onnxruntime {
 
 ONNX_CPU_OPERATOR_KERNEL(StringSplit, 20,
@@ -67,19 +68,29 @@ Status StringSplit::Compute(OpKernelContext* context) const {
 
   // Set up number of tokens output
   auto num_tokens_data = context->Output(1, input->Shape())->template MutableDataAsSpan<int64_t>();
-  auto num_tokens_iter = num_tokens_data.begin();
-
-  InlinedVector<InlinedVector<std::string_view>> input_slices;
-  input_slices.reserve(input_data.size());
-  size_t last_dim = 0;
 
+  size_t total_bytes = 0;
   for (const auto& s : input_data) {
-    auto& substrs = input_slices.emplace_back();
-    ComputeSubstrings(s, delimiter_, maxsplit_, substrs);
-    auto substr_count = substrs.size();
-    last_dim = std::max(last_dim, substr_count);
-    *num_tokens_iter = static_cast<int64_t>(substr_count);
-    ++num_tokens_iter;
+    total_bytes += s.size();
+  }
+  const double bytes_per_string = input_data.empty() ? 0.0 : static_cast<double>(total_bytes) / input_data.size();
+  const auto num_strings = static_cast<std::ptrdiff_t>(input_data.size());
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  // The strings are split, and their substrings copied to the output, in parallel chunks of strings.
+  InlinedVector<InlinedVector<std::string_view>> input_slices(input_data.size());
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_strings, TensorOpCost{bytes_per_string, bytes_per_string, bytes_per_string * 2.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          ComputeSubstrings(input_data[i], delimiter_, maxsplit_, input_slices[i]);
+          num_tokens_data[i] = static_cast<int64_t>(input_slices[i].size());
+        }
+      });
+
+  size_t last_dim = 0;
+  for (const auto& substrs : input_slices) {
+    last_dim = std::max(last_dim, substrs.size());
   }
 
   // Set up splits output
@@ -87,10 +98,14 @@ Status StringSplit::Compute(OpKernelContext* context) const {
   splits_shape.push_back(last_dim);
 
   auto splits_data = context->Output(0, splits_shape)->template MutableDataAsSpan<std::string>();
-  auto slices_iter = input_slices.begin();
-  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++slices_iter) {
-    std::copy(slices_iter->begin(), slices_iter->end(), output_splits_iter);
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_strings,
+      TensorOpCost{bytes_per_string, bytes_per_string, static_cast<double>(last_dim * sizeof(std::string))},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          std::copy(input_slices[i].begin(), input_slices[i].end(), splits_data.begin() + i * last_dim);
+        }
+      });
 
   return Status::OK();
 }
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/tuning_context.h"
+
+namespace onnxruntime {
+
+class CPUExecutionProvider;
+
+namespace cpu {
+
+struct TunableOpInfo;
+
+namespace tunable {
+
+class CpuTuningResultsValidator : public TuningResultsValidator {
+ public:
+  CpuTuningResultsValidator();
+
+ protected:
+  // Results tuned on one micro-architecture are not meaningful on another one, e.g., the winner on an AVX512 machine
+  // might be a loser on an AVX2 only machine.
+  std::string GetCpuIsa() const;
+  Status ValidateCpuIsa(const std::string& value) const;
+};
+
+// Tuning context of the CPU EP. Only decisions that a kernel makes per call can be tuned, currently the thread
+// partitioning of the fp32 MatMul. The NCHWc vs im2col choice for Conv is made by the NchwcTransformer when the graph
+// is optimized, before any kernel runs, and the MLAS convolution algorithm is chosen inside MlasConvPrepare, so
+// neither is a candidate of a TunableOp.
+class CpuTuningContext : public ITuningContext {
+ public:
+  explicit CpuTuningContext(CPUExecutionProvider* ep, TunableOpInfo* info);
+
+  void EnableTunableOp() override;
+  void DisableTunableOp() override;
+  bool IsTunableOpEnabled() const override;
+
+  void EnableTuning() override;
+  void DisableTuning() override;
+  bool IsTuningEnabled() const override;
+
+  void SetMaxTuningDurationMs(int max_duration_ms) override;
+  int GetMaxTuningDurationMs() const override;
+
+  TuningResultsManager& GetTuningResultsManager() override;
+  const TuningResultsManager& GetTuningResultsManager() const override;
+
+  const TuningResultsValidator& GetTuningResultsValidator() const override;
+
+ private:
+  TunableOpInfo* info_;  // non-owning handle
+  TuningResultsManager manager_;
+  CpuTuningResultsValidator validator_;
+};
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/math/matmul.h"
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+MatMulParams::MatMulParams(CpuTuningContext* tuning_ctx, const MatMul<float>* matmul_kernel,
+                           const MatMulComputeHelper& helper, bool trans_a, bool trans_b,
+                           const float* a_data, const float* b_data, float* y_data,
+                           concurrency::ThreadPool* thread_pool)
+    : OpParams(tuning_ctx, nullptr),
+      matmul_kernel_(matmul_kernel),
+      helper_(helper),
+      trans_a_(trans_a),
+      trans_b_(trans_b),
+      a_data_(a_data),
+      b_data_(b_data),
+      y_data_(y_data),
+      thread_pool_(thread_pool) {}
+
+std::string MatMulParams::Signature() const {
+  // The winner depends on the weight packing and on the number of threads available, not only on the shapes.
+  return MakeString((trans_a_ ? "T" : "N"), (trans_b_ ? "T" : "N"), "_", helper_.M(), "_", helper_.N(), "_",
+                    helper_.K(), "_", helper_.OutputOffsets().size(), "_", matmul_kernel_->PackedBKind(), "_",
+                    concurrency::ThreadPool::DegreeOfParallelism(thread_pool_));
+}
+
+namespace {
+
+// MLAS partitions every GEMM over the intra-op thread pool.
+common::Status DefaultMatMulOp(const MatMulParams* params) {
+  params->matmul_kernel_->ComputeGemm(params->helper_, params->trans_a_, params->trans_b_, params->a_data_,
+                                      params->b_data_, params->y_data_, 0, params->helper_.OutputOffsets().size(),
+                                      params->thread_pool_);
+  return Status::OK();
+}
+
+// Small or skinny GEMMs can be dominated by the cost of waking up and synchronizing the worker threads.
+common::Status SingleThreadMatMulOp(const MatMulParams* params) {
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool_) <= 1,
+                                            "single threaded MatMul is identical to the default one");
+  params->matmul_kernel_->ComputeGemm(params->helper_, params->trans_a_, params->trans_b_, params->a_data_,
+                                      params->b_data_, params->y_data_, 0, params->helper_.OutputOffsets().size(),
+                                      nullptr);
+  return Status::OK();
+}
+
+// Batched GEMMs with many small matrices can do better with one whole GEMM per thread.
+common::Status BatchParallelMatMulOp(const MatMulParams* params) {
+  const size_t batch_count = params->helper_.OutputOffsets().size();
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(batch_count <= 1, "no batch to parallelize over");
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool_) <= 1,
+                                            "batch parallel MatMul is identical to the single threaded one");
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      params->thread_pool_, static_cast<std::ptrdiff_t>(batch_count), [params](std::ptrdiff_t batch) {
+        params->matmul_kernel_->ComputeGemm(params->helper_, params->trans_a_, params->trans_b_, params->a_data_,
+                                            params->b_data_, params->y_data_, static_cast<size_t>(batch),
+                                            static_cast<size_t>(batch) + 1, nullptr);
+      });
+  return Status::OK();
+}
+
+class MatMulTunableOp : public TunableOp<MatMulParams> {
+ public:
+  MatMulTunableOp() {
+    this->RegisterOp(DefaultMatMulOp);
+    this->RegisterOp(SingleThreadMatMulOp);
+    this->RegisterOp(BatchParallelMatMulOp);
+  }
+};
+
+}  // namespace
+
+common::Status TunableMatMul(CpuTuningContext* tuning_ctx, const MatMul<float>* matmul_kernel,
+                             const MatMulComputeHelper& helper, bool trans_a, bool trans_b,
+                             const float* a_data, const float* b_data, float* y_data,
+                             concurrency::ThreadPool* thread_pool) {
+  MatMulParams params(tuning_ctx, matmul_kernel, helper, trans_a, trans_b, a_data, b_data, y_data, thread_pool);
+  if (params.tuning_ctx->IsTunableOpEnabled()) {
+    static MatMulTunableOp matmul{};
+    return matmul(&params);
+  }
+
+  return DefaultMatMulOp(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
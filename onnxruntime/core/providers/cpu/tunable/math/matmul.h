@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/status.h"
+#include "core/providers/cpu/math/matmul.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+struct MatMulParams : OpParams {
+  MatMulParams(CpuTuningContext* tuning_ctx, const MatMul<float>* matmul_kernel, const MatMulComputeHelper& helper,
+               bool trans_a, bool trans_b, const float* a_data, const float* b_data, float* y_data,
+               concurrency::ThreadPool* thread_pool);
+
+  std::string Signature() const override;
+
+  const MatMul<float>* matmul_kernel_;
+  const MatMulComputeHelper& helper_;
+  bool trans_a_;
+  bool trans_b_;
+  const float* a_data_;
+  const float* b_data_;
+  float* y_data_;
+  concurrency::ThreadPool* thread_pool_;
+};
+
+common::Status TunableMatMul(CpuTuningContext* tuning_ctx, const MatMul<float>* matmul_kernel,
+                             const MatMulComputeHelper& helper, bool trans_a, bool trans_b,
+                             const float* a_data, const float* b_data, float* y_data,
+                             concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -454,6 +454,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_THROW_IF_ERROR(graph_transformer_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps));
+  graph_transformer_mgr_.SetProfiler(&session_profiler_);
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -1743,6 +1744,19 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    if (const auto* cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider); cpu_ep != nullptr) {
+      auto* tuning_ctx = cpu_ep->GetTuningContext();
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        tuning_ctx->EnableTuning();
+      }
+      tuning_ctx->SetMaxTuningDurationMs(ParseStringWithClassicLocale<int>(
+          config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "0")));
+    }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
     session_state_->SetMemoryProfiler(&memory_profiler_);
@@ -2561,15 +2575,6 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_CHECK_AND_SET_RETVAL(start_func());
       }
 
-#ifdef ENABLE_TRAINING
-      if (run_options.only_execute_path_to_fetches) {
-        // TODO: this method is not thread safe, if multiple Run happened in parallel we might hit race condition issue.
-        // currently it only used in training, there is no parallel run execution in training so it is ok.
-        // but it is better we can fix it with a better solution.
-        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
-      }
-#endif
-
       // execute the graph
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       session_state_->IncrementGraphExecutionCounter();
@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/common/random_generator.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct GroupQueryAttentionConfig {
+  int batch_size;
+  int sequence_length;
+  int num_heads;
+  int kv_num_heads;
+  int head_size;
+  int rotary_dim;  // 0 disables the rotary embedding
+  int past_sequence_length;
+  int total_sequence_length;
+  std::vector<int32_t> seqlens_k;
+  bool interleaved;
+  bool packed_qkv;
+};
+
+// Rotates the first rotary_dim elements of one head row by the cos/sin cache row of the given position.
+void ReferenceRotaryEmbedding(const float* input, const float* cos_cache, const float* sin_cache, int position,
+                              int head_size, int rotary_dim, bool interleaved, float* output) {
+  const int half_rotary_dim = rotary_dim / 2;
+  const float* cos_row = cos_cache + position * half_rotary_dim;
+  const float* sin_row = sin_cache + position * half_rotary_dim;
+  std::copy(input, input + head_size, output);
+  for (int i = 0; i < half_rotary_dim; ++i) {
+    const int i0 = interleaved ? 2 * i : i;
+    const int i1 = interleaved ? 2 * i + 1 : i + half_rotary_dim;
+    output[i0] = input[i0] * cos_row[i] - input[i1] * sin_row[i];
+    output[i1] = input[i1] * cos_row[i] + input[i0] * sin_row[i];
+  }
+}
+
+// Computes GroupQueryAttention one step at a time, the way the kernel did before the rotary embedding was fused
+// into the KV cache append: rotate Q and K, concatenate past and new K/V into the present cache, then attend.
+void ReferenceGroupQueryAttention(const GroupQueryAttentionConfig& c, const std::vector<float>& query,
+                                  const std::vector<float>& key, const std::vector<float>& value,
+                                  const std::vector<float>& past_key, const std::vector<float>& past_value,
+                                  const std::vector<float>& cos_cache, const std::vector<float>& sin_cache,
+                                  std::vector<float>& output, std::vector<float>& present_key,
+                                  std::vector<float>& present_value) {
+  const int B = c.batch_size;
+  const int S = c.sequence_length;
+  const int N = c.num_heads;
+  const int N_kv = c.kv_num_heads;
+  const int H = c.head_size;
+  const int P = c.past_sequence_length;
+  const int T = std::max(c.total_sequence_length, P);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  output.assign(static_cast<size_t>(B) * S * N * H, 0.0f);
+  present_key.assign(static_cast<size_t>(B) * N_kv * T * H, 0.0f);
+  present_value.assign(static_cast<size_t>(B) * N_kv * T * H, 0.0f);
+  std::vector<float> q_rotated(static_cast<size_t>(B) * S * N * H);
+
+  for (int b = 0; b < B; ++b) {
+    const int past_seqlen = S == 1 ? c.seqlens_k[b] : 0;
+    for (int n = 0; n < N_kv; ++n) {
+      const size_t present_offset = (static_cast<size_t>(b) * N_kv + n) * T * H;
+      for (int t = 0; t < past_seqlen; ++t) {
+        const size_t past_offset = ((static_cast<size_t>(b) * N_kv + n) * P + t) * H;
+        std::copy_n(past_key.data() + past_offset, H, present_key.data() + present_offset + t * H);
+        std::copy_n(past_value.data() + past_offset, H, present_value.data() + present_offset + t * H);
+      }
+      for (int s = 0; s < S; ++s) {
+        const size_t input_offset = ((static_cast<size_t>(b) * S + s) * N_kv + n) * H;
+        float* k_dst = present_key.data() + present_offset + static_cast<size_t>(past_seqlen + s) * H;
+        if (c.rotary_dim > 0) {
+          ReferenceRotaryEmbedding(key.data() + input_offset, cos_cache.data(), sin_cache.data(), past_seqlen + s, H,
+                                   c.rotary_dim, c.interleaved, k_dst);
+        } else {
+          std::copy_n(key.data() + input_offset, H, k_dst);
+        }
+        std::copy_n(value.data() + input_offset, H,
+                    present_value.data() + present_offset + static_cast<size_t>(past_seqlen + s) * H);
+      }
+    }
+
+    for (int s = 0; s < S; ++s) {
+      for (int n = 0; n < N; ++n) {
+        const size_t q_offset = ((static_cast<size_t>(b) * S + s) * N + n) * H;
+        if (c.rotary_dim > 0) {
+          ReferenceRotaryEmbedding(query.data() + q_offset, cos_cache.data(), sin_cache.data(), past_seqlen + s, H,
+                                   c.rotary_dim, c.interleaved, q_rotated.data() + q_offset);
+        } else {
+          std::copy_n(query.data() + q_offset, H, q_rotated.data() + q_offset);
+        }
+
+        const int kv_head = n / (N / N_kv);
+        const float* k = present_key.data() + (static_cast<size_t>(b) * N_kv + kv_head) * T * H;
+        const float* v = present_value.data() + (static_cast<size_t>(b) * N_kv + kv_head) * T * H;
+        const int causal_length = S == 1 ? c.seqlens_k[b] + 1 : s + 1;
+
+        std::vector<float> probs(causal_length);
+        float max_score = -std::numeric_limits<float>::infinity();
+        for (int t = 0; t < causal_length; ++t) {
+          float dot = 0.0f;
+          for (int h = 0; h < H; ++h) {
+            dot += q_rotated[q_offset + h] * k[t * H + h];
+          }
+          probs[t] = dot * scale;
+          max_score = std::max(max_score, probs[t]);
+        }
+        float sum = 0.0f;
+        for (int t = 0; t < causal_length; ++t) {
+          probs[t] = std::exp(probs[t] - max_score);
+          sum += probs[t];
+        }
+        for (int t = 0; t < causal_length; ++t) {
+          for (int h = 0; h < H; ++h) {
+            output[q_offset + h] += probs[t] / sum * v[t * H + h];
+          }
+        }
+      }
+    }
+  }
+}
+
+void RunGroupQueryAttentionTest(const GroupQueryAttentionConfig& c) {
+  const int B = c.batch_size;
+  const int S = c.sequence_length;
+  const int N = c.num_heads;
+  const int N_kv = c.kv_num_heads;
+  const int H = c.head_size;
+  const int P = c.past_sequence_length;
+  const int T = std::max(c.total_sequence_length, P);
+  const int max_sequence_length = c.total_sequence_length + 2;
+
+  RandomValueGenerator random{1234};
+  const std::vector<int64_t> q_dims{B, S, N * H};
+  const std::vector<int64_t> kv_dims{B, S, N_kv * H};
+  const std::vector<int64_t> past_dims{B, N_kv, P, H};
+  const std::vector<int64_t> present_dims{B, N_kv, T, H};
+  const std::vector<int64_t> cache_dims{max_sequence_length, c.rotary_dim / 2};
+  std::vector<float> query = random.Uniform<float>(q_dims, -1.0f, 1.0f);
+  std::vector<float> key = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  std::vector<float> value = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  std::vector<float> past_key = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  std::vector<float> past_value = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  std::vector<float> cos_cache = random.Uniform<float>(cache_dims, -1.0f, 1.0f);
+  std::vector<float> sin_cache = random.Uniform<float>(cache_dims, -1.0f, 1.0f);
+
+  std::vector<float> output;
+  std::vector<float> present_key;
+  std::vector<float> present_value;
+  ReferenceGroupQueryAttention(c, query, key, value, past_key, past_value, cos_cache, sin_cache, output, present_key,
+                               present_value);
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", N);
+  test.AddAttribute<int64_t>("kv_num_heads", N_kv);
+  test.AddAttribute<int64_t>("do_rotary", c.rotary_dim > 0 ? 1 : 0);
+  test.AddAttribute<int64_t>("rotary_interleaved", c.interleaved ? 1 : 0);
+
+  if (c.packed_qkv) {
+    // Each token holds the query heads, then the key heads, then the value heads.
+    const int packed_hidden_size = (N + 2 * N_kv) * H;
+    std::vector<float> packed(static_cast<size_t>(B) * S * packed_hidden_size);
+    for (int bs = 0; bs < B * S; ++bs) {
+      float* dst = packed.data() + static_cast<size_t>(bs) * packed_hidden_size;
+      dst = std::copy_n(query.data() + static_cast<size_t>(bs) * N * H, N * H, dst);
+      dst = std::copy_n(key.data() + static_cast<size_t>(bs) * N_kv * H, N_kv * H, dst);
+      std::copy_n(value.data() + static_cast<size_t>(bs) * N_kv * H, N_kv * H, dst);
+    }
+    test.AddInput<float>("query", {B, S, packed_hidden_size}, packed);
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  } else {
+    test.AddInput<float>("query", q_dims, query);
+    test.AddInput<float>("key", kv_dims, key);
+    test.AddInput<float>("value", kv_dims, value);
+  }
+  if (P > 0) {
+    test.AddInput<float>("past_key", past_dims, past_key);
+    test.AddInput<float>("past_value", past_dims, past_value);
+  } else {
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddInput<int32_t>("seqlens_k", {B}, c.seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {c.total_sequence_length});
+  if (c.rotary_dim > 0) {
+    test.AddInput<float>("cos_cache", cache_dims, cos_cache);
+    test.AddInput<float>("sin_cache", cache_dims, sin_cache);
+  }
+
+  test.AddOutput<float>("output", q_dims, output);
+  test.AddOutput<float>("present_key", present_dims, present_key);
+  test.AddOutput<float>("present_value", present_dims, present_value);
+  test.SetOutputTolerance(1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+// The CPU kernel rotates the new keys while appending them to the present KV cache. These tests compare it with
+// the unfused computation: rotary embedding on Q and K, KV cache concatenation and attention as separate steps.
+TEST(GroupQueryAttentionTest, RotaryKVAppend_Prompt) {
+  RunGroupQueryAttentionTest({2, 5, 4, 2, 32, 16, 0, 5, {4, 4}, false, false});
+  RunGroupQueryAttentionTest({2, 5, 4, 2, 32, 32, 0, 5, {4, 4}, true, false});
+}
+
+TEST(GroupQueryAttentionTest, RotaryKVAppend_PromptPackedQKV) {
+  RunGroupQueryAttentionTest({2, 3, 4, 1, 16, 16, 0, 3, {2, 2}, false, true});
+  RunGroupQueryAttentionTest({2, 3, 4, 1, 16, 16, 0, 3, {2, 2}, true, true});
+}
+
+TEST(GroupQueryAttentionTest, RotaryKVAppend_TokenGeneration) {
+  // Each batch entry has its own past length, the past buffer is longer than the shorter one.
+  RunGroupQueryAttentionTest({2, 1, 4, 2, 32, 16, 4, 4, {2, 3}, false, false});
+  RunGroupQueryAttentionTest({2, 1, 4, 2, 32, 32, 4, 4, {3, 1}, true, true});
+}
+
+TEST(GroupQueryAttentionTest, KVAppend_NoRotary) {
+  RunGroupQueryAttentionTest({2, 4, 2, 2, 16, 0, 0, 4, {3, 3}, false, false});
+  RunGroupQueryAttentionTest({2, 1, 2, 2, 16, 0, 3, 4, {3, 2}, false, true});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
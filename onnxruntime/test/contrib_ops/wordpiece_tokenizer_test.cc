@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace wordpiece_tokenizer_test {
+constexpr const char* domain = onnxruntime::kMSDomain;
+constexpr int opset_ver = 1;
+
+const std::vector<std::string> vocab{"[PAD]", "[UNK]", "[CLS]", "[SEP]", "hello", "world", "un", "##aff", "##able",
+                                     "!", ",", "a", "##a"};
+}  // namespace wordpiece_tokenizer_test
+
+using namespace wordpiece_tokenizer_test;
+
+TEST(ContribOpTest, WordPieceTokenizer_SpecialTokensAndOffsets) {
+  OpTester test("WordPieceTokenizer", opset_ver, domain);
+  test.AddAttribute("vocab", vocab);
+  test.AddAttribute("cls_token", std::string("[CLS]"));
+  test.AddAttribute("sep_token", std::string("[SEP]"));
+
+  test.AddInput<std::string>("X", {2}, {"Hello, unaffable world!", "unknownword"});
+  test.AddOutput<int64_t>("input_ids", {2, 9},
+                          {2, 4, 10, 6, 7, 8, 5, 9, 3,
+                           2, 1, 3, 0, 0, 0, 0, 0, 0});
+  test.AddOutput<int64_t>("attention_mask", {2, 9},
+                          {1, 1, 1, 1, 1, 1, 1, 1, 1,
+                           1, 1, 1, 0, 0, 0, 0, 0, 0});
+  test.AddOutput<int64_t>("offsets", {2, 9, 2},
+                          {0, 0, 0, 5, 5, 6, 7, 9, 9, 12, 12, 16, 17, 22, 22, 23, 0, 0,
+                           0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, WordPieceTokenizer_MaxLengthCaseSensitive) {
+  OpTester test("WordPieceTokenizer", opset_ver, domain);
+  test.AddAttribute("vocab", vocab);
+  test.AddAttribute("do_lower_case", int64_t{0});
+  test.AddAttribute("max_length", int64_t{3});
+  test.AddAttribute("max_input_chars_per_word", int64_t{3});
+
+  // "Hello" is unknown without lower casing and "aaaa" is longer than max_input_chars_per_word.
+  test.AddInput<std::string>("X", {3}, {"Hello world a b c", "aaa", "aaaa"});
+  test.AddOutput<int64_t>("input_ids", {3, 3},
+                          {1, 5, 11,
+                           11, 12, 12,
+                           1, 0, 0});
+  test.AddOutput<int64_t>("attention_mask", {3, 3},
+                          {1, 1, 1,
+                           1, 1, 1,
+                           1, 0, 0});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, WordPieceTokenizer_EmptyTexts) {
+  OpTester test("WordPieceTokenizer", opset_ver, domain);
+  test.AddAttribute("vocab", vocab);
+
+  test.AddInput<std::string>("X", {2}, {"", " \t "});
+  test.AddOutput<int64_t>("input_ids", {2, 0}, {});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
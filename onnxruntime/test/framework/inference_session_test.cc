@@ -419,6 +419,75 @@ TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   RunModel(session_object, run_options);
 }
 
+// Y = X * X, and a Gather of `data` with `indices` producing Z that is not fetched.
+static void CreateModelWithUnfetchedBranch(std::string& model_data) {
+  onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  ONNX_NAMESPACE::TypeProto indices_tensor;
+  indices_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  indices_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("node_1", "Mul", "node 1.", {&x, &x}, {&y});
+
+  auto& data = graph.GetOrCreateNodeArg("data", &float_tensor);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("node_2", "Gather", "node 2.", {&data, &indices}, {&z});
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+TEST(InferenceSessionTests, OnlyExecutePathToFetchesConcurrentRuns) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.OnlyExecutePathToFetchesConcurrentRuns";
+
+  std::string model_data;
+  CreateModelWithUnfetchedBranch(model_data);
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x;
+  CreateMLValue<float>(allocator, {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+  // the index is out of range, so the runs only succeed if the Gather is skipped.
+  OrtValue indices;
+  CreateMLValue<int64_t>(allocator, {1}, {5}, &indices);
+  NameMLValMap feeds{{"X", x}, {"data", x}, {"indices", indices}};
+  const std::vector<std::string> output_names{"Y"};
+
+  // the nodes to execute are computed by the first of the concurrent runs and shared with the other
+  auto run = [&](const char* run_tag) {
+    RunOptions run_options;
+    run_options.run_tag = run_tag;
+    ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigOnlyExecutePathToFetches, "1"));
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+  };
+
+  std::thread thread1{run, "one session/thread 1"};
+  std::thread thread2{run, "one session/thread 2"};
+
+  thread1.join();
+  thread2.join();
+
+  // without skipping, the Gather fails.
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  ASSERT_FALSE(session_object.Run(run_options, feeds, output_names, &fetches).IsOK());
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -7,9 +7,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/tunable.h"
-#define TUNING_CONTEXT_IMPL
-#include "core/framework/tuning_context_impl.h"
-#undef TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context.h"
 
 using namespace std::chrono_literals;
 
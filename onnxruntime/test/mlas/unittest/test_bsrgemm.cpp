@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasBlockSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, size_t BlockK, bool TransB, float alpha) {
+    float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    //
+    // Zero out roughly three quarters of the BlockK x 16 blocks of matrix B.
+    //
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_int_distribution<int> keep_distribution(0, 3);
+
+    const size_t ldb = TransB ? K : N;
+
+    for (size_t k = 0; k < K; k += BlockK) {
+      for (size_t n = 0; n < N; n += 16) {
+        if (keep_distribution(generator) == 0) {
+          continue;
+        }
+        for (size_t kk = k; kk < std::min(K, k + BlockK); kk++) {
+          for (size_t nn = n; nn < std::min(N, n + 16); nn++) {
+            (TransB ? B[nn * ldb + kk] : B[kk * ldb + nn]) = 0.0f;
+          }
+        }
+      }
+    }
+
+    size_t PackedBSize = MlasBlockSparseGemmPackBSize(TransB ? CblasTrans : CblasNoTrans, N, K, B, ldb, BlockK, 0.0f);
+    ASSERT_GT(PackedBSize, size_t(0)) << "M=" << M << ", N=" << N << ", K=" << K;
+
+    void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+    MlasBlockSparseGemmPackB(TransB ? CblasTrans : CblasNoTrans, N, K, B, ldb, BlockK, PackedB);
+
+    std::fill_n(C, M * N, -0.5f);
+    MlasBlockSparseGemm(M, N, K, alpha, A, K, PackedB, C, N, threadpool_);
+
+    ReferenceGemm(M, N, K, alpha, A, B, ldb, TransB, CReference);
+
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_TRUE(CloseEnough(C[i], CReference[i]))
+          << "@[" << i / N << "," << i % N << "], "
+          << "M=" << M << ", N=" << N << ", K=" << K << ", BlockK=" << BlockK << ", TransB=" << TransB;
+    }
+  }
+
+  void ReferenceGemm(size_t M, size_t N, size_t K, float alpha, const float* A, const float* B, size_t ldb,
+                     bool TransB, float* C) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          sum += double(A[m * K + k]) * double(TransB ? B[n * ldb + k] : B[k * ldb + n]);
+        }
+        C[m * N + n] = float(sum * alpha);
+      }
+    }
+  }
+
+ public:
+  MlasBlockSparseGemmTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("BlockSparseGemm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t BlockK : {1, 4}) {
+      for (bool TransB : {false, true}) {
+        Test(1, 16, 16, BlockK, TransB, 1.0f);
+        Test(5, 33, 19, BlockK, TransB, 1.0f);
+        Test(7, 64, 128, BlockK, TransB, 0.5f);
+        Test(70, 50, 37, BlockK, TransB, 1.0f);
+        Test(129, 96, 65, BlockK, TransB, 2.0f);
+      }
+    }
+  }
+
+  void ExecuteLong(void) override {
+    for (size_t M = 1; M < 80; M += 7) {
+      for (size_t N = 1; N < 100; N += 13) {
+        for (size_t K = 1; K < 100; K += 11) {
+          Test(M, N, K, 1, false, 1.0f);
+          Test(M, N, K, 4, true, 1.0f);
+        }
+      }
+    }
+  }
+};
+
+class MlasBlockSparseGemmPackTest : public MlasTestBase {
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("BlockSparseGemmPack");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    constexpr size_t N = 64;
+    constexpr size_t K = 32;
+    std::vector<float> B(N * K, 1.0f);
+
+    // A dense matrix is rejected by any non-zero sparsity threshold.
+    EXPECT_EQ(MlasBlockSparseGemmPackBSize(CblasNoTrans, N, K, B.data(), N, 1, 0.5f), size_t(0));
+
+    // Keep only the first block of each 16 column panel: 31 of 32 blocks are zero.
+    std::fill(B.begin() + N, B.end(), 0.0f);
+    EXPECT_GT(MlasBlockSparseGemmPackBSize(CblasNoTrans, N, K, B.data(), N, 1, 0.9f), size_t(0));
+    EXPECT_EQ(MlasBlockSparseGemmPackBSize(CblasNoTrans, N, K, B.data(), N, 1, 0.99f), size_t(0));
+
+    // Unsupported block shapes.
+    EXPECT_EQ(MlasBlockSparseGemmPackBSize(CblasNoTrans, N, K, B.data(), N, 0, 0.0f), size_t(0));
+    EXPECT_EQ(MlasBlockSparseGemmPackBSize(CblasNoTrans, N, K, B.data(), N, K + 1, 0.0f), size_t(0));
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasBlockSparseGemmTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasBlockSparseGemmPackTest>::RegisterShortExecute();
+  } else {
+    count += MlasLongExecuteTests<MlasBlockSparseGemmTest>::RegisterLongExecute();
+  }
+  return count;
+});
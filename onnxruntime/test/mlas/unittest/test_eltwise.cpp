@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasEltwiseTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInputA;
+  MatrixGuardBuffer<float> BufferInputB;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static float ReferenceEltwise(MLAS_ELTWISE_KIND EltwiseKind, float a, float b) {
+    switch (EltwiseKind) {
+      case MlasEltwiseAdd:
+        return a + b;
+      case MlasEltwiseSub:
+        return a - b;
+      case MlasEltwiseMul:
+        return a * b;
+      case MlasEltwiseDiv:
+        return a / b;
+      case MlasEltwiseMaximum:
+        return std::max(a, b);
+      case MlasEltwiseMinimum:
+        return std::min(a, b);
+    }
+    return 0.0f;
+  }
+
+  void Test(MLAS_ELTWISE_KIND EltwiseKind, size_t N, bool BroadcastA, bool BroadcastB) {
+    float* InputA = BufferInputA.GetBuffer(BroadcastA ? 1 : N);
+    float* InputB = BufferInputB.GetBuffer(BroadcastB ? 1 : N);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(0.5f, 10.0f);
+    for (size_t n = 0; n < (BroadcastA ? 1 : N); n++) {
+      InputA[n] = distribution(generator);
+    }
+    for (size_t n = 0; n < (BroadcastB ? 1 : N); n++) {
+      InputB[n] = -distribution(generator);
+    }
+
+    MlasEltwiseF32(EltwiseKind, InputA, BroadcastA, InputB, BroadcastB, Output, N);
+
+    for (size_t n = 0; n < N; n++) {
+      float Reference = ReferenceEltwise(EltwiseKind, InputA[BroadcastA ? 0 : n], InputB[BroadcastB ? 0 : n]);
+      ASSERT_NEAR(Output[n], Reference, std::abs(Reference) * 1e-6f)
+          << "EltwiseKind=" << EltwiseKind << ", N=" << N << ", BroadcastA=" << BroadcastA
+          << ", BroadcastB=" << BroadcastB << ", n=" << n;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Eltwise");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (MLAS_ELTWISE_KIND EltwiseKind : {MlasEltwiseAdd, MlasEltwiseSub, MlasEltwiseMul, MlasEltwiseDiv,
+                                          MlasEltwiseMaximum, MlasEltwiseMinimum}) {
+      for (size_t n = 1; n < 40; n++) {
+        Test(EltwiseKind, n, false, false);
+        Test(EltwiseKind, n, true, false);
+        Test(EltwiseKind, n, false, true);
+      }
+      Test(EltwiseKind, 1000, false, false);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasEltwiseTest>::RegisterShortExecute() : 0;
+});
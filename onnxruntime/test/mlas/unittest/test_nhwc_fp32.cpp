@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests for the fp32 channels last routines driven by an indirection buffer.
+// The indirection buffer points at rows of a random input pool, with every
+// fifth entry pointing at the padding row.
+//
+
+class MlasNhwcFp32TestBase : public MlasTestBase {
+ protected:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferPadding;
+  MatrixGuardBuffer<float> BufferOutput;
+  std::vector<const float*> Indirection;
+
+  static constexpr size_t InputRows = 7;
+
+  float* PrepareInput(size_t Channels, size_t OutputCount, size_t KernelSize, bool NullPadding) {
+    float* Input = BufferInput.GetBuffer(InputRows * Channels);
+    float* Padding = BufferPadding.GetBuffer(Channels);
+
+    std::default_random_engine generator(static_cast<unsigned>(Channels * 131 + KernelSize));
+    std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+    for (size_t i = 0; i < InputRows * Channels; i++) {
+      Input[i] = distribution(generator);
+    }
+    std::fill_n(Padding, Channels, 0.0f);
+
+    Indirection.resize(OutputCount * KernelSize);
+    for (size_t i = 0; i < Indirection.size(); i++) {
+      if (i % 5 == 4) {
+        Indirection[i] = NullPadding ? nullptr : Padding;
+      } else {
+        Indirection[i] = Input + ((i * 3) % InputRows) * Channels;
+      }
+    }
+
+    return BufferOutput.GetBuffer(OutputCount * Channels);
+  }
+};
+
+class MlasNhwcDepthwiseConvFp32Test : public MlasNhwcFp32TestBase {
+ private:
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferBias;
+
+  void Test(size_t Channels, size_t OutputCount, size_t KernelSize, bool UseBias) {
+    float* Output = PrepareInput(Channels, OutputCount, KernelSize, false);
+    float* Filter = BufferFilter.GetBuffer(KernelSize * Channels);
+    float* Bias = BufferBias.GetBuffer(Channels);
+
+    std::default_random_engine generator(static_cast<unsigned>(OutputCount));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < KernelSize * Channels; i++) {
+      Filter[i] = distribution(generator);
+    }
+    for (size_t c = 0; c < Channels; c++) {
+      Bias[c] = distribution(generator);
+    }
+
+    MlasConvDepthwise(Indirection.data(), Filter, UseBias ? Bias : nullptr, Output, Channels, OutputCount, KernelSize);
+
+    for (size_t o = 0; o < OutputCount; o++) {
+      for (size_t c = 0; c < Channels; c++) {
+        float Reference = UseBias ? Bias[c] : 0.0f;
+        for (size_t k = 0; k < KernelSize; k++) {
+          Reference += Indirection[o * KernelSize + k][c] * Filter[k * Channels + c];
+        }
+        ASSERT_NEAR(Output[o * Channels + c], Reference, 1e-4f)
+            << "Channels=" << Channels << ", OutputCount=" << OutputCount << ", KernelSize=" << KernelSize
+            << ", o=" << o << ", c=" << c;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("NhwcDepthwiseConvFp32");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t c = 1; c < 20; c++) {
+      Test(c, 3, 9, false);
+      Test(c, 3, 9, true);
+    }
+    Test(64, 17, 25, true);
+    Test(37, 11, 1, true);
+  }
+};
+
+class MlasNhwcPoolFp32Test : public MlasNhwcFp32TestBase {
+ private:
+  void Test(MLAS_POOLING_KIND PoolingKind, size_t Channels, size_t OutputCount, size_t KernelSize) {
+    const bool IsMaximumPooling = (PoolingKind == MlasMaximumPooling);
+    const bool NullPadding = (PoolingKind != MlasAveragePoolingIncludePad);
+    float* Output = PrepareInput(Channels, OutputCount, KernelSize, NullPadding);
+
+    if (IsMaximumPooling) {
+      MlasNhwcMaxPool(Indirection.data(), Output, Channels, OutputCount, KernelSize);
+    } else {
+      MlasNhwcAvgPool(Indirection.data(), Output, Channels, OutputCount, KernelSize);
+    }
+
+    for (size_t o = 0; o < OutputCount; o++) {
+      for (size_t c = 0; c < Channels; c++) {
+        float Reference = IsMaximumPooling ? std::numeric_limits<float>::lowest() : 0.0f;
+        size_t Count = 0;
+        for (size_t k = 0; k < KernelSize; k++) {
+          const float* Row = Indirection[o * KernelSize + k];
+          if (Row == nullptr) {
+            continue;
+          }
+          Reference = IsMaximumPooling ? std::max(Reference, Row[c]) : Reference + Row[c];
+          Count++;
+        }
+        if (!IsMaximumPooling) {
+          Reference /= float(Count);
+        }
+        ASSERT_NEAR(Output[o * Channels + c], Reference, 1e-5f)
+            << "PoolingKind=" << PoolingKind << ", Channels=" << Channels << ", OutputCount=" << OutputCount
+            << ", KernelSize=" << KernelSize << ", o=" << o << ", c=" << c;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("NhwcPoolFp32");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (MLAS_POOLING_KIND PoolingKind :
+         {MlasMaximumPooling, MlasAveragePoolingExcludePad, MlasAveragePoolingIncludePad}) {
+      for (size_t c = 1; c < 20; c++) {
+        Test(PoolingKind, c, 3, 9);
+      }
+      Test(PoolingKind, 64, 17, 25);
+      Test(PoolingKind, 35, 5, 4);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasNhwcDepthwiseConvFp32Test>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasNhwcPoolFp32Test>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static double ReferenceReduce(MLAS_REDUCE_KIND ReduceKind, const float* Input, size_t N, size_t Stride) {
+    double Value = ReduceKind == MlasReduceMaximum   ? -std::numeric_limits<double>::infinity()
+                   : ReduceKind == MlasReduceMinimum ? std::numeric_limits<double>::infinity()
+                                                     : 0.0;
+    for (size_t n = 0; n < N; n++) {
+      double v = Input[n * Stride];
+      switch (ReduceKind) {
+        case MlasReduceSum:
+          Value += v;
+          break;
+        case MlasReduceSumSquare:
+          Value += v * v;
+          break;
+        case MlasReduceMaximum:
+          Value = std::max(Value, v);
+          break;
+        case MlasReduceMinimum:
+          Value = std::min(Value, v);
+          break;
+      }
+    }
+    return Value;
+  }
+
+  void FillInput(float* Input, size_t N) {
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+    }
+  }
+
+  void Test(MLAS_REDUCE_KIND ReduceKind, size_t N) {
+    float* Input = BufferInput.GetBuffer(N);
+    FillInput(Input, N);
+
+    float Value = MlasReduceF32(ReduceKind, Input, N);
+    double Reference = ReferenceReduce(ReduceKind, Input, N, 1);
+
+    ASSERT_NEAR(Value, Reference, std::abs(Reference) * 1e-5 + 1e-4) << "ReduceKind=" << ReduceKind << ", N=" << N;
+  }
+
+  void TestColumns(MLAS_REDUCE_KIND ReduceKind, size_t Rows, size_t Columns, size_t ldInput) {
+    float* Input = BufferInput.GetBuffer(Rows * ldInput);
+    float* Output = BufferOutput.GetBuffer(Columns);
+    FillInput(Input, Rows * ldInput);
+
+    MlasReduceColumnsF32(ReduceKind, Input, Rows, Columns, ldInput, Output);
+
+    for (size_t c = 0; c < Columns; c++) {
+      double Reference = ReferenceReduce(ReduceKind, Input + c, Rows, ldInput);
+      ASSERT_NEAR(Output[c], Reference, std::abs(Reference) * 1e-5 + 1e-4)
+          << "ReduceKind=" << ReduceKind << ", Rows=" << Rows << ", Columns=" << Columns << ", c=" << c;
+    }
+  }
+
+  void TestLogSumExp(size_t N) {
+    float* Input = BufferInput.GetBuffer(N);
+    FillInput(Input, N);
+
+    double Maximum = ReferenceReduce(MlasReduceMaximum, Input, N, 1);
+    double Sum = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      Sum += std::exp(Input[n] - Maximum);
+    }
+    double Reference = std::log(Sum) + Maximum;
+
+    ASSERT_NEAR(MlasReduceLogSumExpF32(Input, N), Reference, std::abs(Reference) * 1e-5 + 1e-5) << "N=" << N;
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (MLAS_REDUCE_KIND ReduceKind : {MlasReduceSum, MlasReduceSumSquare, MlasReduceMaximum, MlasReduceMinimum}) {
+      for (size_t n = 1; n < 80; n++) {
+        Test(ReduceKind, n);
+      }
+      Test(ReduceKind, 1000);
+
+      for (size_t Rows : {1, 2, 7, 64}) {
+        for (size_t Columns : {1, 3, 4, 15, 16, 37, 100}) {
+          TestColumns(ReduceKind, Rows, Columns, Columns);
+          TestColumns(ReduceKind, Rows, Columns, Columns + 5);
+        }
+      }
+    }
+
+    for (size_t n = 1; n < 80; n++) {
+      TestLogSumExp(n);
+    }
+    TestLogSumExp(1000);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute() : 0;
+});
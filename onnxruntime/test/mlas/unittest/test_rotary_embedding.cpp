@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+template <typename T>
+class MlasRotaryEmbeddingTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<T> BufferInput;
+  MatrixGuardBuffer<T> BufferSin;
+  MatrixGuardBuffer<T> BufferCos;
+  MatrixGuardBuffer<T> BufferOutput;
+
+  static float ToFloat(float v) { return v; }
+  static float ToFloat(MLFp16 v) { return v.ToFloat(); }
+
+  void Test(size_t Dim, bool Interleaved, bool InPlace) {
+    const size_t HalfDim = Dim / 2;
+    T* Input = BufferInput.GetBuffer(Dim);
+    T* Sin = BufferSin.GetBuffer(HalfDim);
+    T* Cos = BufferCos.GetBuffer(HalfDim);
+    T* Output = InPlace ? Input : BufferOutput.GetBuffer(Dim);
+
+    std::default_random_engine generator(static_cast<unsigned>(Dim));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+    std::vector<float> InputReference(Dim);
+    for (size_t i = 0; i < Dim; i++) {
+      Input[i] = T(distribution(generator));
+      InputReference[i] = ToFloat(Input[i]);
+    }
+    for (size_t i = 0; i < HalfDim; i++) {
+      const float Theta = distribution(generator);
+      Sin[i] = T(std::sin(Theta));
+      Cos[i] = T(std::cos(Theta));
+    }
+
+    if constexpr (std::is_same_v<T, float>) {
+      MlasRotaryEmbedOneRow<float>(Input, Sin, Cos, Dim, Interleaved, Output);
+    } else {
+      MlasRotaryEmbedOneRow<MLAS_FP16>(reinterpret_cast<const MLAS_FP16*>(Input),
+                                       reinterpret_cast<const MLAS_FP16*>(Sin),
+                                       reinterpret_cast<const MLAS_FP16*>(Cos), Dim, Interleaved,
+                                       reinterpret_cast<MLAS_FP16*>(Output));
+    }
+
+    const float Tolerance = std::is_same_v<T, float> ? 1e-5f : 4e-3f;
+    for (size_t i = 0; i < HalfDim; i++) {
+      const size_t x = Interleaved ? 2 * i : i;
+      const size_t y = Interleaved ? 2 * i + 1 : i + HalfDim;
+      const float c = ToFloat(Cos[i]);
+      const float s = ToFloat(Sin[i]);
+      const float ExpectedX = InputReference[x] * c - InputReference[y] * s;
+      const float ExpectedY = InputReference[y] * c + InputReference[x] * s;
+
+      ASSERT_NEAR(ToFloat(Output[x]), ExpectedX, Tolerance)
+          << "Dim=" << Dim << ", Interleaved=" << Interleaved << ", i=" << i;
+      ASSERT_NEAR(ToFloat(Output[y]), ExpectedY, Tolerance)
+          << "Dim=" << Dim << ", Interleaved=" << Interleaved << ", i=" << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::is_same_v<T, float> ? "RotaryEmbedding_fp32" : "RotaryEmbedding_fp16");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool Interleaved : {false, true}) {
+      for (size_t Dim = 2; Dim <= 160; Dim += 2) {
+        Test(Dim, Interleaved, false);
+      }
+      Test(256, Interleaved, true);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasRotaryEmbeddingTest<float>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasRotaryEmbeddingTest<MLFp16>>::RegisterShortExecute();
+  }
+  return count;
+});
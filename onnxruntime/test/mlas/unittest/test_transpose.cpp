@@ -22,10 +22,28 @@ class MlasTransposeTest : public MlasTestBase {
     ASSERT_EQ(memcmp(Output, OutputReference, M * N * sizeof(ElementType)), 0) << " [" << M << "," << N << "]";
   }
 
+  void
+  TestStrided(size_t M, size_t N, size_t ldInput, size_t ldOutput) {
+    ElementType* Input = BufferInput.GetBuffer(M * ldInput);
+    ElementType* Output = BufferOutput.GetBuffer(N * ldOutput, true);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(N * ldOutput, true);
+
+    MlasTranspose(Input, ldInput, Output, ldOutput, M, N);
+    ReferenceTranspose(Input, ldInput, OutputReference, ldOutput, M, N);
+
+    ASSERT_EQ(memcmp(Output, OutputReference, N * ldOutput * sizeof(ElementType)), 0)
+        << " [" << M << "," << N << "] ld [" << ldInput << "," << ldOutput << "]";
+  }
+
   void ReferenceTranspose(const ElementType* Input, ElementType* Output, size_t M, size_t N) {
+    ReferenceTranspose(Input, N, Output, M, M, N);
+  }
+
+  void ReferenceTranspose(const ElementType* Input, size_t ldInput, ElementType* Output, size_t ldOutput,
+                          size_t M, size_t N) {
     for (size_t m = 0; m < M; m++) {
       for (size_t n = 0; n < N; n++) {
-        Output[n * M + m] = Input[m * N + n];
+        Output[n * ldOutput + m] = Input[m * ldInput + n];
       }
     }
   }
@@ -40,6 +58,7 @@ class MlasTransposeTest : public MlasTestBase {
     for (size_t m = 1; m <= 32; m++) {
       for (size_t n = 1; n <= 32; n++) {
         Test(m, n);
+        TestStrided(m, n, n + 3, m + 5);
       }
     }
   }
@@ -48,6 +67,7 @@ class MlasTransposeTest : public MlasTestBase {
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasTransposeTest<uint64_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint32_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint8_t>>::RegisterShortExecute();
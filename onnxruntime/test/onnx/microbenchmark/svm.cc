@@ -0,0 +1,124 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <core/util/thread_utils.h>
+#include <mlas.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace onnxruntime;
+using namespace onnxruntime::concurrency;
+
+// RBF kernels of an SVM, exp(-gamma * |x - sv|^2) for every batch and support vector.
+// Arguments are the number of batches, support vectors and features.
+
+static constexpr float kGamma = 0.01f;
+
+// distance loop previously used by SVMClassifier and SVMRegressor
+static void BM_SvmRbfKernelDirect(benchmark::State& state) {
+  const size_t batches = static_cast<size_t>(state.range(0));
+  const size_t vectors = static_cast<size_t>(state.range(1));
+  const size_t features = static_cast<size_t>(state.range(2));
+  float* x = GenerateArrayWithRandomValue<float>(batches * features, -1, 1);
+  float* support_vectors = GenerateArrayWithRandomValue<float>(vectors * features, -1, 1);
+  float* output = (float*)aligned_alloc(sizeof(float) * batches * vectors, 64);
+
+  for (auto _ : state) {
+    float* cur_out = output;
+    for (size_t batch = 0; batch < batches; ++batch) {
+      const float* cur_support_vector = support_vectors;
+      for (size_t support_vector = 0; support_vector < vectors; ++support_vector) {
+        float sum = 0.f;
+        const float* cur_input = x + batch * features;
+        for (size_t feature = 0; feature < features; ++feature) {
+          float val = *cur_input++ - *cur_support_vector++;
+          sum += val * val;
+        }
+        *cur_out++ = std::exp(-kGamma * sum);
+      }
+    }
+    benchmark::DoNotOptimize(output);
+  }
+
+  aligned_free(x);
+  aligned_free(support_vectors);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_SvmRbfKernelDirect)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 20000, 64})
+    ->Args({64, 2000, 64})
+    ->Args({256, 20000, 64})
+    ->Args({1024, 2000, 256});
+
+// |x|^2 + |sv|^2 - 2 * x.sv with an SGEMM, followed by MlasComputeExp, as SVMClassifier and SVMRegressor do
+static void BM_SvmRbfKernelGemm(benchmark::State& state) {
+  const size_t batches = static_cast<size_t>(state.range(0));
+  const size_t vectors = static_cast<size_t>(state.range(1));
+  const size_t features = static_cast<size_t>(state.range(2));
+  const bool use_thread_pool = state.range(3) != 0;
+  float* x = GenerateArrayWithRandomValue<float>(batches * features, -1, 1);
+  float* support_vectors = GenerateArrayWithRandomValue<float>(vectors * features, -1, 1);
+  float* output = (float*)aligned_alloc(sizeof(float) * batches * vectors, 64);
+
+  std::unique_ptr<ThreadPool> tp;
+  if (use_thread_pool) {
+    OrtThreadPoolParams tpo;
+    tpo.auto_set_affinity = true;
+    tp = CreateThreadPool(&onnxruntime::Env::Default(), tpo, ThreadPoolType::INTRA_OP);
+  }
+
+  std::vector<float> support_vector_norms(vectors, 0.f);
+  for (size_t support_vector = 0; support_vector < vectors; ++support_vector) {
+    for (size_t feature = 0; feature < features; ++feature) {
+      const float val = support_vectors[support_vector * features + feature];
+      support_vector_norms[support_vector] += val * val;
+    }
+  }
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, CblasTrans, batches, vectors, features, -2.f, x, features, support_vectors, features, 0.f,
+             output, vectors, tp.get());
+    ThreadPool::TryParallelFor(
+        tp.get(), static_cast<std::ptrdiff_t>(batches),
+        TensorOpCost{static_cast<double>(features + vectors) * sizeof(float),
+                     static_cast<double>(vectors) * sizeof(float), static_cast<double>(features + 8 * vectors)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t batch = first; batch < last; ++batch) {
+            const float* cur_input = x + batch * features;
+            float x_norm = 0.f;
+            for (size_t feature = 0; feature < features; ++feature) {
+              x_norm += cur_input[feature] * cur_input[feature];
+            }
+            float* cur_out = output + batch * vectors;
+            for (size_t support_vector = 0; support_vector < vectors; ++support_vector) {
+              cur_out[support_vector] =
+                  -kGamma * std::max(cur_out[support_vector] + x_norm + support_vector_norms[support_vector], 0.f);
+            }
+            MlasComputeExp(cur_out, cur_out, vectors);
+          }
+        });
+    benchmark::DoNotOptimize(output);
+  }
+
+  aligned_free(x);
+  aligned_free(support_vectors);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_SvmRbfKernelGemm)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 20000, 64, 0})
+    ->Args({64, 2000, 64, 0})
+    ->Args({256, 20000, 64, 0})
+    ->Args({1024, 2000, 256, 0})
+    ->Args({1, 20000, 64, 1})
+    ->Args({64, 2000, 64, 1})
+    ->Args({256, 20000, 64, 1})
+    ->Args({1024, 2000, 256, 1});
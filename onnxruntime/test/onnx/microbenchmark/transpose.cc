@@ -0,0 +1,99 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/transpose.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+
+// 4-D and 5-D layout conversions: NCHW->NHWC, NHWC->NCHW, NCDHW->NDHWC, and a full 5-D permutation.
+static const std::vector<int64_t> kTransposeShapes[] = {{8, 64, 56, 56}, {8, 56, 56, 64}, {2, 32, 16, 28, 28},
+                                                        {2, 16, 32, 24, 40}};
+static const std::vector<size_t> kTransposePerms[] = {{0, 2, 3, 1}, {0, 3, 1, 2}, {0, 2, 3, 4, 1}, {4, 2, 0, 3, 1}};
+
+static void SetupTransposeArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t i = 0; i < static_cast<int64_t>(std::size(kTransposePerms)); ++i) {
+    b->Arg(i);
+  }
+}
+
+static TensorShape TransposedShape(const std::vector<int64_t>& shape, const std::vector<size_t>& perm) {
+  TensorShapeVector dims(shape.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    dims[i] = shape[perm[i]];
+  }
+  return TensorShape(dims);
+}
+
+// per-element stride walk used for generic permutations before the blocked engine
+static void BM_Transpose_EltWise(benchmark::State& state) {
+  const auto& shape = kTransposeShapes[state.range(0)];
+  const auto& perm = kTransposePerms[state.range(0)];
+  const TensorShape input_shape(shape);
+  const TensorShape output_shape = TransposedShape(shape, perm);
+  const size_t size = static_cast<size_t>(input_shape.Size());
+
+  std::vector<size_t> stride(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    stride[i] = static_cast<size_t>(input_shape.SizeFromDimension(perm[i] + 1));
+  }
+
+  float* input = GenerateArrayWithRandomValue<float>(size, -1, 1);
+  float* output = (float*)aligned_alloc(sizeof(float) * size, 64);
+
+  for (auto _ : state) {
+    ORT_THROW_IF_ERROR(DoTransposeEltWise(static_cast<int64_t>(perm.size()), output_shape.GetDims(), size, stride,
+                                          reinterpret_cast<const uint8_t*>(input),
+                                          reinterpret_cast<uint8_t*>(output), sizeof(float)));
+  }
+
+  aligned_free(input);
+  aligned_free(output);
+}
+
+static void RunBlockedTranspose(benchmark::State& state, concurrency::ThreadPool* tp) {
+  const auto& shape = kTransposeShapes[state.range(0)];
+  const auto& perm = kTransposePerms[state.range(0)];
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  Tensor input(DataTypeImpl::GetType<float>(), TensorShape(shape), allocator);
+  Tensor output(DataTypeImpl::GetType<float>(), TransposedShape(shape, perm), allocator);
+  float* input_data = input.MutableData<float>();
+  for (int64_t i = 0; i < input.Shape().Size(); ++i) {
+    input_data[i] = static_cast<float>(i % 251);
+  }
+
+  for (auto _ : state) {
+    ORT_THROW_IF_ERROR(TransposeBase::DoTranspose(perm, input, output, nullptr, tp));
+  }
+}
+
+static void BM_Transpose_Blocked_SingleThread(benchmark::State& state) {
+  RunBlockedTranspose(state, nullptr);
+}
+
+static void BM_Transpose_Blocked_Parallel(benchmark::State& state) {
+  OrtThreadPoolParams tpo;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<concurrency::ThreadPool> tp(
+      concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP));
+  RunBlockedTranspose(state, tp.get());
+}
+
+BENCHMARK(BM_Transpose_EltWise)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(SetupTransposeArgs);
+
+BENCHMARK(BM_Transpose_Blocked_SingleThread)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(SetupTransposeArgs);
+
+BENCHMARK(BM_Transpose_Blocked_Parallel)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(SetupTransposeArgs);
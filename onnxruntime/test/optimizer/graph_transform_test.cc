@@ -38,6 +38,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gather_fusion.h"
@@ -50,16 +51,21 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
 #include "core/optimizer/label_encoder_fusion.h"
+#include "core/optimizer/loop_invariant_code_motion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/ml_preprocessing_fusion.h"
+#include "core/optimizer/mixed_precision_transformer.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
 #include "core/optimizer/pad_fusion.h"
@@ -69,8 +75,10 @@
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_folding.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/platform/env.h"
@@ -733,6 +741,324 @@ TEST_F(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotion) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  TypeProto int64_scalar_type;
+  int64_scalar_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar_type.mutable_tensor_type()->mutable_shape();
+
+  TypeProto bool_scalar_type;
+  bool_scalar_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar_type.mutable_tensor_type()->mutable_shape();
+
+  auto create_body = [&](GraphProto& graph_proto) {
+    // v_out = v_in + Neg(x) * scale, where only the Add depends on the loop carried value
+    Model model("LoopInvariantCodeMotionTest_body", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    TensorProto scale;
+    scale.set_name("scale");
+    scale.add_dims(2);
+    scale.add_float_data(2.f);
+    scale.add_float_data(3.f);
+    scale.set_data_type(TensorProto_DataType_FLOAT);
+    graph.AddInitializedTensor(scale);
+
+    auto& iter_num = graph.GetOrCreateNodeArg("iter_num", &int64_scalar_type);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar_type);
+    auto& v_in = graph.GetOrCreateNodeArg("v_in", &float_tensor_type);
+    auto& x = graph.GetOrCreateNodeArg("x", &float_tensor_type);
+    graph.AddOuterScopeNodeArg("x");
+    auto& scale_arg = graph.GetOrCreateNodeArg("scale", &float_tensor_type);
+
+    auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &float_tensor_type);
+    graph.AddNode("neg", "Neg", "Invariant.", {&x}, {&neg_out});
+
+    auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &float_tensor_type);
+    graph.AddNode("mul", "Mul", "Invariant.", {&neg_out, &scale_arg}, {&mul_out});
+
+    auto& v_out = graph.GetOrCreateNodeArg("v_out", &float_tensor_type);
+    graph.AddNode("add", "Add", "Uses the loop carried value.", {&v_in, &mul_out}, {&v_out});
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar_type);
+    graph.AddNode("identity", "Identity", "Loop condition.", {&cond_in}, {&cond_out});
+
+    graph.SetInputs({&iter_num, &cond_in, &v_in});
+    graph.SetOutputs({&cond_out, &v_out});
+
+    ASSERT_STATUS_OK(graph.Resolve());
+    graph_proto = graph.ToGraphProto();
+  };
+
+  Model model("LoopInvariantCodeMotionTest_main_graph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& trip_count = graph.GetOrCreateNodeArg("trip_count", &int64_scalar_type);
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_scalar_type);
+  auto& v_initial = graph.GetOrCreateNodeArg("v_initial", &float_tensor_type);
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor_type);
+  auto& v_final = graph.GetOrCreateNodeArg("v_final", &float_tensor_type);
+
+  auto& loop_node = graph.AddNode("loop", "Loop", "Loop node", {&trip_count, &cond, &v_initial}, {&v_final});
+
+  GraphProto body;
+  create_body(body);
+  loop_node.AddAttribute("body", body);
+
+  graph.SetInputs({&trip_count, &cond, &v_initial, &x});
+  graph.SetOutputs({&v_final});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto count_main_graph_ops = [&graph]() {
+    std::map<std::string, int> op_to_count;
+    for (const auto& node : graph.Nodes()) {
+      ++op_to_count[node.OpType()];
+    }
+    return op_to_count;
+  };
+
+  std::map<std::string, int> op_to_count = count_main_graph_ops();
+  ASSERT_EQ(op_to_count["Neg"], 0);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<LoopInvariantCodeMotion>(),
+                                                     TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // Neg and Mul are computed once before the loop, the Add and the Identity stay in the body.
+  op_to_count = count_main_graph_ops();
+  EXPECT_EQ(op_to_count["Neg"], 1);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+  EXPECT_EQ(op_to_count["Loop"], 1);
+  EXPECT_NE(graph.GetConstantInitializer("scale", false), nullptr);
+
+  op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Neg"], 1);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["Identity"], 1);
+
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Loop") {
+      const auto& implicit_inputs = node.ImplicitInputDefs();
+      ASSERT_EQ(implicit_inputs.size(), 1u);
+      EXPECT_EQ(implicit_inputs[0]->Name(), "mul_out");
+    }
+  }
+}
+
+// Builds a Loop body computing v_out = (v_in + scale) + Gather(Neg(data), indices) * scale, where data and indices are
+// outer scope values and scale is a body initializer.
+static void BuildLoopInvariantCodeMotionLoopBody(const std::string& data_name, const std::string& indices_name,
+                                                 const logging::Logger& logger, GraphProto& graph_proto) {
+  auto make_type = [](TensorProto_DataType elem_type, std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    type.mutable_tensor_type()->mutable_shape();
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  const TypeProto int64_scalar_type = make_type(TensorProto_DataType_INT64, {});
+  const TypeProto bool_scalar_type = make_type(TensorProto_DataType_BOOL, {});
+  const TypeProto data_type = make_type(TensorProto_DataType_FLOAT, {3});
+  const TypeProto indices_type = make_type(TensorProto_DataType_INT64, {1});
+  const TypeProto value_type = make_type(TensorProto_DataType_FLOAT, {1});
+
+  Model model("LoopInvariantCodeMotionTest_body", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, logger);
+  auto& graph = model.MainGraph();
+
+  TensorProto scale;
+  scale.set_name("scale");
+  scale.add_dims(1);
+  scale.add_float_data(2.f);
+  scale.set_data_type(TensorProto_DataType_FLOAT);
+  graph.AddInitializedTensor(scale);
+
+  auto& iter_num = graph.GetOrCreateNodeArg("iter_num", &int64_scalar_type);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar_type);
+  auto& v_in = graph.GetOrCreateNodeArg("v_in", &value_type);
+  auto& data = graph.GetOrCreateNodeArg(data_name, &data_type);
+  auto& indices = graph.GetOrCreateNodeArg(indices_name, &indices_type);
+  graph.AddOuterScopeNodeArg(data_name);
+  graph.AddOuterScopeNodeArg(indices_name);
+  auto& scale_arg = graph.GetOrCreateNodeArg("scale", &value_type);
+
+  auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &data_type);
+  graph.AddNode("neg", "Neg", "Invariant, cannot fail.", {&data}, {&neg_out});
+  auto& gather_out = graph.GetOrCreateNodeArg("gather_out", &value_type);
+  graph.AddNode("gather", "Gather", "Invariant, fails on an out of range index.", {&neg_out, &indices},
+                {&gather_out});
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &value_type);
+  graph.AddNode("mul", "Mul", "Invariant.", {&gather_out, &scale_arg}, {&mul_out});
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &value_type);
+  graph.AddNode("add", "Add", "Uses the loop carried value and the initializer.", {&v_in, &scale_arg}, {&add_out});
+  auto& v_out = graph.GetOrCreateNodeArg("v_out", &value_type);
+  graph.AddNode("add_2", "Add", "Uses the loop carried value.", {&add_out, &mul_out}, {&v_out});
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar_type);
+  graph.AddNode("identity", "Identity", "Loop condition.", {&cond_in}, {&cond_out});
+
+  graph.SetInputs({&iter_num, &cond_in, &v_in});
+  graph.SetOutputs({&cond_out, &v_out});
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  graph_proto = graph.ToGraphProto();
+}
+
+static const Graph& GetLoopInvariantCodeMotionBody(const Graph& graph, const std::string& op_type) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == op_type) {
+      return *node.GetAttributeNameToSubgraphMap().at("body");
+    }
+  }
+  ORT_THROW("No ", op_type, " node in the graph.");
+}
+
+// A Loop whose trip count is not known might not run at all. The Gather would fail with the out of range index, so
+// it must stay in the body, while the Neg that cannot fail is moved out.
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotion_ZeroTripLoop) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* trip_count = builder.MakeInput<int64_t>({}, {0});
+    auto* cond = builder.MakeInitializerBool({}, {true});
+    auto* v_initial = builder.MakeInput<float>({1}, {1.f});
+    auto* data = builder.MakeInput<float>({3}, {1.f, 2.f, 3.f});
+    auto* indices = builder.MakeInput<int64_t>({1}, {5});
+    auto* v_final = builder.MakeOutput();
+
+    GraphProto body;
+    BuildLoopInvariantCodeMotionLoopBody(data->Name(), indices->Name(), *logger_, body);
+    Node& loop_node = builder.AddNode("Loop", {trip_count, cond, v_initial}, {v_final});
+    loop_node.AddAttribute("body", body);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph, /*recurse_into_subgraphs*/ false);
+    EXPECT_EQ(op_to_count["Neg"], 1);
+    EXPECT_EQ(op_to_count["Gather"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+
+    const Graph& body = GetLoopInvariantCodeMotionBody(graph, "Loop");
+    EXPECT_EQ(body.GetAllInitializedTensors().count("scale"), 1u);
+    EXPECT_EQ(graph.GetAllInitializedTensors().count("scale"), 0u);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level1, 12);
+}
+
+// With a constant trip count the body runs, so the Gather is moved too. The initializer used by a moved node and by
+// a node left in the body is moved to the outer graph, not copied.
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotion_ConstantTripCount) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* trip_count = builder.MakeScalarInitializer<int64_t>(3);
+    auto* cond = builder.MakeInitializerBool({}, {true});
+    auto* v_initial = builder.MakeInput<float>({1}, {1.f});
+    auto* data = builder.MakeInput<float>({3}, {1.f, 2.f, 3.f});
+    auto* indices = builder.MakeInput<int64_t>({1}, {1});
+    auto* v_final = builder.MakeOutput();
+
+    GraphProto body;
+    BuildLoopInvariantCodeMotionLoopBody(data->Name(), indices->Name(), *logger_, body);
+    Node& loop_node = builder.AddNode("Loop", {trip_count, cond, v_initial}, {v_final});
+    loop_node.AddAttribute("body", body);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    const Graph& graph = session.GetGraph();
+    auto op_to_count = CountOpsInGraph(graph, /*recurse_into_subgraphs*/ false);
+    EXPECT_EQ(op_to_count["Neg"], 1);
+    EXPECT_EQ(op_to_count["Gather"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 1);
+
+    const Graph& body = GetLoopInvariantCodeMotionBody(graph, "Loop");
+    EXPECT_EQ(body.GetAllInitializedTensors().count("scale"), 0u);
+    EXPECT_EQ(graph.GetAllInitializedTensors().count("scale"), 1u);
+    op_to_count = CountOpsInGraph(body, /*recurse_into_subgraphs*/ false);
+    EXPECT_EQ(op_to_count["Add"], 2);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level1, 12);
+}
+
+// Scan runs once per slice of its scan input. The Gather is only moved out when the scan axis is known to be
+// non-empty, with an empty scan input the out of range index must not be evaluated.
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotion_Scan) {
+  auto make_type = [](TensorProto_DataType elem_type, std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    type.mutable_tensor_type()->mutable_shape();
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  // y_i = x_i * Gather(Neg(data), indices). There is no loop state, the final value of a loop state is not written
+  // when the scan input is empty.
+  auto create_body = [&](const std::string& data_name, const std::string& indices_name, GraphProto& graph_proto) {
+    const TypeProto data_type = make_type(TensorProto_DataType_FLOAT, {3});
+    const TypeProto indices_type = make_type(TensorProto_DataType_INT64, {2});
+    const TypeProto value_type = make_type(TensorProto_DataType_FLOAT, {2});
+
+    Model model("LoopInvariantCodeMotionTest_scan_body", false, ModelMetaData(), PathString(),
+                IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    auto& x_i = graph.GetOrCreateNodeArg("x_i", &value_type);
+    auto& data = graph.GetOrCreateNodeArg(data_name, &data_type);
+    auto& indices = graph.GetOrCreateNodeArg(indices_name, &indices_type);
+    graph.AddOuterScopeNodeArg(data_name);
+    graph.AddOuterScopeNodeArg(indices_name);
+
+    auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &data_type);
+    graph.AddNode("neg", "Neg", "Invariant, cannot fail.", {&data}, {&neg_out});
+    auto& gather_out = graph.GetOrCreateNodeArg("gather_out", &value_type);
+    graph.AddNode("gather", "Gather", "Invariant, fails on an out of range index.", {&neg_out, &indices},
+                  {&gather_out});
+    auto& y_i = graph.GetOrCreateNodeArg("y_i", &value_type);
+    graph.AddNode("mul", "Mul", "Uses the scanned value.", {&x_i, &gather_out}, {&y_i});
+
+    graph.SetInputs({&x_i});
+    graph.SetOutputs({&y_i});
+
+    ASSERT_STATUS_OK(graph.Resolve());
+    graph_proto = graph.ToGraphProto();
+  };
+
+  for (int64_t scan_length : {0, 3}) {
+    SCOPED_TRACE(MakeString("scan_length: ", scan_length));
+
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* xs = builder.MakeInput<float>({scan_length, 2}, -1.f, 1.f);
+      auto* data = builder.MakeInput<float>({3}, {1.f, 2.f, 3.f});
+      // the index 5 is out of range, it is only used when the scan does not run.
+      auto* indices = builder.MakeInput<int64_t>({2}, {scan_length == 0 ? 5 : 2, 0});
+      auto* ys = builder.MakeOutput();
+
+      GraphProto body;
+      create_body(data->Name(), indices->Name(), body);
+      Node& scan_node = builder.AddNode("Scan", {xs}, {ys});
+      scan_node.AddAttribute("body", body);
+      scan_node.AddAttribute("num_scan_inputs", static_cast<int64_t>(1));
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph(), /*recurse_into_subgraphs*/ false);
+      EXPECT_EQ(op_to_count["Neg"], 1);
+      EXPECT_EQ(op_to_count["Gather"], scan_length == 0 ? 0 : 1);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level1, 12);
+  }
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingWithShapeToInitializer) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/constant_folding_with_shape_to_initializer.onnx";
   std::shared_ptr<Model> model;
@@ -5289,6 +5615,203 @@ TEST_F(GraphTransformationTests, QuickGelu) {
   }
 }
 
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  // ((x - mean) / std * scale + bias), Tanh, * y, where the normalized value is also a graph output.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_x = builder.MakeInput<float>({2, 3, 40, 50}, -2.0f, 2.0f);
+    auto* input_y = builder.MakeInput<float>({2, 3, 40, 50}, -2.0f, 2.0f);
+    auto* mean = builder.MakeScalarInitializer<float>(0.5f);
+    auto* stddev = builder.MakeScalarInitializer<float>(1.5f);
+    auto* scale = builder.MakeInitializer<float>({2, 3, 40, 50}, -1.0f, 1.0f);
+    auto* bias = builder.MakeInitializer<float>({1, 1, 50}, -1.0f, 1.0f);
+    auto* sub_out = builder.MakeIntermediate();
+    auto* div_out = builder.MakeOutput();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Sub", {input_x, mean}, {sub_out});
+    builder.AddNode("Div", {sub_out, stddev}, {div_out});
+    builder.AddNode("Mul", {div_out, scale}, {mul_out});
+    builder.AddNode("Add", {mul_out, bias}, {add_out});
+    builder.AddNode("Tanh", {add_out}, {tanh_out});
+    builder.AddNode("Mul", {tanh_out, input_y}, {output});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Mul"] == 2);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Tanh"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Sub"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Div"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Tanh"] == 0);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "FusedElementwise") {
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 6);
+        TEST_RETURN_IF_NOT(node.OutputDefs().size() == 2);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("ops").strings_size() == 6);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+
+  // The fused kernel must produce the same outputs as the unfused graph.
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Tanh"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14, 1e-5, 1e-5);
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion_UnsupportedBroadcast) {
+  // The [40, 1] input broadcasts along the innermost axis, which FusedElementwise does not handle.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_x = builder.MakeInput<float>({2, 3, 40, 50}, -2.0f, 2.0f);
+    auto* scale = builder.MakeInitializer<float>({40, 1}, -1.0f, 1.0f);
+    auto* relu_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Relu", {input_x}, {relu_out});
+    builder.AddNode("Mul", {relu_out, scale}, {output});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Mul"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
+#if !defined(DISABLE_ML_OPS)
+TEST_F(GraphTransformationTests, MLPreprocessingFusion) {
+  // Imputer -> Scaler -> Normalizer -> Binarizer, as exported from a scikit-learn pipeline. Every third value is
+  // missing (0) so the Imputer replaces some values.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    std::vector<float> data(1000 * 6);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = i % 3 == 0 ? 0.f : static_cast<float>(i % 17) - 8.f;
+    }
+    auto* input = builder.MakeInput<float>({1000, 6}, data);
+    auto* imputer_out = builder.MakeIntermediate();
+    auto* scaler_out = builder.MakeIntermediate();
+    auto* normalizer_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    const std::vector<float> imputed_values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+    const std::vector<float> offset{0.5f, -0.5f, 1.f, 0.f, 2.f, -1.f};
+    const std::vector<float> scale{0.5f, 0.25f, 1.f, 2.f, 0.5f, 1.5f};
+    Node& imputer = builder.AddNode("Imputer", {input}, {imputer_out}, kMLDomain);
+    imputer.AddAttribute("imputed_value_floats", gsl::span<const float>(imputed_values));
+    imputer.AddAttribute("replaced_value_float", 0.f);
+    Node& scaler = builder.AddNode("Scaler", {imputer_out}, {scaler_out}, kMLDomain);
+    scaler.AddAttribute("offset", gsl::span<const float>(offset));
+    scaler.AddAttribute("scale", gsl::span<const float>(scale));
+    Node& normalizer = builder.AddNode("Normalizer", {scaler_out}, {normalizer_out}, kMLDomain);
+    normalizer.AddAttribute("norm", std::string("L2"));
+    Node& binarizer = builder.AddNode("Binarizer", {normalizer_out}, {output}, kMLDomain);
+    binarizer.AddAttribute("threshold", 0.1f);
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ai.onnx.ml.Scaler"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedMLPreprocessing"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Imputer"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Scaler"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Normalizer"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Binarizer"] == 0);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "FusedMLPreprocessing") {
+        const auto& attributes = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attributes.at("steps").strings_size() == 4);
+        TEST_RETURN_IF_NOT(attributes.at("parameters").floats_size() == 7 + 12 + 1);
+        TEST_RETURN_IF_NOT(attributes.at("norms").strings_size() == 1);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MLPreprocessingFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+
+  // The fused kernel must produce the same outputs as the unfused graph.
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMLPreprocessing"], 1);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Normalizer"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14, 0.0, 0.0);
+}
+
+TEST_F(GraphTransformationTests, MLPreprocessingFusion_SharedIntermediate) {
+  // The output of the Scaler is also a graph output, so only the Normalizer and Binarizer are fused.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({8, 5}, -2.0f, 2.0f);
+    auto* scaler_out = builder.MakeOutput();
+    auto* normalizer_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    const std::vector<float> offset{0.5f};
+    const std::vector<float> scale{2.f};
+    Node& scaler = builder.AddNode("Scaler", {input}, {scaler_out}, kMLDomain);
+    scaler.AddAttribute("offset", gsl::span<const float>(offset));
+    scaler.AddAttribute("scale", gsl::span<const float>(scale));
+    Node& normalizer = builder.AddNode("Normalizer", {scaler_out}, {normalizer_out}, kMLDomain);
+    normalizer.AddAttribute("norm", std::string("MAX"));
+    builder.AddNode("Binarizer", {normalizer_out}, {output}, kMLDomain);
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ai.onnx.ml.Scaler"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedMLPreprocessing"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Scaler"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Normalizer"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["ai.onnx.ml.Binarizer"] == 0);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MLPreprocessingFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+#endif  // !defined(DISABLE_ML_OPS)
+
 struct BiasSoftmaxFusionTester {
   std::shared_ptr<Model> p_model_;
   Status model_load_;
@@ -5702,6 +6225,482 @@ TEST_F(GraphTransformationTests, ReshapeFusionOpsetTest) {
 }
 #endif
 
+static Status CheckFoldedReshapeShape(Graph& graph, const std::vector<int64_t>& expected_shape) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Reshape") {
+      InlinedVector<int64_t> shape;
+      TEST_RETURN_IF_NOT(optimizer_utils::AppendTensorFromInitializer(graph, *node.InputDefs()[1], shape, true));
+      TEST_RETURN_IF_NOT(std::vector<int64_t>(shape.begin(), shape.end()) == expected_shape);
+    }
+  }
+  return Status::OK();
+}
+
+TEST_F(GraphTransformationTests, SymbolicShapeFoldingDimParams) {
+  // The shape is taken from the mask, whose dims are only known to match the input through their dim_params.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", "seq", 768});
+    auto* mask_arg = builder.MakeSymbolicInput<int64_t>({"batch", "seq"});
+    auto* indices_0 = builder.MakeInitializer<int64_t>({}, {0});
+    auto* indices_1 = builder.MakeInitializer<int64_t>({}, {1});
+    auto* axes = builder.MakeInitializer<int64_t>({1}, {0});
+    auto* num_heads = builder.MakeInitializer<int64_t>({1}, {12});
+    auto* head_size = builder.MakeInitializer<int64_t>({1}, {64});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* gather_out_0 = builder.MakeIntermediate();
+    auto* gather_out_1 = builder.MakeIntermediate();
+    auto* unsqueeze_out_0 = builder.MakeIntermediate();
+    auto* unsqueeze_out_1 = builder.MakeIntermediate();
+    auto* concat_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Shape", {mask_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, indices_0}, {gather_out_0});
+    builder.AddNode("Gather", {shape_out, indices_1}, {gather_out_1});
+    builder.AddNode("Unsqueeze", {gather_out_0, axes}, {unsqueeze_out_0});
+    builder.AddNode("Unsqueeze", {gather_out_1, axes}, {unsqueeze_out_1});
+    builder.AddNode("Concat", {unsqueeze_out_0, unsqueeze_out_1, num_heads, head_size}, {concat_out})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Reshape", {input_arg, concat_out}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Concat"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Unsqueeze"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Concat"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Reshape"] == 1);
+    return CheckFoldedReshapeShape(graph, {0, 0, 12, 64});
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SymbolicShapeFolding>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer), TransformerLevel::Level1,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, SymbolicShapeFoldingProduct) {
+  // [batch, seq, 768] -> [batch * seq, 768]. The product cannot be copied from the input so it becomes -1.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", "seq", 768});
+    auto* indices_0 = builder.MakeInitializer<int64_t>({}, {0});
+    auto* indices_1 = builder.MakeInitializer<int64_t>({}, {1});
+    auto* axes = builder.MakeInitializer<int64_t>({1}, {0});
+    auto* starts = builder.MakeInitializer<int64_t>({1}, {2});
+    auto* ends = builder.MakeInitializer<int64_t>({1}, {3});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* gather_out_0 = builder.MakeIntermediate();
+    auto* gather_out_1 = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* unsqueeze_out = builder.MakeIntermediate();
+    auto* slice_out = builder.MakeIntermediate();
+    auto* concat_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, indices_0}, {gather_out_0});
+    builder.AddNode("Gather", {shape_out, indices_1}, {gather_out_1});
+    builder.AddNode("Mul", {gather_out_0, gather_out_1}, {mul_out});
+    builder.AddNode("Unsqueeze", {mul_out, axes}, {unsqueeze_out});
+    builder.AddNode("Slice", {shape_out, starts, ends}, {slice_out});
+    builder.AddNode("Concat", {unsqueeze_out, slice_out}, {concat_out}).AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Reshape", {input_arg, concat_out}, {output_arg});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Slice"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Concat"] == 0);
+    return CheckFoldedReshapeShape(graph, {-1, 768});
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SymbolicShapeFolding>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer), TransformerLevel::Level1,
+                                        1, nullptr, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, SymbolicShapeFoldingZeroDim) {
+  // [P, B, 12, 64] -> [P, B * 768]. P is copied as 0 and the product would become -1, but [0, -1] cannot be inferred
+  // when P is 0, so the shape is left alone.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"P", "B", 12, 64});
+    auto* indices_0 = builder.MakeInitializer<int64_t>({}, {0});
+    auto* indices_1 = builder.MakeInitializer<int64_t>({}, {1});
+    auto* hidden_size = builder.MakeInitializer<int64_t>({}, {768});
+    auto* axes = builder.MakeInitializer<int64_t>({1}, {0});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* gather_out_0 = builder.MakeIntermediate();
+    auto* gather_out_1 = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* unsqueeze_out_0 = builder.MakeIntermediate();
+    auto* unsqueeze_out_1 = builder.MakeIntermediate();
+    auto* concat_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, indices_0}, {gather_out_0});
+    builder.AddNode("Gather", {shape_out, indices_1}, {gather_out_1});
+    builder.AddNode("Mul", {gather_out_1, hidden_size}, {mul_out});
+    builder.AddNode("Unsqueeze", {gather_out_0, axes}, {unsqueeze_out_0});
+    builder.AddNode("Unsqueeze", {mul_out, axes}, {unsqueeze_out_1});
+    builder.AddNode("Concat", {unsqueeze_out_0, unsqueeze_out_1}, {concat_out})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Reshape", {input_arg, concat_out}, {output_arg});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Mul"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Concat"] == 1);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Reshape") {
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 1) != nullptr);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SymbolicShapeFolding>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer), TransformerLevel::Level1,
+                                        1, nullptr, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, MixedPrecisionTransformer) {
+  // Gemm -> Relu -> Gemm runs in fp16 with a Cast on the way in and out. The Relu on the input is not connected to a
+  // compute bound node so it stays in fp32, as does Softmax which is not on the allow list. The Gemm with transB
+  // stays in fp32 too, the fp16 kernel would not use MLAS for it.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8}, -1.f, 1.f);
+    auto* weight_1 = builder.MakeInitializer<float>({8, 8}, -1.f, 1.f);
+    auto* bias_1 = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+    auto* weight_2 = builder.MakeInitializer<float>({8, 4}, -1.f, 1.f);
+    auto* bias_2 = builder.MakeInitializer<float>({1, 4}, -1.f, 1.f);
+    auto* weight_3 = builder.MakeInitializer<float>({4, 8}, -1.f, 1.f);
+    auto* bias_3 = builder.MakeInitializer<float>({4}, -1.f, 1.f);
+    auto* gemm_out_1 = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* gemm_out_2 = builder.MakeIntermediate();
+    auto* softmax_out = builder.MakeOutput();
+    auto* input_relu_out = builder.MakeOutput();
+    auto* transposed_gemm_out = builder.MakeOutput();
+
+    builder.AddNode("Gemm", {input_arg, weight_1, bias_1}, {gemm_out_1});
+    builder.AddNode("Relu", {gemm_out_1}, {relu_out});
+    builder.AddNode("Gemm", {relu_out, weight_2, bias_2}, {gemm_out_2});
+    builder.AddNode("Gemm", {input_arg, weight_3, bias_3}, {transposed_gemm_out})
+        .AddAttribute("transB", static_cast<int64_t>(1));
+    builder.AddNode("Softmax", {gemm_out_2}, {softmax_out});
+    builder.AddNode("Relu", {input_arg}, {input_relu_out});
+    for (auto& node : builder.graph_.Nodes()) {
+      node.SetExecutionProviderType(kCpuExecutionProvider);
+    }
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Cast"] == 2);
+
+    for (const auto& node : graph.Nodes()) {
+      const bool is_fp16 = node.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type() ==
+                           ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+      if (node.OpType() == "Gemm") {
+        const auto* trans_b = graph_utils::GetNodeAttribute(node, "transB");
+        if (trans_b != nullptr && trans_b->i() != 0) {
+          TEST_RETURN_IF_NOT(!is_fp16);
+          continue;
+        }
+        TEST_RETURN_IF_NOT(is_fp16);
+        const auto* weight = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+        TEST_RETURN_IF_NOT(weight != nullptr && weight->data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+      } else if (node.OpType() == "Relu") {
+        TEST_RETURN_IF_NOT(is_fp16 != graph.IsOutput(node.OutputDefs()[0]));
+      } else if (node.OpType() == "Softmax") {
+        TEST_RETURN_IF_NOT(!is_fp16);
+      }
+    }
+    return Status::OK();
+  };
+
+  // placeholder fp16 kernels so the result does not depend on the fp16 kernels of the platform.
+  auto cpu_registry = std::make_shared<KernelRegistry>();
+  for (const char* op_type : {"Gemm", "Relu"}) {
+    auto kernel_def = KernelDefBuilder()
+                          .SetName(op_type)
+                          .SetDomain(kOnnxDomain)
+                          .SinceVersion(13)
+                          .Provider(kCpuExecutionProvider)
+                          .TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>())
+                          .Build();
+    ASSERT_STATUS_OK(cpu_registry->Register(KernelCreateInfo(
+        std::move(kernel_def),
+        [](FuncManager&, const OpKernelInfo&, std::unique_ptr<OpKernel>&) -> Status { return Status::OK(); })));
+  }
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MixedPrecisionTransformer>(cpu_registry);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer), TransformerLevel::Level3,
+                                        1, nullptr, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, RotaryEmbeddingFusion) {
+  // x * cos + rotate_half(x) * sin, with cos and sin gathered from caches whose rows are concat(freqs, freqs).
+  constexpr int64_t max_sequence_length = 8;
+  constexpr int64_t head_size = 16;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* x = builder.MakeInput<float>({2, 2, 3, head_size}, -1.f, 1.f);
+    auto* position_ids = builder.MakeInput<int64_t>({2, 3}, 0, max_sequence_length);
+
+    std::vector<float> cos_data;
+    std::vector<float> sin_data;
+    for (int64_t position = 0; position < max_sequence_length; ++position) {
+      for (int64_t half = 0; half < 2; ++half) {
+        for (int64_t i = 0; i < head_size / 2; ++i) {
+          const float freq = position * std::pow(10000.f, -2.f * i / head_size);
+          cos_data.push_back(std::cos(freq));
+          sin_data.push_back(std::sin(freq));
+        }
+      }
+    }
+
+    auto gather_cache = [&](const std::vector<float>& cache_data) {
+      auto* gathered = builder.MakeIntermediate();
+      auto* unsqueezed = builder.MakeIntermediate();
+      builder.AddNode("Gather", {builder.MakeInitializer<float>({max_sequence_length, head_size}, cache_data),
+                                 position_ids},
+                      {gathered});
+      builder.AddNode("Unsqueeze", {gathered, builder.Make1DInitializer<int64_t>({1})}, {unsqueezed});
+      return unsqueezed;
+    };
+    auto* cos = gather_cache(cos_data);
+    auto* sin = gather_cache(sin_data);
+
+    auto* first_half = builder.MakeIntermediate();
+    auto* second_half = builder.MakeIntermediate();
+    auto* neg_out = builder.MakeIntermediate();
+    auto* rotated = builder.MakeIntermediate();
+    auto* x_cos = builder.MakeIntermediate();
+    auto* rotated_sin = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Slice", {x, builder.Make1DInitializer<int64_t>({0}), builder.Make1DInitializer<int64_t>({8}),
+                              builder.Make1DInitializer<int64_t>({-1})},
+                    {first_half});
+    builder.AddNode("Slice", {x, builder.Make1DInitializer<int64_t>({8}),
+                              builder.Make1DInitializer<int64_t>({std::numeric_limits<int64_t>::max()}),
+                              builder.Make1DInitializer<int64_t>({-1})},
+                    {second_half});
+    builder.AddNode("Neg", {second_half}, {neg_out});
+    builder.AddNode("Concat", {neg_out, first_half}, {rotated}).AddAttribute("axis", int64_t{-1});
+    builder.AddNode("Mul", {x, cos}, {x_cos});
+    builder.AddNode("Mul", {rotated, sin}, {rotated_sin});
+    builder.AddNode("Add", {x_cos, rotated_sin}, {output});
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map.size() == 1);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.RotaryEmbedding"] == 1);
+
+    // the caches are replaced with their first halves.
+    const Node& rotary = *graph.Nodes().begin();
+    for (size_t i : {2, 3}) {
+      const auto* cache = graph_utils::GetConstantInitializer(graph, rotary.InputDefs()[i]->Name());
+      TEST_RETURN_IF_NOT(cache != nullptr && cache->dims_size() == 2);
+      TEST_RETURN_IF_NOT(cache->dims(0) == max_sequence_length && cache->dims(1) == head_size / 2);
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<RotaryEmbeddingFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, nullptr, post_graph_checker));
+
+  // the fused node gives the same result as the unfused graph.
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 1);
+    EXPECT_EQ(op_to_count["Concat"], 0);
+  };
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level2, 14, 1e-5, 1e-5,
+                    std::make_unique<RotaryEmbeddingFusion>());
+}
+
+// Causal self attention with 4 query heads sharing 2 key/value heads of size 16, a past key/value cache and an
+// additive mask computed from the 2D attention mask.
+static void BuildGroupQueryAttentionFusionTestCase(ModelTestBuilder& builder, int64_t sequence_length,
+                                                   int64_t past_sequence_length) {
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t max_sequence_length = 16;
+  constexpr int64_t num_heads = 4;
+  constexpr int64_t kv_num_heads = 2;
+  constexpr int64_t head_size = 16;
+  const int64_t total_sequence_length = past_sequence_length + sequence_length;
+  auto* hidden_states = builder.MakeInput<float>({batch_size, sequence_length, num_heads * head_size}, -1.f, 1.f);
+  auto* attention_mask = builder.MakeInput<int64_t>({batch_size, total_sequence_length},
+                                                    std::vector<int64_t>(batch_size * total_sequence_length, 1));
+  std::vector<int64_t> positions;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t s = 0; s < sequence_length; ++s) {
+      positions.push_back(past_sequence_length + s);
+    }
+  }
+  auto* position_ids = builder.MakeInput<int64_t>({batch_size, sequence_length}, positions);
+  auto* past_key = builder.MakeInput<float>({batch_size, kv_num_heads, past_sequence_length, head_size}, -1.f, 1.f);
+  auto* past_value = builder.MakeInput<float>({batch_size, kv_num_heads, past_sequence_length, head_size}, -1.f, 1.f);
+  auto* cos_cache = builder.MakeInitializer<float>({max_sequence_length, head_size / 2}, -1.f, 1.f);
+  auto* sin_cache = builder.MakeInitializer<float>({max_sequence_length, head_size / 2}, -1.f, 1.f);
+  auto* output = builder.MakeOutput();
+  auto* present_key = builder.MakeOutput();
+  auto* present_value = builder.MakeOutput();
+
+  // projects the hidden states and splits the heads, (B, S, N * H) -> (B, N, S, H).
+  auto split_heads = [&](int64_t heads) {
+    auto* projection = builder.MakeIntermediate();
+    auto* reshaped = builder.MakeIntermediate();
+    auto* transposed = builder.MakeIntermediate();
+    builder.AddNode("MatMul", {hidden_states,
+                               builder.MakeInitializer<float>({num_heads * head_size, heads * head_size}, -1.f, 1.f)},
+                    {projection});
+    builder.AddNode("Reshape", {projection, builder.Make1DInitializer<int64_t>({0, 0, heads, head_size})},
+                    {reshaped});
+    builder.AddNode("Transpose", {reshaped}, {transposed}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    return transposed;
+  };
+  auto rotate = [&](NodeArg* heads) {
+    auto* rotated = builder.MakeIntermediate();
+    builder.AddNode("RotaryEmbedding", {heads, position_ids, cos_cache, sin_cache}, {rotated}, kMSDomain);
+    return rotated;
+  };
+  // repeat_kv, (B, kv_N, T, H) -> (B, N, T, H).
+  auto repeat_kv = [&](NodeArg* kv) {
+    auto* unsqueezed = builder.MakeIntermediate();
+    auto* expanded = builder.MakeIntermediate();
+    auto* repeated = builder.MakeIntermediate();
+    builder.AddNode("Unsqueeze", {kv, builder.Make1DInitializer<int64_t>({2})}, {unsqueezed});
+    builder.AddNode("Expand", {unsqueezed, builder.Make1DInitializer<int64_t>({batch_size, kv_num_heads,
+                                                                               num_heads / kv_num_heads,
+                                                                               total_sequence_length, head_size})},
+                    {expanded});
+    builder.AddNode("Reshape", {expanded, builder.Make1DInitializer<int64_t>({batch_size, num_heads,
+                                                                              total_sequence_length, head_size})},
+                    {repeated});
+    return repeated;
+  };
+
+  auto* query = rotate(split_heads(num_heads));
+  builder.AddNode("Concat", {past_key, rotate(split_heads(kv_num_heads))}, {present_key})
+      .AddAttribute("axis", int64_t{2});
+  builder.AddNode("Concat", {past_value, split_heads(kv_num_heads)}, {present_value})
+      .AddAttribute("axis", int64_t{2});
+
+  // (1 - attention_mask) * -10000 + the causal mask
+  auto* mask_float = builder.MakeIntermediate();
+  auto* inverted_mask = builder.MakeIntermediate();
+  auto* padding_mask = builder.MakeIntermediate();
+  auto* padding_mask_4d = builder.MakeIntermediate();
+  auto* causal_mask = builder.MakeIntermediate();
+  auto* mask = builder.MakeIntermediate();
+  builder.AddNode("Cast", {attention_mask}, {mask_float})
+      .AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  builder.AddNode("Sub", {builder.MakeScalarInitializer<float>(1.f), mask_float}, {inverted_mask});
+  builder.AddNode("Mul", {inverted_mask, builder.MakeScalarInitializer<float>(-10000.f)}, {padding_mask});
+  builder.AddNode("Unsqueeze", {padding_mask, builder.Make1DInitializer<int64_t>({1, 2})}, {padding_mask_4d});
+  builder.AddNode("Trilu", {builder.MakeInitializer<float>({sequence_length, total_sequence_length},
+                                                           std::vector<float>(sequence_length * total_sequence_length,
+                                                                              -10000.f)),
+                            builder.MakeScalarInitializer<int64_t>(past_sequence_length + 1)},
+                  {causal_mask});
+  builder.AddNode("Add", {padding_mask_4d, causal_mask}, {mask});
+
+  auto* key_transposed = builder.MakeIntermediate();
+  auto* qk = builder.MakeIntermediate();
+  auto* scaled_qk = builder.MakeIntermediate();
+  auto* masked_qk = builder.MakeIntermediate();
+  auto* probs = builder.MakeIntermediate();
+  auto* context = builder.MakeIntermediate();
+  auto* context_transposed = builder.MakeIntermediate();
+  builder.AddNode("Transpose", {repeat_kv(present_key)}, {key_transposed})
+      .AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+  builder.AddNode("MatMul", {query, key_transposed}, {qk});
+  builder.AddNode("Div", {qk, builder.MakeScalarInitializer<float>(4.f)}, {scaled_qk});
+  builder.AddNode("Add", {scaled_qk, mask}, {masked_qk});
+  builder.AddNode("Softmax", {masked_qk}, {probs}).AddAttribute("axis", int64_t{-1});
+  builder.AddNode("MatMul", {probs, repeat_kv(present_value)}, {context});
+  builder.AddNode("Transpose", {context}, {context_transposed}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  builder.AddNode("Reshape", {context_transposed, builder.Make1DInitializer<int64_t>({0, 0, num_heads * head_size})},
+                  {output});
+
+  for (auto& node : builder.graph_.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion) {
+  constexpr int64_t num_heads = 4;
+  constexpr int64_t kv_num_heads = 2;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    BuildGroupQueryAttentionFusionTestCase(builder, 3, 5);
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    // the q/k/v projections, the fused attention and the computation of seqlens_k and total_sequence_length.
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["MatMul"] == 3);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.GroupQueryAttention"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Cast"] == 2);
+    TEST_RETURN_IF_NOT(op_count_map["ReduceSum"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Sub"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 1);
+    TEST_RETURN_IF_NOT(graph.NumberOfNodes() == 10);
+
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "GroupQueryAttention") {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("num_heads").i() == num_heads);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("kv_num_heads").i() == kv_num_heads);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("scale").f() == 0.25f);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("do_rotary").i() == 1);
+        TEST_RETURN_IF_NOT(graph.IsOutput(node.OutputDefs()[1]) && graph.IsOutput(node.OutputDefs()[2]));
+        TEST_RETURN_IF_NOT(graph_utils::IsGraphInput(graph, node.InputDefs()[3]) &&
+                           graph_utils::IsGraphInput(graph, node.InputDefs()[4]));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<GroupQueryAttentionFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, nullptr, post_graph_checker));
+}
+
+// GroupQueryAttention treats inputs with more than one token as prompts without past, so the outputs are compared for
+// token generation.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion_TokenGeneration) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    BuildGroupQueryAttentionFusionTestCase(builder, 1, 5);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 0);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+  };
+
+  // -10000 in the additive mask and the -inf of the fused kernel give the same probabilities.
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Default, TransformerLevel::Level2, 14, 1e-4, 1e-4,
+                    std::make_unique<GroupQueryAttentionFusion>());
+}
+
 TEST_F(GraphTransformationTests, DynamicQuantizeMatMulTest) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/dynamic_quantize_matmul.onnx";
   std::shared_ptr<Model> p_model;
@@ -7783,6 +8782,160 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, MatMulNBitsQuantization) {
+  constexpr int64_t K = 64, N = 16;
+
+  // Every block of 32 elements along K holds all multiples of 0.125 in [-1, 0.875], which both the symmetric and the
+  // asymmetric 4 bits quantization represent exactly.
+  std::vector<float> weight_data(K * N);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      weight_data[k * N + n] = static_cast<float>((k * 7 + n * 3) % 16 - 8) * 0.125f;
+    }
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({2, 3, K}, -1.0f, 1.0f);
+    auto* weight = builder.MakeInitializer<float>({K, N}, weight_data);
+    auto* small_weight = builder.MakeInitializer<float>({N, 8}, -1.0f, 1.0f);
+    auto* matmul_output = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input, weight}, {matmul_output});
+    builder.AddNode("MatMul", {matmul_output, small_weight}, {output});
+  };
+
+  for (bool is_symmetric : {false, true}) {
+    SCOPED_TRACE(MakeString("is_symmetric:", is_symmetric));
+
+    auto pre_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 2);
+      return Status::OK();
+    };
+
+    // The weight with K smaller than the block size is left alone.
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.MatMulNBits"] == 1);
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() == "MatMulNBits") {
+          TEST_RETURN_IF_NOT(node.GetAttributes().at("K").i() == K);
+          TEST_RETURN_IF_NOT(node.GetAttributes().at("N").i() == N);
+          TEST_RETURN_IF_NOT(node.GetAttributes().at("block_size").i() == 32);
+          TEST_RETURN_IF_NOT(node.InputDefs().size() == (is_symmetric ? 3u : 4u));
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_,
+                                          std::make_unique<MatMulNBitsQuantization>(32, is_symmetric, 0),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+    };
+
+    auto add_session_options = [&](SessionOptions& session_options) {
+      ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+          kOrtSessionOptionsMatMulNBitsQuantizationBlockSize, "32"));
+      ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+          kOrtSessionOptionsMatMulNBitsQuantizationSymmetric, is_symmetric ? "1" : "0"));
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                      1e-4, 1e-4, nullptr, add_session_options);
+  }
+}
+
+TEST_F(GraphTransformationTests, MatMulNBitsQuantizationGemm) {
+  constexpr int64_t K = 64, N = 16;
+
+  // Same exactly quantizable values as in the MatMulNBitsQuantization test, also stored as [N, K] for transB.
+  auto weight_value = [](int64_t k, int64_t n) { return static_cast<float>((k * 7 + n * 3) % 16 - 8) * 0.125f; };
+  std::vector<float> weight_data(K * N);
+  std::vector<float> weight_t_data(K * N);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      weight_data[k * N + n] = weight_value(k, n);
+      weight_t_data[n * K + k] = weight_value(k, n);
+    }
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({3, K}, -1.0f, 1.0f);
+    auto* weight = builder.MakeInitializer<float>({K, N}, weight_data);
+    auto* weight_t = builder.MakeInitializer<float>({N, K}, weight_t_data);
+    auto* bias = builder.MakeInitializer<float>({N}, -1.0f, 1.0f);
+    auto* bias_2d = builder.MakeInitializer<float>({1, N}, -1.0f, 1.0f);
+    auto* output_1 = builder.MakeOutput();
+    auto* output_2 = builder.MakeOutput();
+    auto* output_3 = builder.MakeOutput();
+
+    Node& gemm_1 = builder.AddNode("Gemm", {input, weight_t, bias}, {output_1});
+    gemm_1.AddAttribute("transB", static_cast<int64_t>(1));
+    builder.AddNode("Gemm", {input, weight, bias_2d}, {output_2});
+    // alpha is not supported by MatMulNBits.
+    Node& gemm_3 = builder.AddNode("Gemm", {input, weight}, {output_3});
+    gemm_3.AddAttribute("alpha", 2.0f);
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gemm"] == 3);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Gemm"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.MatMulNBits"] == 2);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "MatMulNBits") {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("K").i() == K);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("N").i() == N);
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 6u);
+        const NodeArg* bias_arg = node.InputDefs()[5];
+        TEST_RETURN_IF_NOT(bias_arg->Exists());
+        TEST_RETURN_IF_NOT(bias_arg->Shape() != nullptr && bias_arg->Shape()->dim_size() == 1);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_,
+                                        std::make_unique<MatMulNBitsQuantization>(32, false, 0),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+
+  // A 2D MatMul + Add is turned into Gemm at Level1, the quantization must still pick it up with its bias.
+  auto build_matmul_add = [&](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({3, K}, -1.0f, 1.0f);
+    auto* weight = builder.MakeInitializer<float>({K, N}, weight_data);
+    auto* bias = builder.MakeInitializer<float>({N}, -1.0f, 1.0f);
+    auto* matmul_output = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input, weight}, {matmul_output});
+    builder.AddNode("Add", {matmul_output, bias}, {output});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+    EXPECT_EQ(op_to_count["Gemm"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+  };
+
+  auto add_session_options = [&](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+        kOrtSessionOptionsMatMulNBitsQuantizationBlockSize, "32"));
+  };
+
+  TransformerTester(build_matmul_add, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-4, 1e-4, nullptr, add_session_options);
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
@@ -429,6 +429,40 @@ TEST_F(GraphTransformationTests, SimplifiedLayerNormFusionTest) {
   }
 }
 
+// x * Reciprocal(Sqrt(.)) as exported from x * torch.rsqrt(.) by LLaMA style RMSNorm.
+TEST_F(GraphTransformationTests, SimplifiedLayerNormWithReciprocalFusionTest) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, 8}, -1.f, 1.f);
+    auto* scale_arg = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+    auto* pow_out = builder.MakeIntermediate();
+    auto* reduce_mean_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* sqrt_out = builder.MakeIntermediate();
+    auto* reciprocal_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Pow", {input_arg, builder.MakeScalarInitializer<float>(2.f)}, {pow_out});
+    builder.AddNode("ReduceMean", {pow_out}, {reduce_mean_out}).AddAttribute("axes", std::vector<int64_t>{-1});
+    builder.AddNode("Add", {reduce_mean_out, builder.MakeScalarInitializer<float>(1e-6f)}, {add_out});
+    builder.AddNode("Sqrt", {add_out}, {sqrt_out});
+    builder.AddNode("Reciprocal", {sqrt_out}, {reciprocal_out});
+    builder.AddNode("Mul", {input_arg, reciprocal_out}, {mul_out});
+    builder.AddNode("Mul", {scale_arg, mul_out}, {output_arg});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map.size() == 1);
+    TEST_RETURN_IF_NOT(op_count_map["SimplifiedLayerNormalization"] == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SimplifiedLayerNormFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, nullptr, post_graph_checker));
+}
+
 // It tests the scenario when scale or bias are not Graph Inputs and not initialized in Graph
 // To test this added a Identity node after Scale and Bias terms to ensure LayerNormFusion works properly
 TEST_F(GraphTransformationTests, LayerNormScaleBiasTest) {
@@ -8,6 +8,7 @@
 #include "graph_transform_test_builder.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/graph/graph.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -516,6 +517,240 @@ TEST(NhwcTransformerTests, ConvMixTensorRanks) {
                     TransformerLevel::Level3);
 }
 
+static void EnableFp32Nhwc(SessionOptions& session_options) {
+  ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsEnableFp32NhwcLayout, "1"));
+}
+
+TEST(NhwcTransformerTests, ConvFp32) {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
+                       int64_t group) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.0f, 1.0f);
+      auto* output_arg = builder.MakeOutput();
+      auto* weight_arg = builder.MakeInitializer<float>(weights_shape, -1.0f, 1.0f);
+      auto* bias_arg = builder.MakeInitializer<float>({weights_shape[0]}, -1.0f, 1.0f);
+
+      Node& conv_node = builder.AddNode("Conv", {input_arg, weight_arg, bias_arg}, {output_arg});
+      conv_node.AddAttribute("group", group);
+      conv_node.AddAttribute("pads", std::vector<int64_t>((weights_shape.size() - 2) * 2, 1));
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3,
+                      12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+  };
+
+  // Test 1D/2D/3D convolutions, pointwise, grouped and depthwise convolutions.
+  test_case({1, 12, 37}, {32, 12, 5}, 1);
+  test_case({2, 23, 13, 13}, {30, 23, 3, 3}, 1);
+  test_case({1, 16, 9, 9}, {24, 16, 1, 1}, 1);
+  test_case({1, 16, 15, 15}, {32, 8, 3, 3}, 2);
+  test_case({1, 19, 15, 15}, {19, 1, 3, 3}, 19);
+  test_case({1, 22, 11, 13, 15}, {30, 22, 5, 3, 3}, 1);
+}
+
+TEST(NhwcTransformerTests, ConvFp32NotEnabled) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 23, 13, 13}, -1.0f, 1.0f);
+    auto* output_arg = builder.MakeOutput();
+    auto* weight_arg = builder.MakeInitializer<float>({30, 23, 3, 3}, -1.0f, 1.0f);
+
+    builder.AddConvNode(input_arg, weight_arg, output_arg);
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 0);
+  };
+
+  // Test that fp32 operators are left alone unless the fp32 NHWC layout is enabled.
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12, 1e-4, 1e-4);
+}
+
+TEST(NhwcTransformerTests, ConvAddActivationFp32) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 16, 17, 17}, -1.0f, 1.0f);
+    auto* conv1_output_arg = builder.MakeIntermediate();
+    auto* conv2_output_arg = builder.MakeIntermediate();
+    auto* add_output_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* conv1_weight_arg = builder.MakeInitializer<float>({32, 16, 3, 3}, -1.0f, 1.0f);
+    auto* conv2_weight_arg = builder.MakeInitializer<float>({32, 32, 3, 3}, -1.0f, 1.0f);
+    auto* conv2_bias_arg = builder.MakeInitializer<float>({32}, -1.0f, 1.0f);
+
+    Node& conv1_node = builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    Node& conv2_node = builder.AddNode("Conv", {conv1_output_arg, conv2_weight_arg, conv2_bias_arg},
+                                       {conv2_output_arg});
+    conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    builder.AddNode("Add", {conv2_output_arg, conv1_output_arg}, {add_output_arg});
+    builder.AddNode("Relu", {add_output_arg}, {output_arg});
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 2);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+}
+
+TEST(NhwcTransformerTests, ConvMaxPoolFp32) {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.0f, 1.0f);
+      auto* conv_output_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      auto* conv_weight_arg = builder.MakeInitializer<float>(weights_shape, -1.0f, 1.0f);
+
+      builder.AddConvNode(input_arg, conv_weight_arg, conv_output_arg);
+      Node& pool_node = builder.AddNode("MaxPool", {conv_output_arg}, {output_arg});
+      std::vector<int64_t> pads((weights_shape.size() - 2) * 2, 1);
+      pool_node.AddAttribute("pads", pads);
+      std::vector<int64_t> kernel_shape(weights_shape.size() - 2, 3);
+      pool_node.AddAttribute("kernel_shape", kernel_shape);
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 1);
+      EXPECT_EQ(op_to_count["com.ms.internal.nhwc.MaxPool"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3,
+                      12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+  };
+
+  test_case({5, 12, 37}, {128, 12, 5});
+  test_case({3, 14, 13, 13}, {64, 14, 3, 3});
+  test_case({1, 15, 11, 13, 15}, {31, 15, 5, 3, 3});
+}
+
+TEST(NhwcTransformerTests, ConvMaxPoolIndexTensorFp32) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 16, 17, 17}, -1.0f, 1.0f);
+    auto* conv_output_arg = builder.MakeIntermediate();
+    auto* index_output_arg = builder.MakeOutput();
+    auto* output_arg = builder.MakeOutput();
+    auto* conv_weight_arg = builder.MakeInitializer<float>({16, 16, 3, 3}, -1.0f, 1.0f);
+
+    builder.AddConvNode(input_arg, conv_weight_arg, conv_output_arg);
+    Node& pool_node = builder.AddNode("MaxPool", {conv_output_arg}, {output_arg, index_output_arg});
+    pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 1);
+    EXPECT_EQ(op_to_count["MaxPool"], 1);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  // Test that MaxPool using the optional index tensor is not converted.
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+}
+
+TEST(NhwcTransformerTests, ConvAveragePoolFp32) {
+  auto test_case = [&](int64_t count_include_pad) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({1, 23, 13, 13}, -1.0f, 1.0f);
+      auto* conv1_output_arg = builder.MakeIntermediate();
+      auto* conv2_output_arg = builder.MakeIntermediate();
+      auto* avgpool1_output_arg = builder.MakeIntermediate();
+      auto* gavgpool_output_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      auto* conv1_weight_arg = builder.MakeInitializer<float>({30, 23, 3, 3}, -1.0f, 1.0f);
+      auto* conv2_weight_arg = builder.MakeInitializer<float>({16, 30, 3, 3}, -1.0f, 1.0f);
+      auto* conv3_weight_arg = builder.MakeInitializer<float>({8, 16, 1, 1}, -1.0f, 1.0f);
+
+      Node& conv1_node = builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+      conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      Node& avgpool_node = builder.AddNode("AveragePool", {conv1_output_arg}, {avgpool1_output_arg});
+      avgpool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+      avgpool_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      avgpool_node.AddAttribute("count_include_pad", count_include_pad);
+
+      builder.AddConvNode(avgpool1_output_arg, conv2_weight_arg, conv2_output_arg);
+      builder.AddNode("GlobalAveragePool", {conv2_output_arg}, {gavgpool_output_arg});
+      builder.AddConvNode(gavgpool_output_arg, conv3_weight_arg, output_arg);
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 3);
+      EXPECT_EQ(op_to_count["com.ms.internal.nhwc.AveragePool"], 1);
+      EXPECT_EQ(op_to_count["com.ms.internal.nhwc.GlobalAveragePool"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3,
+                      12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+  };
+
+  test_case(0);
+  test_case(1);
+}
+
+TEST(NhwcTransformerTests, ConvResizeFp32) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 16, 9, 9}, -1.0f, 1.0f);
+    auto* conv1_output_arg = builder.MakeIntermediate();
+    auto* resize_output_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* conv1_weight_arg = builder.MakeInitializer<float>({24, 16, 3, 3}, -1.0f, 1.0f);
+    auto* conv2_weight_arg = builder.MakeInitializer<float>({8, 24, 3, 3}, -1.0f, 1.0f);
+    auto* roi_arg = builder.MakeInitializer<float>({0}, {});
+    auto* scales_arg = builder.MakeInitializer<float>({4}, {1.0f, 1.0f, 2.0f, 2.0f});
+
+    builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+    Node& resize_node = builder.AddNode("Resize", {conv1_output_arg, roi_arg, scales_arg}, {resize_output_arg});
+    resize_node.AddAttribute("mode", "linear");
+    builder.AddConvNode(resize_output_arg, conv2_weight_arg, output_arg);
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 2);
+    EXPECT_EQ(op_to_count["Resize"], 1);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  // Test that a linear Resize between convolutions keeps the chain in NHWC.
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12, 1e-4, 1e-4, nullptr, EnableFp32Nhwc);
+}
+
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
 
 static std::vector<MLFloat16> ARangeOfFP16Values(const std::vector<int64_t>& shape, MLFloat16 min, MLFloat16 max) {
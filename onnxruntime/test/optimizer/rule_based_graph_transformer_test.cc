@@ -71,5 +71,54 @@ TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   ASSERT_STATUS_OK(graph_transformation_mgr.GetSteps(steps_queried));
   ASSERT_EQ(steps_queried, static_cast<unsigned>(10));
 }
+
+namespace {
+// Graph transformer that reports a modification the first `modifying_calls` times it is applied.
+class CountingGraphTransformer : public GraphTransformer {
+ public:
+  CountingGraphTransformer(const std::string& name, int modifying_calls) noexcept
+      : GraphTransformer(name), modifying_calls_(modifying_calls) {}
+
+  int CallCount() const { return call_count_; }
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/, const logging::Logger&) const override {
+    modified = call_count_++ < modifying_calls_;
+    return Status::OK();
+  }
+
+  const int modifying_calls_;
+  mutable int call_count_{0};
+};
+}  // namespace
+
+TEST(RuleBasedGraphTransformerTest, TestUnmodifiedTransformersAreSkipped) {
+  auto model_uri = ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx");
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  Graph& graph = model->MainGraph();
+
+  auto unmodifying = std::make_unique<CountingGraphTransformer>("Unmodifying", 0);
+  auto modifying = std::make_unique<CountingGraphTransformer>("Modifying", 2);
+  auto trailing = std::make_unique<CountingGraphTransformer>("Trailing", 0);
+  const auto* unmodifying_ptr = unmodifying.get();
+  const auto* modifying_ptr = modifying.get();
+  const auto* trailing_ptr = trailing.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(unmodifying), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(modifying), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(trailing), TransformerLevel::Level2));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2,
+                                                              DefaultLoggingManager().DefaultLogger()));
+
+  // the graph is modified in the first two steps, and the third step finds nothing to do.
+  // the trailing transformer ran after the last modification in the second step, so it is skipped in the third.
+  ASSERT_EQ(unmodifying_ptr->CallCount(), 3);
+  ASSERT_EQ(modifying_ptr->CallCount(), 3);
+  ASSERT_EQ(trailing_ptr->CallCount(), 2);
+}
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
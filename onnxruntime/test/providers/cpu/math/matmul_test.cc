@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
@@ -369,7 +370,92 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+// B has every other 4x16 block set to zero, so it is pre-packed for the MLAS block sparse GEMM.
+TEST(MathOpTest, MatMulBlockSparseWeights) {
+  constexpr int64_t M = 5, K = 24, N = 40;
+
+  std::vector<float> a_values(M * K);
+  for (int64_t i = 0; i < M * K; ++i) {
+    a_values[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+
+  std::vector<float> b_values(K * N, 0.0f);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      if ((k / 4 + n / 16) % 2 == 0) {
+        b_values[k * N + n] = static_cast<float>((k * N + n) % 5) - 2.0f;
+      }
+    }
+  }
+
+  std::vector<float> y_values(M * N, 0.0f);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y_values[m * N + n] += a_values[m * K + k] * b_values[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {M, N}, y_values);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasBlockSparseGemmMinSparsity, "0.4"));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 #endif
 
+// All the candidates of the CPU EP MatMul TunableOp are run while tuning, the result must not depend on the winner.
+TEST(MathOpTest, MatMulCpuTunableOp) {
+  constexpr int64_t batch = 3, M = 4, K = 5, N = 6;
+
+  std::vector<float> a_values(batch * M * K);
+  std::vector<float> b_values(batch * K * N);
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  for (size_t i = 0; i < b_values.size(); ++i) {
+    b_values[i] = static_cast<float>(i % 7) * 0.5f - 1.0f;
+  }
+
+  std::vector<float> y_values(batch * M * N, 0.0f);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        for (int64_t k = 0; k < K; ++k) {
+          y_values[(b * M + m) * N + n] += a_values[(b * M + m) * K + k] * b_values[(b * K + k) * N + n];
+        }
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {batch, M, K}, a_values);
+  test.AddInput<float>("B", {batch, K, N}, b_values);
+  test.AddOutput<float>("Y", {batch, M, N}, y_values);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpEnable, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpTuningEnable, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "10"));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -64,6 +64,41 @@ TEST(LabelEncoder, StringToIntOpset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, StringToIntLargeVocabularyOpset2) {
+  // Enough keys to grow the lookup table several times, and enough inputs to span several lookup batches.
+  constexpr int64_t num_keys = 5000;
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (int64_t i = 0; i < num_keys; ++i) {
+    keys.push_back("key_" + std::to_string(i));
+    values.push_back(i * 3);
+  }
+  // A duplicated key keeps its first value.
+  keys.push_back("key_7");
+  values.push_back(-7);
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (int64_t i = 0; i < 1000; ++i) {
+    const int64_t k = (i * 7919) % (num_keys + 500);
+    input.push_back("key_" + std::to_string(k));
+    output.push_back(k < num_keys ? k * 3 : -1);
+  }
+  input.push_back("");
+  output.push_back(-1);
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  const std::vector<std::int64_t> dims{static_cast<std::int64_t>(input.size())};
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 TEST(LabelEncoder, IntToStringOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
@@ -50,6 +50,151 @@ TEST(MLOpTest, SVMClassifierMulticlassSVC) {
   test.Run();
 }
 
+// The model of SVMClassifierMulticlassSVC with every support vector split into 1024 copies, so the kernels of a
+// batch of 1024 rows are computed in more than one block.
+TEST(MLOpTest, SVMClassifierMulticlassSVCLargeBatch) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  constexpr size_t copies = 1024;
+  constexpr int64_t repeats = 128;
+  const std::vector<float> base_coefficients = {1.14360327f, 1.95968249f, -1.175683f, -1.92760275f, -1.32575698f,
+                                                -1.32575698f, 0.66332785f, 0.66242913f, 0.53120854f, 0.53510444f,
+                                                -1.06631298f, -1.06631298f, 0.66332785f, 0.66242913f, 0.53120854f,
+                                                0.53510444f, 1.f, -1.f};
+  const std::vector<float> base_support_vectors = {0.f, 0.5f, 32.f, 2.f, 2.9f, -32.f, 1.f, 1.5f, 1.f, 3.f,
+                                                   13.3f, -11.f, 12.f, 12.9f, -312.f, 43.f, 413.3f, -114.f};
+  const std::vector<float> base_X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f,
+                                     11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f,
+                                     11.3f, -222.f, 43.0f, 413.3f, -114.f};
+  const std::vector<int64_t> base_predictions = {1, 1, 2, 0, 0, 0, 0, 3};
+  const std::vector<float> base_scores = {
+      -0.956958294f, 0.799815655f, 0.799815655f, 0.988598406f, 0.988598406f, 0,
+      -0.159782529f, 0.407864451f, 0.407864451f, 0.347750872f, 0.347750872f, 0,
+      0.527958274f, -0.999705434f, 0.326051623f, -0.999675810f, 0.0666372105f, 1.00000000f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, 0.326051623f, 0.0666372105f, 0.0666372105f, 0,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, -0.999705434f, 0.0666372105f, -0.999675810f, -1.00000000f};
+  const std::vector<int64_t> base_vectors_per_class = {2, 2, 1, 1};
+  constexpr size_t base_vector_count = 6;
+  constexpr size_t feature_count = 3;
+
+  std::vector<float> dual_coefficients;
+  for (size_t row = 0; row < base_coefficients.size() / base_vector_count; ++row) {
+    for (size_t v = 0; v < base_vector_count; ++v) {
+      const float coefficient = base_coefficients[row * base_vector_count + v] / copies;
+      dual_coefficients.insert(dual_coefficients.end(), copies, coefficient);
+    }
+  }
+  std::vector<float> support_vectors;
+  for (size_t v = 0; v < base_vector_count; ++v) {
+    for (size_t i = 0; i < copies; ++i) {
+      support_vectors.insert(support_vectors.end(), base_support_vectors.begin() + v * feature_count,
+                             base_support_vectors.begin() + (v + 1) * feature_count);
+    }
+  }
+  std::vector<int64_t> vectors_per_class;
+  for (int64_t count : base_vectors_per_class) {
+    vectors_per_class.push_back(count * static_cast<int64_t>(copies));
+  }
+
+  std::vector<float> X;
+  std::vector<int64_t> predictions;
+  std::vector<float> scores;
+  for (int64_t i = 0; i < repeats; ++i) {
+    X.insert(X.end(), base_X.begin(), base_X.end());
+    predictions.insert(predictions.end(), base_predictions.begin(), base_predictions.end());
+    scores.insert(scores.end(), base_scores.begin(), base_scores.end());
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", std::vector<float>{0.5279583f, 0.32605162f, 0.32605162f, 0.06663721f, 0.06663721f, 0.f});
+  test.AddAttribute("kernel_params", std::vector<float>{0.001f, 0.f, 3.f});  // gamma, coef0, degree
+  test.AddAttribute("classlabels_ints", std::vector<int64_t>{0, 1, 2, 3});
+
+  test.AddInput<float>("X", {8 * repeats, 3}, X);
+  test.AddOutput<int64_t>("Y", {8 * repeats}, predictions);
+  test.AddOutput<float>("Z", {8 * repeats, 6}, scores);
+  test.SetOutputAbsErr("Z", 1e-4f);
+
+  test.Run();
+}
+
+// Class 1 has no support vector, so the scores of the classifiers comparing it only come from the other class.
+TEST(MLOpTest, SVMClassifierClassWithoutSupportVectors) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<float> dual_coefficients = {1.f, -1.f,
+                                          1.f, 2.f};
+  std::vector<float> support_vectors = {1.f, 0.f,
+                                        0.f, 1.f};
+  std::vector<int64_t> classes = {0, 1, 2};
+  std::vector<int64_t> vectors_per_class = {1, 0, 1};
+  std::vector<float> rho = {0.f, 0.5f, -0.5f};
+  std::vector<float> kernel_params = {0.f, 0.f, 0.f};  // gamma, coef0, degree
+
+  std::vector<float> X = {2.f, 1.f,
+                          -1.f, 3.f};
+  std::vector<int64_t> predictions = {0, 1};
+  std::vector<float> scores = {2.f, 1.5f, 1.5f,
+                               -1.f, -3.5f, 5.5f};
+
+  test.AddAttribute("kernel_type", std::string("LINEAR"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {2, 2}, X);
+  test.AddOutput<int64_t>("Y", {2}, predictions);
+  test.AddOutput<float>("Z", {2, 3}, scores);
+
+  test.Run();
+}
+
+// The features are far from the origin and the inputs are close to the support vectors, the RBF kernels must not
+// lose the distances to the cancellation of the squared norms.
+TEST(MLOpTest, SVMClassifierRBFLargeMagnitudeFeatures) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<float> dual_coefficients = {1.f, -1.f,
+                                          1.f, 2.f};
+  std::vector<float> support_vectors = {1000.f, 2000.f,
+                                        1000.5f, 2000.f};
+  std::vector<int64_t> classes = {0, 1, 2};
+  std::vector<int64_t> vectors_per_class = {1, 0, 1};
+  std::vector<float> rho = {0.f, 0.5f, -0.5f};
+  std::vector<float> kernel_params = {1.f, 0.f, 3.f};  // gamma, coef0, degree
+
+  std::vector<float> X = {1000.25f, 2000.f,
+                          1000.5f, 2000.f,
+                          1000.f, 2001.f};
+  std::vector<int64_t> predictions = {0, 0, 0};
+  std::vector<float> scores = {0.939413063f, 0.5f, 1.37882613f,
+                               0.778800783f, 0.278800783f, 1.5f,
+                               0.367879441f, 0.581374644f, 0.0730095937f};
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {3, 2}, X);
+  test.AddOutput<int64_t>("Y", {3}, predictions);
+  test.AddOutput<float>("Z", {3, 3}, scores);
+
+  test.Run();
+}
+
 TEST(MLOpTest, SVMClassifierMulticlassLinearSVC) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
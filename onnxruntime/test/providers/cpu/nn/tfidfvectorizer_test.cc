@@ -689,6 +689,25 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5_2rows) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// Unigrams, bigrams and trigrams sharing prefixes, with tokens that are not in the pool.
+TEST(TfIdfVectorizerTest, Int32_TF_SharedPrefixes_UnknownTokens) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=0, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 0,
+               {0, 3, 9},
+               {0, 1, 2, 3, 4, 5, 6, 7},  // 8 output indexes
+               {},
+               {1, 2, 3,                // 1-grams
+                1, 2, 1, 3, 2, 3,       // bi-grams
+                1, 2, 3, 1, 3, 2},      // tri-grams
+               {});
+
+  test.AddInput<int32_t>("T", {10}, {1, 2, 3, 9, 1, 3, 2, 100, 1, 2});
+  test.AddOutput<float>("Y", {8}, {3, 3, 2, 2, 1, 1, 1, 1});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // This test runs the inference 100 times to test the improvement
 // It enables profiling while running inference multiple times.
 // So we can manually inspect the profiling output
@@ -288,6 +288,53 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManyBoxes_TwoBatches_ThreeClasses) {
+  // Pairs of identical boxes, so that half of the candidates are suppressed and the selection goes past the first
+  // max_output_boxes_per_class sorted candidates.
+  constexpr int64_t num_boxes = 300;
+  constexpr int64_t num_batches = 2;
+  constexpr int64_t num_classes = 3;
+  constexpr int64_t max_output_boxes_per_class = 120;
+
+  std::vector<float> boxes;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      const float x = static_cast<float>(box / 2) * 2.0f;
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+  }
+
+  // Class 0 prefers the low box indices, class 1 the high ones and class 2 only has ties.
+  std::vector<float> scores;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t box = 0; box < num_boxes; ++box) scores.push_back(1.0f - box * 0.001f);
+    for (int64_t box = 0; box < num_boxes; ++box) scores.push_back(box * 0.001f);
+    for (int64_t box = 0; box < num_boxes; ++box) scores.push_back(0.5f);
+  }
+
+  std::vector<int64_t> selected_indices;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t i = 0; i < max_output_boxes_per_class; ++i) {
+      selected_indices.insert(selected_indices.end(), {batch, 0, 2 * i});
+    }
+    for (int64_t i = 0; i < max_output_boxes_per_class; ++i) {
+      selected_indices.insert(selected_indices.end(), {batch, 1, num_boxes - 1 - 2 * i});
+    }
+    for (int64_t i = 0; i < max_output_boxes_per_class; ++i) {
+      selected_indices.insert(selected_indices.end(), {batch, 2, 2 * i});
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output_boxes_per_class});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * max_output_boxes_per_class, 3},
+                          selected_indices);
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
@@ -692,6 +692,45 @@ TEST(RoiAlignTest, MaxModePositive) {
   test.Run();
 }
 
+TEST(RoiAlignTest, AvgModeManyChannels) {
+  // More channels than a work item handles, and not a multiple of the channel block. Each channel is a constant
+  // plane, so the average over a ROI inside the feature map is that constant.
+  OpTester test("RoiAlign", 10);
+  test.AddAttribute<int64_t>("output_height", 3);
+  test.AddAttribute<int64_t>("output_width", 2);
+  test.AddAttribute<int64_t>("sampling_ratio", 2);
+  test.AddAttribute<float>("spatial_scale", 0.5f);
+
+  constexpr int64_t N = 2;
+  constexpr int64_t C = 75;
+  constexpr int64_t H = 6;
+  constexpr int64_t W = 7;
+  constexpr int64_t num_rois = 3;
+  constexpr int64_t pooled_size = 3 * 2;
+
+  std::vector<float> X;
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      X.insert(X.end(), H * W, static_cast<float>(n * C + c));
+    }
+  }
+
+  const std::vector<float> rois{1.f, 1.f, 9.f, 8.f, 0.f, 2.f, 12.f, 10.f, 4.f, 3.f, 6.f, 5.f};
+  const std::vector<int64_t> batch_indices{1, 0, 1};
+  std::vector<float> Y;
+  for (int64_t r = 0; r < num_rois; ++r) {
+    for (int64_t c = 0; c < C; ++c) {
+      Y.insert(Y.end(), pooled_size, static_cast<float>(batch_indices[r] * C + c));
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("rois", {num_rois, 4}, rois);
+  test.AddInput<int64_t>("batch_indices", {num_rois}, batch_indices);
+  test.AddOutput<float>("Y", {num_rois, C, 3, 2}, Y);
+  test.Run();
+}
+
 TEST(RoiAlignTest, AvgModeNegativeInvalidMode) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
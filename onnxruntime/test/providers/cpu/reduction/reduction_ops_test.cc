@@ -423,6 +423,49 @@ TEST(ReductionOpTest, ReduceL2) {
   test.Run();
 }
 
+TEST(ReductionOpTest, ReduceL2_RK_parallel) {
+  OpTester test("ReduceL2");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(2048 * 37);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 13) / 13.f - 0.5f;
+  test.AddInput<float>("data", {2048, 37}, in_data);
+  std::vector<float> expected(37);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    double sum = 0;
+    for (size_t j = 0; j < 2048; ++j) {
+      sum += in_data[i + j * expected.size()] * in_data[i + j * expected.size()];
+    }
+    expected[i] = static_cast<float>(std::sqrt(sum));
+  }
+  test.AddOutput<float>("reduced", {37}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceL2_KRK) {
+  OpTester test("ReduceL2");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(16 * 3 * 19);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 7) - 3.f;
+  test.AddInput<float>("data", {16, 3, 19}, in_data);
+  std::vector<float> expected(16 * 19);
+  for (size_t i = 0; i < 16; ++i) {
+    for (size_t k = 0; k < 19; ++k) {
+      float sum = 0;
+      for (size_t j = 0; j < 3; ++j) {
+        float v = in_data[(i * 3 + j) * 19 + k];
+        sum += v * v;
+      }
+      expected[i * 19 + k] = std::sqrt(sum);
+    }
+  }
+  test.AddOutput<float>("reduced", {16, 19}, expected);
+  test.Run();
+}
+
 #if defined(USE_DNNL)
 TEST(ReductionOpTest, ReduceL2_bfloat16) {
 #ifdef USE_DNNL
@@ -881,6 +924,29 @@ TEST(ReductionOpTest, ReduceLogSumExp_int64) {
   test.Run();
 }
 
+// The rows of the last axes are shifted by their maximum, which must not be raised to 0 for negative rows.
+TEST(ReductionOpTest, ReduceLogSumExp_last_axes_large_negative_double) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<double>("data", {2, 3},
+                        {-1000.0, -1001.0, -1002.0,
+                         -2000.5, -2000.0, -2002.0});
+  test.AddOutput<double>("reduced", {2}, {-999.59239404, -1999.44504308});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_last_axes_large_negative_int64) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<int64_t>("data", {2, 1, 3},
+                         {-1000, -1001, -1002,
+                          -5000, -4000, -4001});
+  test.AddOutput<int64_t>("reduced", {2, 1, 1}, {-1000, -4000});
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceLogSumExp0DTensor) {
   OpTester test("ReduceLogSumExp");
   test.AddInput<float>("data", {}, {2});
@@ -895,6 +961,61 @@ TEST(ReductionOpTest, ReduceLogSumExp0DTensor_double) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// Rows of 20 values, so that the vectorized fp32 path processes most of them, with a +inf, only -inf, a NaN and
+// a -inf among finite values. Infinite and NaN values must give the result of the direct formula.
+template <typename T>
+void RunReduceLogSumExpNonFiniteTest() {
+  constexpr int64_t row_size = 20;
+  const T inf = std::numeric_limits<T>::infinity();
+  std::vector<T> data;
+  std::vector<T> expected;
+  for (int row = 0; row < 4; ++row) {
+    double sum = 0;
+    for (int64_t i = 0; i < row_size; ++i) {
+      const T value = static_cast<T>(0.25 * (i % 7) - 1.0);
+      data.push_back(value);
+      sum += std::exp(static_cast<double>(value));
+    }
+    switch (row) {
+      case 0:
+        data[row * row_size + 13] = inf;
+        expected.push_back(inf);
+        break;
+      case 1:
+        std::fill_n(data.begin() + row * row_size, row_size, -inf);
+        expected.push_back(-inf);
+        break;
+      case 2:
+        data[row * row_size + 5] = std::numeric_limits<T>::quiet_NaN();
+        expected.push_back(std::numeric_limits<T>::quiet_NaN());
+        break;
+      default:
+        sum -= std::exp(static_cast<double>(data[row * row_size + 18]));
+        data[row * row_size + 18] = -inf;
+        expected.push_back(static_cast<T>(std::log(sum)));
+        break;
+    }
+  }
+
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", int64_t{0});
+  test.AddInput<T>("data", {4, row_size}, data);
+  test.AddOutput<T>("reduced", {4}, expected);
+  // Other EPs do not all handle infinite values.
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_NonFinite) {
+  RunReduceLogSumExpNonFiniteTest<float>();
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_NonFinite_double) {
+  RunReduceLogSumExpNonFiniteTest<double>();
+}
+
 TEST(ReductionOpTest, ReduceMax_default_axes_keepdims) {
   OpTester test("ReduceMax");
   test.AddAttribute("keepdims", (int64_t)1);
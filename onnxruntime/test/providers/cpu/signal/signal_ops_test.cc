@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -206,6 +207,58 @@ TEST(SignalOpsTest, DFT20_invertible_complex) {
   TestDFTInvertible(true, kOpsetVersion20);
 }
 
+// Compares the mixed-radix, Bluestein and real input paths with a naive DFT.
+static void TestDFTAgainstNaive(bool complex, bool onesided, bool inverse) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  for (int64_t length : {6, 12, 15, 49, 97, 400, 1000}) {
+    OpTester test("DFT", kOpsetVersion20);
+    constexpr int64_t num_batches = 3;
+    const int64_t components = complex ? 2 : 1;
+    vector<int64_t> input_shape{num_batches, length, components};
+    vector<float> input = random.Uniform<float>(input_shape, -1.f, 1.f);
+
+    const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+    vector<float> expected_output(num_batches * output_length * 2);
+    const double sign = inverse ? 1.0 : -1.0;
+    const double scale = inverse ? 1.0 / length : 1.0;
+    for (int64_t b = 0; b < num_batches; b++) {
+      for (int64_t k = 0; k < output_length; k++) {
+        double real = 0, imag = 0;
+        for (int64_t n = 0; n < length; n++) {
+          const double angle = sign * 2.0 * M_PI * static_cast<double>((n * k) % length) / length;
+          const double x_real = input[(b * length + n) * components];
+          const double x_imag = complex ? input[(b * length + n) * components + 1] : 0.0;
+          real += x_real * std::cos(angle) - x_imag * std::sin(angle);
+          imag += x_real * std::sin(angle) + x_imag * std::cos(angle);
+        }
+        expected_output[(b * output_length + k) * 2] = static_cast<float>(real * scale);
+        expected_output[(b * output_length + k) * 2 + 1] = static_cast<float>(imag * scale);
+      }
+    }
+
+    test.AddInput<float>("input", input_shape, input);
+    test.AddInput<int64_t>("dft_length", {}, {length});
+    test.AddInput<int64_t>("axis", {}, {1});
+    test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+    test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+    test.AddOutput<float>("output", {num_batches, output_length, 2}, expected_output);
+    test.SetOutputAbsErr("output", 0.002f);
+    test.Run();
+  }
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_real_onesided) {
+  TestDFTAgainstNaive(false, true, false);
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_real) {
+  TestDFTAgainstNaive(false, false, false);
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_complex_inverse) {
+  TestDFTAgainstNaive(true, false, true);
+}
+
 TEST(SignalOpsTest, STFTFloat) {
   OpTester test("STFT", kMinOpsetVersion);
 
@@ -233,6 +286,67 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// Compares STFT of real or complex signals, with or without a window, with a naive DFT of each frame.
+static void TestSTFTAgainstNaive(bool complex, bool with_window, bool onesided) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  OpTester test("STFT", kMinOpsetVersion);
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t signal_length = 70;
+  constexpr int64_t frame_step = 7;
+  constexpr int64_t frame_length = 12;
+  constexpr int64_t n_dfts = (signal_length - frame_length) / frame_step + 1;
+  const int64_t components = complex ? 2 : 1;
+  vector<int64_t> signal_shape{batch_size, signal_length, components};
+  vector<float> signal = random.Uniform<float>(signal_shape, -1.f, 1.f);
+  vector<float> window = with_window ? random.Uniform<float>({frame_length}, 0.f, 1.f)
+                                     : vector<float>(frame_length, 1.f);
+
+  const int64_t output_length = onesided ? (frame_length >> 1) + 1 : frame_length;
+  vector<float> expected_output(batch_size * n_dfts * output_length * 2);
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t f = 0; f < n_dfts; f++) {
+      for (int64_t k = 0; k < output_length; k++) {
+        double real = 0, imag = 0;
+        for (int64_t n = 0; n < frame_length; n++) {
+          const double angle = -2.0 * M_PI * static_cast<double>((n * k) % frame_length) / frame_length;
+          const int64_t offset = (b * signal_length + f * frame_step + n) * components;
+          const double x_real = signal[offset] * window[n];
+          const double x_imag = complex ? signal[offset + 1] * window[n] : 0.0;
+          real += x_real * std::cos(angle) - x_imag * std::sin(angle);
+          imag += x_real * std::sin(angle) + x_imag * std::cos(angle);
+        }
+        expected_output[((b * n_dfts + f) * output_length + k) * 2] = static_cast<float>(real);
+        expected_output[((b * n_dfts + f) * output_length + k) * 2 + 1] = static_cast<float>(imag);
+      }
+    }
+  }
+
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddInput<float>("signal", signal_shape, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  if (with_window) {
+    test.AddInput<float>("window", {frame_length}, window);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {batch_size, n_dfts, output_length, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.0001f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, STFTFloat_complex) {
+  TestSTFTAgainstNaive(true, false, false);
+}
+
+TEST(SignalOpsTest, STFTFloat_complex_window) {
+  TestSTFTAgainstNaive(true, true, false);
+}
+
+TEST(SignalOpsTest, STFTFloat_window_onesided) {
+  TestSTFTAgainstNaive(false, true, true);
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -1462,6 +1464,70 @@ TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel) {
   test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
   test.Run();
 }
+
+TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_ManyRowsAndChannels) {
+  // Enough output rows and planes to be split in several blocks. The expected output is computed directly from the
+  // 4x4 grid of each output pixel, with the asymmetric coordinate transformation.
+  OpTester test("Resize", 13);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 1.0f, 2.5f, 1.5f};
+
+  test.AddAttribute("mode", "cubic");
+  test.AddAttribute("coordinate_transformation_mode", "asymmetric");
+  test.AddAttribute("exclude_outside", static_cast<int64_t>(1));
+
+  constexpr int64_t N = 2, C = 3, H = 14, W = 10;
+  constexpr int64_t OH = 35, OW = 15;
+  constexpr float a = -0.75f;
+  std::vector<float> X(N * C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 37) % 101) / 10.0f;
+  }
+
+  auto cubic_weights = [](float s, int64_t start, int64_t size, float weights[4]) {
+    const float d[4] = {s + 1, s, 1 - s, 2 - s};
+    float sum = 0;
+    for (int k = 0; k < 4; ++k) {
+      const float t = d[k];
+      weights[k] = t <= 1 ? ((a + 2) * t - (a + 3)) * t * t + 1 : ((a * t - 5 * a) * t + 8 * a) * t - 4 * a;
+      if (start + k < 0 || start + k >= size) weights[k] = 0;
+      sum += weights[k];
+    }
+    for (int k = 0; k < 4; ++k) weights[k] /= sum;
+  };
+
+  std::vector<float> Y;
+  for (int64_t plane = 0; plane < N * C; ++plane) {
+    for (int64_t y = 0; y < OH; ++y) {
+      const float in_y = y / scales[2];
+      const auto y0 = static_cast<int64_t>(std::floor(in_y)) - 1;
+      float wy[4];
+      cubic_weights(in_y - std::floor(in_y), y0, H, wy);
+      for (int64_t x = 0; x < OW; ++x) {
+        const float in_x = x / scales[3];
+        const auto x0 = static_cast<int64_t>(std::floor(in_x)) - 1;
+        float wx[4];
+        cubic_weights(in_x - std::floor(in_x), x0, W, wx);
+        float result = 0;
+        for (int64_t i = 0; i < 4; ++i) {
+          const int64_t row = std::clamp<int64_t>(y0 + i, 0, H - 1);
+          for (int64_t j = 0; j < 4; ++j) {
+            const int64_t col = std::clamp<int64_t>(x0 + j, 0, W - 1);
+            result += wy[i] * wx[j] * X[(plane * H + row) * W + col];
+          }
+        }
+        Y.push_back(result);
+      }
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+  test.AddOutput<float>("Y", {N, C, OH, OW}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
 TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_tf_half_pixel_for_nn) {
   // tf_half_pixel_for_nn has been deprecated since opset 13
   OpTester test("Resize", 12);
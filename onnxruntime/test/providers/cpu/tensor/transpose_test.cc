@@ -684,6 +684,51 @@ TEST(TransposeOpTest, NDim) {
   TransposeTest(input_shape, input_vals, &perm, input_shape, expected_vals2);
 }
 
+// Larger shapes so the transpose spans several tiles, with partial tiles on both edges of the plane.
+template <typename T>
+static void BlockedTransposeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  const size_t size = static_cast<size_t>(TensorShape(input_shape).Size());
+
+  std::vector<T> input_vals(size);
+  for (size_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 127);
+  }
+
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[static_cast<size_t>(perm[i])];
+  }
+
+  std::vector<T> expected_vals(size);
+  for (size_t i = 0; i < size; ++i) {
+    int64_t index = static_cast<int64_t>(i);
+    int64_t offset = 0;
+    for (size_t axis = rank; axis-- > 0;) {
+      offset += (index % expected_shape[axis]) * input_strides[static_cast<size_t>(perm[axis])];
+      index /= expected_shape[axis];
+    }
+    expected_vals[i] = input_vals[static_cast<size_t>(offset)];
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals,
+                {kTensorrtExecutionProvider, kOpenVINOExecutionProvider, kQnnExecutionProvider}, {13});
+}
+
+TEST(TransposeOpTest, BlockedNDim) {
+  BlockedTransposeTest<int8_t>({3, 130, 70}, {2, 1, 0});
+  BlockedTransposeTest<int16_t>({2, 67, 5, 71}, {0, 3, 2, 1});
+  BlockedTransposeTest<float>({2, 3, 37, 5, 67}, {4, 2, 0, 3, 1});
+  BlockedTransposeTest<float>({1, 96, 3, 200}, {0, 3, 2, 1});
+  BlockedTransposeTest<double>({4, 33, 1, 70}, {3, 2, 0, 1});
+  BlockedTransposeTest<int64_t>({5, 9, 7, 3}, {2, 0, 3, 1});
+}
+
 TEST(TransposeOpTest, DoTransposeImpl) {
   std::vector<int64_t> input_shape({5, 2, 1, 3});
   std::vector<float> input_vals(30);
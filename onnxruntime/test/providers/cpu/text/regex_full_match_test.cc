@@ -115,5 +115,22 @@ TEST(RegexFullMatch, NonUtf8Pattern) {
                        });
   test.Run(BaseTester::ExpectResult::kExpectFailure, "Invalid regex pattern");
 }
+
+TEST(RegexFullMatch, LargeBatch) {
+  // Enough strings to be matched in several chunks on the thread pool.
+  constexpr int64_t num_strings = 10000;
+  std::vector<std::string> input;
+  // std::vector<bool> has no data() to pass to AddOutput.
+  auto output = std::make_unique<bool[]>(num_strings);
+  for (int64_t i = 0; i < num_strings; ++i) {
+    input.push_back(i % 3 == 0 ? "ERROR " + std::to_string(i) + ": disk full" : "INFO " + std::to_string(i));
+    output[i] = i % 3 == 0;
+  }
+  OpTester test("RegexFullMatch", 20, kOnnxDomain);
+  test.AddAttribute("pattern", std::string(R"(ERROR \d+: .*)"));
+  test.AddInput<std::string>("Input", {num_strings}, input);
+  test.AddOutput<bool>("Output", {num_strings}, output.get(), num_strings);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -211,6 +211,57 @@ TEST(ContribOpTest, StringNormalizerSensitiveFilterOutUpperEmptyCase) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, StringNormalizerInsensitiveFilterOutUpperLargeBatch) {
+  // - case-INSENSITIVE approach with enough strings to be processed in several chunks
+  // - filter out monday in any case
+  // - the remaining strings are output in upper case and in their input order
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "UPPER", false, {"monday"}, test_locale);
+  constexpr int64_t groups = 2500;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < groups; ++i) {
+    const std::string suffix = std::to_string(i);
+    input.push_back("Monday");
+    input.push_back("word" + suffix);
+    input.push_back("mONDAY");
+    input.push_back("Tuesday" + suffix);
+    output.push_back("WORD" + suffix);
+    output.push_back("TUESDAY" + suffix);
+  }
+  test.AddInput<std::string>("T", {4 * groups}, input);
+  test.AddOutput<std::string>("Y", {2 * groups}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, StringNormalizerInvalidUtf8InLargeBatch) {
+  // Invalid UTF-8 strings in a large batch fail the run, whether they are found while filtering
+  // the stop words or while changing the case of the output, and also when the strings are
+  // filtered case-sensitively and output without a case change.
+  // The error is the one of the first invalid string: "ab\xff" converts 2 of its 3 bytes.
+#ifdef _MSC_VER
+  const std::string expected_error("MultiByteToWideChar failed");
+#else
+  const std::string expected_error("Converted only first: 2 bytes out of: 3");
+#endif
+  constexpr int64_t count = 10000;
+  std::vector<std::string> input;
+  for (int64_t i = 0; i < count; ++i) {
+    input.push_back(i % 2 == 0 ? "monday" : "word" + std::to_string(i));
+  }
+  input[4001] = "ab\xff";
+  input[9001] = "\xff\xfe";
+
+  const std::vector<std::pair<std::string, bool>> configs{{"LOWER", false}, {"LOWER", true}, {"NONE", true}};
+  for (const auto& [case_change_action, is_case_sensitive] : configs) {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, case_change_action, is_case_sensitive, {"monday"}, test_locale);
+    test.AddInput<std::string>("T", {count}, input);
+    test.AddOutput<std::string>("Y", {count / 2}, std::vector<std::string>(count / 2));
+    test.Run(OpTester::ExpectResult::kExpectFailure, expected_error);
+  }
+}
+
 // Fails on iOS because necessary locales are not installed
 // MacOS runs fine.
 #ifndef ORT_IOS
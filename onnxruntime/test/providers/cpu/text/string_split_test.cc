@@ -122,5 +122,31 @@ TEST(StringSplit, NoInputTest) {
   test.Run();
 }
 
+TEST(StringSplit, LargeBatchTest) {
+  // Enough strings to be split in several chunks on the thread pool.
+  constexpr int64_t num_strings = 10000;
+  std::vector<std::string> input;
+  std::vector<std::string> splits;
+  std::vector<int64_t> counts;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    const std::string id = std::to_string(i);
+    if (i % 2 == 0) {
+      input.push_back(id + ",a,b");
+      splits.insert(splits.end(), {id, "a", "b"});
+      counts.push_back(3);
+    } else {
+      input.push_back(id);
+      splits.insert(splits.end(), {id, "", ""});
+      counts.push_back(1);
+    }
+  }
+  OpTester test("StringSplit", 20);
+  test.AddInput<std::string>("X", {num_strings}, input);
+  test.AddAttribute<std::string>("delimiter", ",");
+  test.AddOutput<std::string>("Y", {num_strings, 3}, splits);
+  test.AddOutput<int64_t>("Z", {num_strings}, counts);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
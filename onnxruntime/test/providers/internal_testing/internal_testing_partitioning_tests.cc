@@ -7,6 +7,7 @@
 #include "core/framework/compute_capability.h"
 #include "core/framework/utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "test/framework/test_utils.h"
 #include "test/test_environment.h"
@@ -18,6 +19,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <cstdio>
+#include <fstream>
 #include <queue>
 
 using namespace ONNX_NAMESPACE;
@@ -129,6 +132,61 @@ TEST(InternalTestingEP, TestDependenciesCorrectlyHandled) {
   ASSERT_EQ(num_other_nodes, 2);
 }
 
+// Returns the number of nodes assigned to the internal testing EP, which supports Add, when partitioning with the
+// given cost model.
+static int CountNodesAssignedWithCostModel(const std::string& cost_model) {
+  const std::string cost_model_path = "internal_testing_ep_partitioning_cost_model.txt";
+  {
+    std::ofstream file{cost_model_path};
+    file << cost_model;
+  }
+
+  SessionOptions so;
+  EXPECT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsPartitioningCostModelFile,
+                                                    cost_model_path.c_str()));
+  auto session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+
+  const std::unordered_set<std::string> supported_ops{"Add"};
+  EXPECT_STATUS_OK(session->RegisterExecutionProvider(
+      std::make_unique<InternalTestingExecutionProvider>(supported_ops)));
+
+  EXPECT_STATUS_OK(session->Load(ORT_MODEL_FOLDER "ep_partitioning_test_1.onnx"));
+  EXPECT_STATUS_OK(session->Initialize());
+  std::remove(cost_model_path.c_str());
+
+  int num_ep_nodes = 0;
+  for (const auto& node : session->GetGraph().Nodes()) {
+    if (node.GetExecutionProviderType() == utils::kInternalTestingExecutionProvider) {
+      ++num_ep_nodes;
+    }
+  }
+  return num_ep_nodes;
+}
+
+// Test that the partitioning cost model leaves nodes on the CPU EP when the EP is estimated to be slower,
+// including the copies to and from it.
+TEST(InternalTestingEP, TestPartitioningCostModel) {
+  // the EP kernel is slower
+  EXPECT_EQ(CountNodesAssignedWithCostModel("InternalTestingExecutionProvider Add 100\n"
+                                            "CPUExecutionProvider Add 1\n"),
+            0);
+
+  // the EP kernel is faster, but not by enough to pay for the copies
+  EXPECT_EQ(CountNodesAssignedWithCostModel("# copies are expensive\n"
+                                            "InternalTestingExecutionProvider Add 1\n"
+                                            "CPUExecutionProvider Add 2\n"
+                                            "InternalTestingExecutionProvider copy 50 0\n"),
+            0);
+
+  // the EP kernel is faster
+  EXPECT_GT(CountNodesAssignedWithCostModel("InternalTestingExecutionProvider Add 1\n"
+                                            "CPUExecutionProvider Add 100\n"),
+            0);
+
+  // without costs for the CPU EP the nodes are assigned as usual
+  EXPECT_GT(CountNodesAssignedWithCostModel("InternalTestingExecutionProvider Add 100\n"), 0);
+}
+
 // Infrastructure that was used to check NNAPI coverage.
 // Ideally this could be updated to read the model paths, supported ops and stop ops from input files
 // and provide info on the partitions so no code changes are required to investigate different scenarios.